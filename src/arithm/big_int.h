@@ -43,6 +43,7 @@ extern "C"
 	long zwriteln(verylong a);
 	long zread(verylong *a);
 	void zabs(verylong *a);
+	long ztoint(verylong a);
 }
 
 
@@ -503,6 +504,16 @@ class BigInt
 		zabs(&res.int);
 		return res;
 	}
+
+	/**
+	 * Converts the number to long.
+	 *
+	 * @pre The number fits into long.
+	 */
+	public: long toLong() const
+	{
+		return ztoint(this->int);
+	}
 }
 
 bool operator==(long a, BigInt const &b)
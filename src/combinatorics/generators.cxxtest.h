@@ -1,7 +1,14 @@
 
 #include <eugenejonas/cpp_stuff/combinatorics/generators.h>
+#include <eugenejonas/cpp_stuff/combinatorics/permutation.h>
+#include <eugenejonas/cpp_stuff/consumers.h>
+#include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
+#include <algorithm>
 #include <set>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <cxxtest/TestSuite.h>
@@ -58,4 +65,173 @@ class UnitTest_PermutationGenerator: public CxxTest::TestSuite
 }
 
 
+/**
+ * Helper that checks a transposition-based permutation iterator: it must visit
+ * all n! permutations once, and consecutive permutations must differ exactly
+ * by the reported transposition.
+ */
+template <typename TPL_TranspositionIteratorTestUtils_Iterator> class TranspositionIteratorTestUtils
+{
+	public: static void check(int n, int expectedCount, bool isAdjacent)
+	{
+		TPL_TranspositionIteratorTestUtils_Iterator it(n);
+		set <vector <int> > visited;
+		vector <int> previous = it.getElements();
+		int count = 1;
+		
+		visited.insert(previous);
+		
+		while (it.next())
+		{
+			int i = it.getFirstSwappedIndex(), j = it.getSecondSwappedIndex();
+			
+			TS_ASSERT(0 <= i && i < j && j < n);
+			
+			if (isAdjacent)
+			{
+				TS_ASSERT_EQUALS(i + 1, j);
+			}
+			
+			std::swap(previous[i], previous[j]);
+			TS_ASSERT_EQUALS(previous, it.getElements());
+			
+			visited.insert(previous);
+			count++;
+		}
+		
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT_EQUALS(expectedCount, (int) visited.size());
+	}
+}
+
+class UnitTest_HeapPermutationIterator: public CxxTest::TestSuite
+{
+	public: void test_corner_cases()
+	{
+		TranspositionIteratorTestUtils <HeapPermutationIterator> ::check(0, 1, false);
+		TranspositionIteratorTestUtils <HeapPermutationIterator> ::check(1, 1, false);
+	}
+	
+	public: void test_visits_all_permutations()
+	{
+		TranspositionIteratorTestUtils <HeapPermutationIterator> ::check(2, 2, false);
+		TranspositionIteratorTestUtils <HeapPermutationIterator> ::check(3, 6, false);
+		TranspositionIteratorTestUtils <HeapPermutationIterator> ::check(6, 720, false);
+	}
+}
+
+class UnitTest_SteinhausJohnsonTrotterIterator: public CxxTest::TestSuite
+{
+	public: void test_corner_cases()
+	{
+		TranspositionIteratorTestUtils <SteinhausJohnsonTrotterIterator> ::check(0, 1, true);
+		TranspositionIteratorTestUtils <SteinhausJohnsonTrotterIterator> ::check(1, 1, true);
+	}
+	
+	public: void test_visits_all_permutations()
+	{
+		TranspositionIteratorTestUtils <SteinhausJohnsonTrotterIterator> ::check(2, 2, true);
+		TranspositionIteratorTestUtils <SteinhausJohnsonTrotterIterator> ::check(4, 24, true);
+		TranspositionIteratorTestUtils <SteinhausJohnsonTrotterIterator> ::check(7, 5040, true);
+	}
+	
+	public: void test_order()
+	{
+		int arr[][3] = {{1, 2, 3}, {1, 3, 2}, {3, 1, 2}, {3, 2, 1}, {2, 3, 1}, {2, 1, 3}};
+		SteinhausJohnsonTrotterIterator it(3);
+		
+		for (int i = 0; i < 6; i++)
+		{
+			TS_ASSERT_EQUALS(vector <int> (arr[i], arr[i] + 3), it.getElements());
+			TS_ASSERT_EQUALS(i < 5, it.next());
+		}
+	}
+}
+
+
+class UnitTest_ParallelPermutationGenerator: public CxxTest::TestSuite
+{
+	public: typedef Permutation <int, StrictTotalIntegerOrdering> permutation_type;
+	
+	
+	/**
+	 * Permutations must be collected in lexicographical order, regardless of the number of ranges.
+	 */
+	public: void test_with_collector()
+	{
+		ThreadPool pool(4);
+		
+		for (int rangeCount = 1; rangeCount <= 50; rangeCount += 7)
+		{
+			Collector <permutation_type> collector;
+			ParallelPermutationGenerator <Collector <permutation_type> > (&collector, 5, pool, rangeCount);
+			
+			vector <permutation_type> const &elements = collector.getElements();
+			permutation_type expected(5);
+			
+			TS_ASSERT_EQUALS(120u, elements.size());
+			
+			for (std::size_t i = 0; i < elements.size(); i++)
+			{
+				TS_ASSERT_EQUALS(expected, elements[i]);
+				expected.next();
+			}
+		}
+	}
+	
+	public: void test_with_counter()
+	{
+		ThreadPool pool(4);
+		Counter <permutation_type> counter;
+		
+		ParallelPermutationGenerator <Counter <permutation_type> > (&counter, 9, pool, 64);
+		TS_ASSERT_EQUALS(362880LL, counter.getCount());
+		
+		ParallelPermutationGenerator <Counter <permutation_type> > (&counter, 0, pool, 3);
+		TS_ASSERT_EQUALS(1LL, counter.getCount());
+	}
+}
+
+class UnitTest_ParallelSetPartitionGenerator: public CxxTest::TestSuite
+{
+	public: static vector <std::string> toStrings(vector <SetPartitionGenerator::SetPartition> const &partitions)
+	{
+		vector <std::string> res;
+		
+		for (std::size_t i = 0; i < partitions.size(); i++)
+		{
+			std::ostringstream os;
+			os << partitions[i];
+			res.push_back(os.str());
+		}
+		
+		return res;
+	}
+	
+	/**
+	 * Partitions must be collected in the same order as SetPartitionGenerator generates them.
+	 */
+	public: void test_with_collector()
+	{
+		ThreadPool pool(4);
+		Collector <SetPartitionGenerator::SetPartition> expected, actual;
+		
+		SetPartitionGenerator(&expected, 6);
+		ParallelSetPartitionGenerator <Collector <SetPartitionGenerator::SetPartition> > (&actual, 6, pool, 10);
+		
+		TS_ASSERT_EQUALS(203u, actual.getElements().size());
+		TS_ASSERT_EQUALS(toStrings(expected.getElements()), toStrings(actual.getElements()));
+	}
+	
+	public: void test_with_counter()
+	{
+		ThreadPool pool(4);
+		Counter <SetPartitionGenerator::SetPartition> counter;
+		
+		ParallelSetPartitionGenerator <Counter <SetPartitionGenerator::SetPartition> > (&counter, 10, pool, 16);
+		TS_ASSERT_EQUALS(115975LL, counter.getCount());
+	}
+}
+
+
 }
@@ -4,9 +4,13 @@
 
 
 #include <eugenejonas/cpp_stuff/combinatorics/permutation.h>
+#include <eugenejonas/cpp_stuff/combinatorics/ranking.h>
 #include <eugenejonas/cpp_stuff/consumers.h>
+#include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
 #include <algorithm>
+#include <cassert>
 #include <ostream>
 #include <vector>
 
@@ -15,6 +19,9 @@ namespace eugenejonas::cpp_stuff
 {
 
 
+template <typename TPL_ParallelSetPartitionGenerator_Consumer> class ParallelSetPartitionGenerator;
+
+
 /**
  * Generates all partitions of set [n], where n is non-negative integer.
  */
@@ -26,6 +33,7 @@ class SetPartitionGenerator
 	public: class SetPartition: private std::vector <int>
 	{
 		private: friend class SetPartitionGenerator;
+		private: template <typename TPL_ParallelSetPartitionGenerator_Consumer> friend class ParallelSetPartitionGenerator;
 		private: friend std::ostream &operator<<(std::ostream &os, SetPartitionGenerator::SetPartition const &setPartition);
 
 
@@ -188,6 +196,457 @@ class PermutationGenerator
 }
 
 
+/**
+ * Iterates through all n-permutations of elements 1..n using Heap's algorithm.
+ * Every permutation differs from the previous one by a single transposition
+ * (not necessarily of adjacent elements), so consumers can update their state
+ * incrementally instead of rescanning the whole permutation.
+ * 
+ * Example:
+
+	HeapPermutationIterator it(n);
+	
+	// it.getElements() is the identity permutation [1 2 ... n]
+	
+	while (it.next())
+	{
+		// elements at indexes it.getFirstSwappedIndex() and
+		// it.getSecondSwappedIndex() have just been swapped
+	}
+
+ * 
+ * Iterative version of the algorithm runs in constant amortized time per permutation.
+ */
+class HeapPermutationIterator
+{
+	/**
+	 * Current permutation in standard representation.
+	 */
+	private: std::vector <int> elements;
+
+	/**
+	 * Loop counters of the recursive formulation of the algorithm.
+	 */
+	private: std::vector <int> counters;
+
+	/**
+	 * Level of the recursive formulation at which the next swap happens.
+	 */
+	private: int level;
+
+	/**
+	 * Indexes swapped by the last call to next().
+	 */
+	private: int firstSwappedIndex, secondSwappedIndex;
+
+
+	/**
+	 * @param n Length of permutations, n >= 0.
+	 */
+	public: HeapPermutationIterator(int n):
+			elements(n),
+			counters(n),
+			level(1),
+			firstSwappedIndex(0),
+			secondSwappedIndex(0)
+	{
+		assert(n >= 0);
+		
+		for (int i = 0; i < n; i++)
+		{
+			this->elements[i] = i + 1;
+		}
+	}
+
+	/**
+	 * Moves to the next permutation.
+	 * 
+	 * @return false if all permutations have already been visited, true otherwise.
+	 * @time O(1) amortized
+	 */
+	public: bool next()
+	{
+		const int n = (int) this->elements.size();
+		
+		while (this->level < n)
+		{
+			int &counter = this->counters[this->level];
+			
+			if (counter < this->level)
+			{
+				this->firstSwappedIndex = (this->level % 2 == 0) ? 0 : counter;
+				this->secondSwappedIndex = this->level;
+				std::swap(this->elements[this->firstSwappedIndex], this->elements[this->secondSwappedIndex]);
+				
+				counter++;
+				this->level = 1;
+				return true;
+			}
+			
+			counter = 0;
+			this->level++;
+		}
+		
+		return false;
+	}
+
+	/**
+	 * Returns the smaller of the two indexes swapped by the last call to next().
+	 */
+	public: int getFirstSwappedIndex() const
+	{
+		return this->firstSwappedIndex;
+	}
+
+	/**
+	 * Returns the greater of the two indexes swapped by the last call to next().
+	 */
+	public: int getSecondSwappedIndex() const
+	{
+		return this->secondSwappedIndex;
+	}
+
+	/**
+	 * Returns standard representation of the current permutation.
+	 */
+	public: std::vector <int> const &getElements() const
+	{
+		return this->elements;
+	}
+}
+
+/**
+ * Iterates through all n-permutations of elements 1..n in the order of the
+ * Steinhaus-Johnson-Trotter algorithm: every permutation differs from the
+ * previous one by a transposition of two adjacent elements.
+ * 
+ * This is the loopless version of the algorithm (Ehrlich), which uses focus
+ * pointers over the reflected mixed-radix Gray code of inversion counts
+ * (element k moves through k positions). Every call to next() takes O(1)
+ * time in the worst case, not only amortized.
+ * 
+ * Usage is the same as of HeapPermutationIterator.
+ */
+class SteinhausJohnsonTrotterIterator
+{
+	/**
+	 * Current permutation in standard representation.
+	 */
+	private: std::vector <int> elements;
+
+	/**
+	 * positions[k] is the index of element k in the current permutation.
+	 */
+	private: std::vector <int> positions;
+
+	/*
+	 * Mixed-radix Gray code. Digit d corresponds to element <n - d>
+	 * and has radix <n - d>, so digit 0 (the largest element) changes most often.
+	 * 
+	 * digits[d] is the number of steps the element has made in the current sweep,
+	 * directions[d] is +1 if the element currently moves to the left, -1 otherwise,
+	 * focus[d] is the focus pointer of Knuth's algorithm 7.2.1.1H.
+	 */
+	private: std::vector <int> digits, directions, focus;
+
+	/**
+	 * Index of the left element of the last swapped pair.
+	 */
+	private: int swappedIndex;
+
+
+	/**
+	 * @param n Length of permutations, n >= 0.
+	 */
+	public: SteinhausJohnsonTrotterIterator(int n):
+			elements(n),
+			positions(n + 1),
+			digits(std::max(n - 1, 0), 0),
+			directions(std::max(n - 1, 0), 1),
+			focus(std::max(n, 1)),
+			swappedIndex(0)
+	{
+		assert(n >= 0);
+		
+		for (int i = 0; i < n; i++)
+		{
+			this->elements[i] = i + 1;
+			this->positions[i + 1] = i;
+		}
+		
+		for (int d = 0; d < (int) this->focus.size(); d++)
+		{
+			this->focus[d] = d;
+		}
+	}
+
+	/**
+	 * Moves to the next permutation.
+	 * 
+	 * @return false if all permutations have already been visited, true otherwise.
+	 * @time O(1)
+	 */
+	public: bool next()
+	{
+		const int digitCount = (int) this->digits.size();
+		const int d = this->focus[0];
+		
+		this->focus[0] = 0;
+		
+		if (d == digitCount)
+		{
+			return false;
+		}
+		
+		this->digits[d] += this->directions[d];
+		
+		// element <n - d> moves one step and swaps with a smaller neighbour
+		
+		const int element = digitCount + 1 - d;
+		const int from = this->positions[element];
+		const int to = from - this->directions[d];
+		const int neighbour = this->elements[to];
+		
+		this->elements[to] = element;
+		this->elements[from] = neighbour;
+		this->positions[element] = to;
+		this->positions[neighbour] = from;
+		this->swappedIndex = std::min(from, to);
+		
+		if (this->digits[d] == 0 || this->digits[d] == element - 1)
+		{
+			this->directions[d] = -this->directions[d];
+			this->focus[d] = this->focus[d + 1];
+			this->focus[d + 1] = d + 1;
+		}
+		
+		return true;
+	}
+
+	/**
+	 * Returns the smaller of the two indexes swapped by the last call to next().
+	 * The other index is getFirstSwappedIndex() + 1.
+	 */
+	public: int getFirstSwappedIndex() const
+	{
+		return this->swappedIndex;
+	}
+
+	/**
+	 * Returns the greater of the two indexes swapped by the last call to next().
+	 */
+	public: int getSecondSwappedIndex() const
+	{
+		return this->swappedIndex + 1;
+	}
+
+	/**
+	 * Returns standard representation of the current permutation.
+	 */
+	public: std::vector <int> const &getElements() const
+	{
+		return this->elements;
+	}
+}
+
+
+/**
+ * Splits range of indexes [0; total) into rangeCount disjoint consecutive
+ * ranges of (almost) equal length and returns the first index of range i.
+ */
+inline unsigned long long getRangeStart(unsigned long long total, int rangeCount, int i)
+{
+	assert(rangeCount > 0 && i >= 0 && i <= rangeCount);
+	
+	// total * i could overflow
+	return (total / rangeCount) * i + std::min <unsigned long long> (i, total % rangeCount);
+}
+
+/**
+ * Generates all n-permutations of elements 1..n in parallel.
+ * 
+ * The sequence of permutations in lexicographical order is cut into rangeCount
+ * disjoint ranges of indexes. Each range is enumerated by a separate task of the
+ * thread pool, which unranks the first permutation of the range and then calls
+ * Permutation::next(). Every task feeds its own consumer; after all tasks are
+ * finished, partial consumers are merged into the main consumer in the order of
+ * ranges, so the main consumer observes the permutations in lexicographical order.
+ * 
+ * @param TPL_ParallelPermutationGenerator_Consumer Type of the consumer. It must be
+ *		default-constructible and provide method merge(consumer) (see Counter and Collector).
+ */
+template <typename TPL_ParallelPermutationGenerator_Consumer> class ParallelPermutationGenerator
+{
+	public: typedef Permutation <int, StrictTotalIntegerOrdering> permutation_type;
+	
+	
+	private: TPL_ParallelPermutationGenerator_Consumer *consumer;
+
+
+	/**
+	 * Constructor that does the work.
+	 * 
+	 * @param n Length of permutations, 20 >= n >= 0.
+	 * @param rangeCount Number of ranges, rangeCount > 0. To balance the load,
+	 *		it should be several times greater than the number of threads.
+	 */
+	public: ParallelPermutationGenerator(TPL_ParallelPermutationGenerator_Consumer *consumer, int n, ThreadPool &pool, int rangeCount)
+	{
+		assert(n >= 0 && rangeCount > 0);
+		
+		const unsigned long long total = LehmerCode::getPermutationCount(n);
+		std::vector <TPL_ParallelPermutationGenerator_Consumer> partialConsumers(rangeCount);
+		TaskGroup group(pool);
+		
+		for (int i = 0; i < rangeCount; i++)
+		{
+			const unsigned long long first = getRangeStart(total, rangeCount, i);
+			const unsigned long long last = getRangeStart(total, rangeCount, i + 1);
+			TPL_ParallelPermutationGenerator_Consumer *partialConsumer = &partialConsumers[i];
+			
+			group.run([n, first, last, partialConsumer]()
+			{
+				ParallelPermutationGenerator::generate(partialConsumer, n, first, last);
+			});
+		}
+		
+		group.wait();
+		
+		this->consumer = consumer;
+		this->consumer->start();
+		
+		for (int i = 0; i < rangeCount; i++)
+		{
+			this->consumer->merge(partialConsumers[i]);
+		}
+	}
+
+	/**
+	 * Destructor that sends "finish" message to the consumer.
+	 */
+	public: ~ParallelPermutationGenerator()
+	{
+		this->consumer->finish();
+	}
+
+	/**
+	 * Feeds permutations with lexicographical indexes [first; last) to the consumer.
+	 */
+	private: static void generate(TPL_ParallelPermutationGenerator_Consumer *consumer, int n, unsigned long long first, unsigned long long last)
+	{
+		consumer->start();
+		
+		if (first < last)
+		{
+			StrictTotalIntegerOrdering stoCompare;
+			std::vector <int> elements(n);
+			LehmerCode::unrank(n, first, elements.data());
+			
+			for (int i = 0; i < n; i++)
+			{
+				elements[i] = stoCompare.getElementByOrdinalNumber(elements[i]);
+			}
+			
+			permutation_type permutation(elements, stoCompare);
+			
+			for (unsigned long long index = first; index < last; index++)
+			{
+				consumer->feed(permutation);
+				permutation.next();
+			}
+		}
+		
+		consumer->finish();
+	}
+}
+
+/**
+ * Generates all partitions of set [n] in parallel.
+ * 
+ * The sequence of partitions in lexicographical order of their restricted growth
+ * strings (the order of SetPartitionGenerator) is cut into rangeCount disjoint
+ * ranges of indexes, which are enumerated by separate tasks of the thread pool
+ * with separate consumers. See ParallelPermutationGenerator for details.
+ * 
+ * @param TPL_ParallelSetPartitionGenerator_Consumer Type of the consumer. It must be
+ *		default-constructible and provide method merge(consumer) (see Counter and Collector).
+ */
+template <typename TPL_ParallelSetPartitionGenerator_Consumer> class ParallelSetPartitionGenerator
+{
+	private: TPL_ParallelSetPartitionGenerator_Consumer *consumer;
+
+
+	/**
+	 * Constructor that does the work.
+	 * 
+	 * @param n Cardinality of the set, 25 >= n >= 0.
+	 * @param rangeCount Number of ranges, rangeCount > 0.
+	 */
+	public: ParallelSetPartitionGenerator(TPL_ParallelSetPartitionGenerator_Consumer *consumer, int n, ThreadPool &pool, int rangeCount)
+	{
+		assert(n >= 0 && rangeCount > 0);
+		
+		const RestrictedGrowthString rgs(n);
+		const unsigned long long total = rgs.getPartitionCount();
+		std::vector <TPL_ParallelSetPartitionGenerator_Consumer> partialConsumers(rangeCount);
+		TaskGroup group(pool);
+		
+		for (int i = 0; i < rangeCount; i++)
+		{
+			const unsigned long long first = getRangeStart(total, rangeCount, i);
+			const unsigned long long last = getRangeStart(total, rangeCount, i + 1);
+			TPL_ParallelSetPartitionGenerator_Consumer *partialConsumer = &partialConsumers[i];
+			RestrictedGrowthString const *rgsPtr = &rgs;
+			
+			group.run([n, first, last, partialConsumer, rgsPtr]()
+			{
+				ParallelSetPartitionGenerator::generate(partialConsumer, n, *rgsPtr, first, last);
+			});
+		}
+		
+		group.wait();
+		
+		this->consumer = consumer;
+		this->consumer->start();
+		
+		for (int i = 0; i < rangeCount; i++)
+		{
+			this->consumer->merge(partialConsumers[i]);
+		}
+	}
+
+	/**
+	 * Destructor that sends "finish" message to the consumer.
+	 */
+	public: ~ParallelSetPartitionGenerator()
+	{
+		this->consumer->finish();
+	}
+
+	/**
+	 * Feeds partitions with lexicographical indexes [first; last) to the consumer.
+	 */
+	private: static void generate(TPL_ParallelSetPartitionGenerator_Consumer *consumer, int n, RestrictedGrowthString const &rgs, unsigned long long first, unsigned long long last)
+	{
+		consumer->start();
+		
+		if (first < last)
+		{
+			SetPartitionGenerator::SetPartition partition(n);
+			rgs.unrank(first, partition.data());
+			
+			for (unsigned long long index = first; index < last; index++)
+			{
+				consumer->feed(partition);
+				RestrictedGrowthString::next(partition.data(), n);
+			}
+		}
+		
+		consumer->finish();
+	}
+}
+
+
 }
 
 
@@ -1,7 +1,12 @@
 
+#include <eugenejonas/cpp_stuff/arithm/big_int.h>
 #include <eugenejonas/cpp_stuff/combinatorics/permutation.h>
 #include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <string>
 
 #include <cxxtest/TestSuite.h>
@@ -136,6 +141,24 @@ class UnitTest_Permutation_with_StrictTotalIntegerOrdering: public CxxTest::Test
 		
 		TS_ASSERT_EQUALS(false, doesNextPermutationExist);
 	}
+	
+	public: void test_rank_unrank()
+	{
+		Permutation <int, StrictTotalIntegerOrdering> p(6);
+		unsigned long long index = 0;
+		
+		do
+		{
+			TS_ASSERT_EQUALS(index, p.rank());
+			TS_ASSERT_EQUALS(p, (Permutation <int, StrictTotalIntegerOrdering> ::unrank(6, index)));
+			TS_ASSERT_EQUALS(BigInt((long) index), p.rankBigInt());
+			TS_ASSERT_EQUALS(p, (Permutation <int, StrictTotalIntegerOrdering> ::unrank(6, BigInt((long) index))));
+			index++;
+		}
+		while (p.next());
+		
+		TS_ASSERT_EQUALS(720ULL, index);
+	}
 }
 
 class UnitTest_Permutation_with_CustomStrictTotalOrdering: public CxxTest::TestSuite
@@ -173,5 +196,235 @@ class UnitTest_Permutation_with_CustomStrictTotalOrdering: public CxxTest::TestS
 	}
 }
 
+class UnitTest_InversionCounting: public CxxTest::TestSuite
+{
+	private: static vector <int> createRandomSequence(int n, int maxValue)
+	{
+		std::srand(n);
+		vector <int> res(n);
+		
+		for (int i = 0; i < n; i++)
+		{
+			res[i] = std::rand() % maxValue;
+		}
+		
+		return res;
+	}
+	
+	public: void test_with_duplicates()
+	{
+		int a[] = {3, 1, 3, 2, 1, 3, 0};
+		vector <int> v(a, a + sizeof(a) / sizeof(a[0]));
+		std::less <int> less;
+		
+		TS_ASSERT_EQUALS(12, calculateInversionsBruteForce(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(12, calculateInversionsMergeSort(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(12, calculateInversionsFenwick(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(12, calculateInversionsFenwickDense(v.begin(), v.end(), 4));
+	}
+	
+	public: void test_empty_and_single()
+	{
+		vector <int> v;
+		std::less <int> less;
+		
+		TS_ASSERT_EQUALS(0, calculateInversionsMergeSort(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(0, calculateInversionsFenwick(v.begin(), v.end(), less));
+		
+		v.push_back(1);
+		
+		TS_ASSERT_EQUALS(0, calculateInversionsMergeSort(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(0, calculateInversionsFenwick(v.begin(), v.end(), less));
+	}
+	
+	public: void test_random_against_brute_force()
+	{
+		std::less <int> less;
+		InversionCounter <int, std::less <int> > counter;
+		
+		for (int n = 2; n < 300; n += 7)
+		{
+			vector <int> v = createRandomSequence(n, n / 2 + 1);
+			long long expected = calculateInversionsBruteForce(v.begin(), v.end(), less);
+			
+			TS_ASSERT_EQUALS(expected, counter.count(v.begin(), v.end()));
+			TS_ASSERT_EQUALS(expected, calculateInversionsFenwick(v.begin(), v.end(), less));
+		}
+	}
+	
+	/**
+	 * n * (n - 1) / 2 doesn't fit into int.
+	 */
+	public: void test_reversed_does_not_overflow()
+	{
+		const int n = 100000;
+		vector <int> v(n);
+		
+		for (int i = 0; i < n; i++)
+		{
+			v[i] = n - i;
+		}
+		
+		std::less <int> less;
+		long long expected = (long long) n * (n - 1) / 2;
+		
+		TS_ASSERT_EQUALS(expected, calculateInversionsMergeSort(v.begin(), v.end(), less));
+		TS_ASSERT_EQUALS(expected, calculateInversionsFenwick(v.begin(), v.end(), less));
+	}
+	
+	public: void test_parallel()
+	{
+		ThreadPool pool(4);
+		std::less <int> less;
+		vector <int> v = createRandomSequence(50000, 1000);
+		long long expected = calculateInversionsFenwick(v.begin(), v.end(), less);
+		
+		TS_ASSERT_EQUALS(expected, calculateInversionsParallel(v.begin(), v.end(), less, pool, 1000));
+		TS_ASSERT_EQUALS(expected, calculateInversionsMergeSort(v.begin(), v.end(), less));
+	}
+}
+
+class UnitTest_DensePermutation: public CxxTest::TestSuite
+{
+	private: static DensePermutation createRandom(std::uint32_t n)
+	{
+		std::srand(n);
+		DensePermutation p(n);
+		
+		for (std::uint32_t i = n; i > 1; i--)
+		{
+			p.swap(i - 1, std::rand() % i);
+		}
+		
+		return p;
+	}
+	
+	/**
+	 * Composition computed straight from the definition.
+	 */
+	private: static DensePermutation multiplyNaively(DensePermutation const &a, DensePermutation const &b)
+	{
+		vector <std::uint32_t> res(a.getLength());
+		
+		for (std::uint32_t i = 0; i < a.getLength(); i++)
+		{
+			res[i] = a[b[i]];
+		}
+		
+		return DensePermutation(res);
+	}
+	
+	public: void test_composition()
+	{
+		DensePermutation a = createRandom(200), b = createRandom(200);
+		b = b * b * a;
+		DensePermutation expected = multiplyNaively(a, b);
+		
+		TS_ASSERT_EQUALS(expected, a * b);
+		
+		DensePermutation c = a;
+		c *= b;
+		
+		TS_ASSERT_EQUALS(expected, c);
+		
+		c = b;
+		c.premultiply(a);
+		
+		TS_ASSERT_EQUALS(expected, c);
+	}
+	
+	public: void test_inverse()
+	{
+		DensePermutation p = createRandom(1000), inverse = p;
+		inverse.invert();
+		
+		TS_ASSERT_EQUALS(p.getInverse(), inverse);
+		TS_ASSERT_EQUALS(DensePermutation(1000), p * inverse);
+		TS_ASSERT_EQUALS(DensePermutation(1000), inverse * p);
+	}
+	
+	public: void test_power()
+	{
+		DensePermutation p = createRandom(300), expected(300);
+		
+		TS_ASSERT_EQUALS(expected, p.power(0));
+		TS_ASSERT_EQUALS(p.getInverse(), p.power(-1));
+		
+		for (int k = 1; k <= 7; k++)
+		{
+			expected *= p;
+			
+			TS_ASSERT_EQUALS(expected, p.power(k));
+		}
+		
+		TS_ASSERT_EQUALS(expected.getInverse(), p.power(-7));
+	}
+	
+	public: void test_decomposition_in_cycles()
+	{
+		std::uint32_t a[] = {0, 2, 3, 1, 4};
+		std::uint32_t b[] = {0, 3, 1, 2, 4};
+		DensePermutation p = vector <std::uint32_t> (a, a + sizeof(a) / sizeof(a[0]));
+		DensePermutation expected = vector <std::uint32_t> (b, b + sizeof(b) / sizeof(b[0]));
+		
+		TS_ASSERT_EQUALS(expected, p.getDecompositionInCycles());
+		
+		p = createRandom(500);
+		DensePermutation copy(500);
+		copy.reconstructFromDecompositionInCycles(p.getDecompositionInCycles());
+		
+		TS_ASSERT_EQUALS(p, copy);
+	}
+	
+	public: void test_permute()
+	{
+		const std::uint32_t n = 10000;
+		DensePermutation p = createRandom(n);
+		vector <long long> src(n), direct(n), blocked(n);
+		
+		for (std::uint32_t i = 0; i < n; i++)
+		{
+			src[i] = (long long) i * i;
+		}
+		
+		p.permute(src.data(), direct.data());
+		p.permute(src.data(), blocked.data(), 64);
+		
+		TS_ASSERT_EQUALS(direct, blocked);
+		
+		for (std::uint32_t i = 0; i < n; i++)
+		{
+			TS_ASSERT_EQUALS(src[i], direct[p[i]]);
+		}
+	}
+	
+	public: void test_next_and_inversions()
+	{
+		DensePermutation p(4);
+		int count = 0;
+		
+		do
+		{
+			TS_ASSERT_EQUALS(p.calculateInversionsBruteForce(), p.calculateInversionsDivideAndConquer());
+			count++;
+		}
+		while (p.next());
+		
+		TS_ASSERT_EQUALS(24, count);
+		TS_ASSERT_EQUALS(6, p.calculateInversionsDivideAndConquer());
+	}
+	
+	public: void test_rank_unrank()
+	{
+		DensePermutation p = createRandom(18);
+		
+		TS_ASSERT_EQUALS(p, DensePermutation::unrank(18, p.rank()));
+		
+		p = createRandom(30);
+		
+		TS_ASSERT_EQUALS(p, DensePermutation::unrank(30, p.rankBigInt()));
+	}
+}
+
 
 }
@@ -3,11 +3,17 @@
 #define EUGENEJONAS__CPP_STUFF__COMBINATORICS__PERMUTATION_H
 
 
+#include <eugenejonas/cpp_stuff/arithm/big_int.h>
+#include <eugenejonas/cpp_stuff/combinatorics/ranking.h>
+#include <eugenejonas/cpp_stuff/fenwick_tree.h>
 #include <eugenejonas/cpp_stuff/orderings.h>
 #include <eugenejonas/cpp_stuff/sort.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <vector>
@@ -24,11 +30,11 @@ namespace eugenejonas::cpp_stuff
 {
 
 
-template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering> int calculateInversionsBruteForce(TPL_InputIterator first, TPL_InputIterator last, TPL_StrictWeakOrdering swoCompare)
+template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering> long long calculateInversionsBruteForce(TPL_InputIterator first, TPL_InputIterator last, TPL_StrictWeakOrdering swoCompare)
 {
 	BOOST_CONCEPT_ASSERT((boost::InputIterator <TPL_InputIterator>));
 	
-	int count = 0;
+	long long count = 0;
 	
 	for ( ; first != last && first != last - 1; ++first)
 	{
@@ -47,12 +53,303 @@ template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering> int calcu
 	return count;
 }
 
-template <typename TPL_InputIterator> int calculateInversionsBruteForce(TPL_InputIterator first, TPL_InputIterator last)
+template <typename TPL_InputIterator> long long calculateInversionsBruteForce(TPL_InputIterator first, TPL_InputIterator last)
 {
 	std::less <typename std::iterator_traits <TPL_InputIterator> ::value_type> less;
 	return calculateInversionsBruteForce(first, last, less);
 }
 
+/**
+ * Counts inversions of a sequence by sorting its copy with merge sort.
+ * Inversion in sequence A is pair of elements (A[i], A[j]) such that
+ * i < j and swoCompare(A[j], A[i]) == true.
+ * 
+ * Unlike Sorter::mergeSort, the sequence itself is not modified. The class
+ * uses one buffer of 2n elements: the copy of the sequence and the scratch
+ * space, between which merge passes alternate (ping-pong). The buffer is kept
+ * between calls, so a counter object can be reused without reallocation.
+ * Short ranges are sorted by insertion sort.
+ * 
+ * The count is 64-bit, so it doesn't overflow for sequences of up to
+ * about 4 * 10 ^ 9 elements.
+ */
+template <typename TPL_InversionCounter_T, typename TPL_InversionCounter_StrictWeakOrdering> class InversionCounter
+{
+	#ifndef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_InversionCounter_StrictWeakOrdering, TPL_InversionCounter_T>));
+	#endif
+
+
+	/**
+	 * Ranges not longer than this are sorted by insertion sort.
+	 */
+	private: static const std::size_t INSERTION_SORT_THRESHOLD = 16;
+
+
+	private: TPL_InversionCounter_StrictWeakOrdering swoCompare;
+	private: std::vector <TPL_InversionCounter_T> buffer;
+
+	/**
+	 * Pool used for counting inversions of halves concurrently, or nullptr.
+	 */
+	private: ThreadPool *pool;
+
+	/**
+	 * Ranges not longer than this are not split into parallel tasks.
+	 */
+	private: std::size_t grainSize;
+
+
+	public: InversionCounter(TPL_InversionCounter_StrictWeakOrdering swoCompare = TPL_InversionCounter_StrictWeakOrdering()):
+			swoCompare(swoCompare),
+			pool(nullptr),
+			grainSize(0)
+	{
+		//nothing
+	}
+
+	/**
+	 * Returns number of inversions in the range [first; last).
+	 * The range is not modified.
+	 * 
+	 * @time O(n * log(n))
+	 * @space O(n)
+	 */
+	public: template <typename TPL_InputIterator> long long count(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		this->pool = nullptr;
+		return this->countImpl(first, last);
+	}
+
+	/**
+	 * Parallel version of count(first, last). Inversions within the two halves
+	 * of every range longer than grainSize are counted concurrently by the
+	 * tasks of the pool, then cross-inversions between the halves are counted
+	 * while merging them.
+	 * 
+	 * @param grainSize Ranges not longer than this are processed sequentially.
+	 */
+	public: template <typename TPL_InputIterator> long long count(TPL_InputIterator first, TPL_InputIterator last, ThreadPool &pool, std::size_t grainSize = 1 << 14)
+	{
+		this->pool = &pool;
+		this->grainSize = std::max(grainSize, (std::size_t) INSERTION_SORT_THRESHOLD);
+		long long res = this->countImpl(first, last);
+		this->pool = nullptr;
+		return res;
+	}
+
+	private: template <typename TPL_InputIterator> long long countImpl(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		this->buffer.assign(first, last);
+		std::size_t n = this->buffer.size();
+		
+		if (n < 2)
+		{
+			return 0;
+		}
+		
+		// both halves of the buffer start as copies of the sequence
+		this->buffer.insert(this->buffer.end(), this->buffer.begin(), this->buffer.end());
+		
+		return this->splitMerge(&this->buffer[n], &this->buffer[0], 0, n);
+	}
+
+	/**
+	 * Sorts range [lo; hi) of src into the same range of dst.
+	 * 
+	 * @pre Ranges [lo; hi) of src and dst contain the same sequence.
+	 * @return Number of inversions in the range.
+	 */
+	private: long long splitMerge(TPL_InversionCounter_T *src, TPL_InversionCounter_T *dst, std::size_t lo, std::size_t hi)
+	{
+		if (hi - lo <= INSERTION_SORT_THRESHOLD)
+		{
+			return this->insertionSort(dst, lo, hi);
+		}
+		
+		std::size_t mid = lo + (hi - lo) / 2;
+		long long left, right;
+		
+		// sort both halves of dst into src, then merge them back into dst
+		
+		if (this->pool != nullptr && hi - lo > this->grainSize)
+		{
+			TaskGroup group(*this->pool);
+			
+			group.run([this, src, dst, lo, mid, &left]()
+			{
+				left = this->splitMerge(dst, src, lo, mid);
+			});
+			
+			right = this->splitMerge(dst, src, mid, hi);
+			group.wait();
+		}
+		else
+		{
+			left = this->splitMerge(dst, src, lo, mid);
+			right = this->splitMerge(dst, src, mid, hi);
+		}
+		
+		return left + right + this->merge(src, lo, mid, hi, dst);
+	}
+
+	/**
+	 * Merges sorted ranges [lo; mid) and [mid; hi) of src into range [lo; hi) of dst.
+	 * 
+	 * @return Number of cross-inversions between the two ranges.
+	 */
+	private: long long merge(const TPL_InversionCounter_T *src, std::size_t lo, std::size_t mid, std::size_t hi, TPL_InversionCounter_T *dst)
+	{
+		long long count = 0;
+		std::size_t i = lo, j = mid, k = lo;
+		
+		while (i < mid && j < hi)
+		{
+			if (this->swoCompare(src[j], src[i]))
+			{
+				// src[j] is less than all of src[i..mid)
+				count += mid - i;
+				dst[k++] = src[j++];
+			}
+			else
+			{
+				dst[k++] = src[i++];
+			}
+		}
+		
+		std::copy(src + i, src + mid, dst + k);
+		std::copy(src + j, src + hi, dst + k + (mid - i));
+		
+		return count;
+	}
+
+	/**
+	 * Sorts range [lo; hi) of arr in place.
+	 * 
+	 * @return Number of inversions in the range (every shift of an element removes one).
+	 */
+	private: long long insertionSort(TPL_InversionCounter_T *arr, std::size_t lo, std::size_t hi)
+	{
+		long long count = 0;
+		
+		for (std::size_t i = lo + 1; i < hi; i++)
+		{
+			TPL_InversionCounter_T element = arr[i];
+			std::size_t j = i;
+			
+			for ( ; j > lo && this->swoCompare(element, arr[j - 1]); j--)
+			{
+				arr[j] = arr[j - 1];
+			}
+			
+			arr[j] = element;
+			count += i - j;
+		}
+		
+		return count;
+	}
+}
+
+/**
+ * Returns number of inversions in the range [first; last) using InversionCounter.
+ * 
+ * @time O(n * log(n))
+ * @space O(n)
+ */
+template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering> long long calculateInversionsMergeSort(TPL_InputIterator first, TPL_InputIterator last, TPL_StrictWeakOrdering swoCompare)
+{
+	typedef typename std::iterator_traits <TPL_InputIterator> ::value_type value_type;
+	
+	return InversionCounter <value_type, TPL_StrictWeakOrdering> (swoCompare).count(first, last);
+}
+
+/**
+ * Returns number of inversions in the range [first; last). Inversions within
+ * the halves of the range are counted concurrently by the tasks of the pool.
+ * 
+ * @param grainSize Ranges not longer than this are processed sequentially.
+ */
+template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering> long long calculateInversionsParallel(
+		TPL_InputIterator first,
+		TPL_InputIterator last,
+		TPL_StrictWeakOrdering swoCompare,
+		ThreadPool &pool,
+		std::size_t grainSize = 1 << 14
+)
+{
+	typedef typename std::iterator_traits <TPL_InputIterator> ::value_type value_type;
+	
+	return InversionCounter <value_type, TPL_StrictWeakOrdering> (swoCompare).count(first, last, pool, grainSize);
+}
+
+/**
+ * Returns number of inversions in a sequence of integers from the compressed
+ * domain [0; domainSize), using Fenwick tree over the domain: for every element,
+ * the number of greater elements before it is counted.
+ * 
+ * @param domainSize Every element must be in range [0; domainSize).
+ * @time O(n * log(domainSize))
+ * @space O(domainSize)
+ */
+template <typename TPL_InputIterator> long long calculateInversionsFenwickDense(TPL_InputIterator first, TPL_InputIterator last, std::size_t domainSize)
+{
+	BOOST_CONCEPT_ASSERT((boost::InputIterator <TPL_InputIterator>));
+	
+	FenwickTree <long long> seen(domainSize);
+	long long count = 0, seenCount = 0;
+	
+	for ( ; first != last; ++first)
+	{
+		std::size_t value = (std::size_t) *first;
+		assert(value < domainSize);
+		
+		// elements seen so far which are greater than value
+		count += seenCount - seen.getPrefixSum(value + 1);
+		
+		seen.add(value, 1);
+		seenCount++;
+	}
+	
+	return count;
+}
+
+/**
+ * Returns number of inversions in the range [first; last) of arbitrary elements.
+ * Elements are first mapped to the compressed domain of their ranks
+ * (equivalent elements get the same rank), then calculateInversionsFenwickDense is used.
+ * 
+ * @time O(n * log(n))
+ * @space O(n)
+ */
+template <typename TPL_RandomAccessIterator, typename TPL_StrictWeakOrdering> long long calculateInversionsFenwick(TPL_RandomAccessIterator first, TPL_RandomAccessIterator last, TPL_StrictWeakOrdering swoCompare)
+{
+	typedef typename std::iterator_traits <TPL_RandomAccessIterator> ::value_type value_type;
+	
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_RandomAccessIterator>));
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_StrictWeakOrdering, value_type>));
+	
+	std::vector <value_type> sorted(first, last);
+	std::sort(sorted.begin(), sorted.end(), swoCompare);
+	
+	// equivalent elements are adjacent now
+	sorted.erase(
+			std::unique(sorted.begin(), sorted.end(), [&swoCompare](value_type const &a, value_type const &b)
+			{
+				return !swoCompare(a, b) && !swoCompare(b, a);
+			}),
+			sorted.end()
+	);
+	
+	std::vector <std::size_t> ranks(last - first);
+	
+	for (std::size_t i = 0; i < ranks.size(); i++)
+	{
+		ranks[i] = std::lower_bound(sorted.begin(), sorted.end(), *(first + i), swoCompare) - sorted.begin();
+	}
+	
+	return calculateInversionsFenwickDense(ranks.begin(), ranks.end(), sorted.size());
+}
+
 /**
  * Prints out standard representation of the permutation.
  */
@@ -369,12 +666,12 @@ template <typename TPL_Permutation_T = int, typename TPL_Permutation_StrictTotal
 	/**
 	 * Returns number of inversions.
 	 *
-	 * @time n * log(n)
+	 * @time O(n * log(n))
+	 * @space O(n)
 	 */
-	public: int calculateInversionsDivideAndConquer() const
+	public: long long calculateInversionsDivideAndConquer() const
 	{
-		Permutation <TPL_Permutation_T, TPL_Permutation_StrictTotalOrdering> copy = *this;
-		return mergeSort(copy.begin(), copy.end());
+		return calculateInversionsMergeSort(this->begin(), this->end(), this->stoCompare);
 	}
 
 	/**
@@ -383,9 +680,9 @@ template <typename TPL_Permutation_T = int, typename TPL_Permutation_StrictTotal
 	 * @time O(n ^ 2)
 	 * @space O(1)
 	 */
-	public: int calculateInversionsBruteForce() const
+	public: long long calculateInversionsBruteForce() const
 	{
-		return calculateInversionsBruteForce(this->begin(), this->end());
+		return ::eugenejonas::cpp_stuff::calculateInversionsBruteForce(this->begin(), this->end(), this->stoCompare);
 	}
 
 	/**
@@ -422,8 +719,652 @@ template <typename TPL_Permutation_T = int, typename TPL_Permutation_StrictTotal
 		
 		return false;
 	}
+
+	/**
+	 * Returns index of this permutation in lexicographical order
+	 * of all permutations of its elements (0 for the identical permutation).
+	 *
+	 * @pre n <= 20. For longer permutations use rankBigInt().
+	 * @time O(n) if the ordering finds ordinal numbers in O(1), e.g. StrictTotalIntegerOrdering;
+	 *		O(n ^ 2) with CustomStrictTotalOrdering, which searches for them linearly
+	 * @space O(n)
+	 */
+	public: unsigned long long rank() const
+	{
+		std::vector <int> ordinals = this->getOrdinals();
+		return LehmerCode::rank(ordinals.data(), (int) this->size());
+	}
+
+	/**
+	 * Returns index of this permutation in lexicographical order.
+	 *
+	 * @time O(n * log(n)) arithmetic operations, plus O(n ^ 2) comparisons of
+	 *		elements with CustomStrictTotalOrdering (see rank())
+	 * @space O(n)
+	 */
+	public: BigInt rankBigInt() const
+	{
+		std::vector <int> ordinals = this->getOrdinals();
+		return LehmerCode::rankLarge <BigInt> (ordinals.data(), (int) this->size());
+	}
+
+	/**
+	 * Returns permutation of length n with the given index in lexicographical order.
+	 * Relation between rank and unrank:
+	 * 
+	 * Permutation::unrank(p.getLength(), p.rank()) == p
+	 *
+	 * @param n 20 >= n >= 0.
+	 * @param index 0 <= index < n!
+	 * @time O(n ^ 2) bit operations
+	 */
+	public: static Permutation <TPL_Permutation_T, TPL_Permutation_StrictTotalOrdering> unrank(
+			int n,
+			unsigned long long index,
+			TPL_Permutation_StrictTotalOrdering stoCompare = TPL_Permutation_StrictTotalOrdering()
+	)
+	{
+		std::vector <int> ordinals(n);
+		LehmerCode::unrank(n, index, ordinals.data());
+		return Permutation::createFromOrdinals(ordinals, stoCompare);
+	}
+
+	/**
+	 * Returns permutation of length n with the given index in lexicographical order.
+	 *
+	 * @param index 0 <= index < n!
+	 * @time O(n * log(n)) arithmetic operations
+	 */
+	public: static Permutation <TPL_Permutation_T, TPL_Permutation_StrictTotalOrdering> unrank(
+			int n,
+			BigInt const &index,
+			TPL_Permutation_StrictTotalOrdering stoCompare = TPL_Permutation_StrictTotalOrdering()
+	)
+	{
+		std::vector <int> ordinals(n);
+		LehmerCode::unrankLarge(n, index, ordinals.data());
+		return Permutation::createFromOrdinals(ordinals, stoCompare);
+	}
+
+	private: std::vector <int> getOrdinals() const
+	{
+		std::vector <int> ordinals(this->size());
+		
+		for (size_type i = 0; i < this->size(); i++)
+		{
+			ordinals[i] = this->stoCompare.getOrdinalNumber((*this)[i]);
+		}
+		
+		return ordinals;
+	}
+
+	private: static Permutation <TPL_Permutation_T, TPL_Permutation_StrictTotalOrdering> createFromOrdinals(
+			std::vector <int> const &ordinals,
+			TPL_Permutation_StrictTotalOrdering stoCompare
+	)
+	{
+		std::vector <TPL_Permutation_T> resArr;
+		resArr.reserve(ordinals.size());
+		
+		for (size_type i = 0; i < ordinals.size(); i++)
+		{
+			resArr.push_back(stoCompare.getElementByOrdinalNumber(ordinals[i]));
+		}
+		
+		return Permutation <TPL_Permutation_T, TPL_Permutation_StrictTotalOrdering> (resArr, stoCompare);
+	}
+}
+
+/**
+ * Permutation of indexes 0..n-1, stored as an array of 32-bit integers.
+ * 
+ * Unlike the general Permutation, which maps elements to ordinal numbers through
+ * the ordering (std::find in case of CustomStrictTotalOrdering), every element
+ * here is its own ordinal number, so composition, inversion and cycle
+ * decomposition take O(n) time. In addition, it supports in-place composition
+ * and inversion, cache-blocked application to arrays and powers.
+ * 
+ * Element i is mapped to element p[i]; standard representation is
+ * [p(0) p(1) ... p(n - 1)].
+ */
+template <> class Permutation <std::uint32_t, DenseIndexOrdering>: private std::vector <std::uint32_t>
+{
+	public: typedef std::vector <std::uint32_t> ::size_type size_type;
+	public: typedef std::vector <std::uint32_t> ::const_iterator const_iterator;
+
+
+	/**
+	 * permute() distributes the elements in blocks of this many elements,
+	 * so that writes to the destination stay within the cache.
+	 */
+	public: static const std::size_t DEFAULT_BLOCK_SIZE = 1 << 15;
+
+	/**
+	 * Used by the in-place algorithms to mark processed positions.
+	 */
+	private: static const std::uint32_t MARK = 1u << 31;
+
+
+	/**
+	 * Creates identical permutation.
+	 * 
+	 * @param n Length of the permutation, 2 ^ 31 >= n >= 0.
+	 * @time O(n)
+	 */
+	public: Permutation(std::uint32_t n = 0, DenseIndexOrdering /*stoCompare*/ = DenseIndexOrdering()):
+			std::vector <std::uint32_t> (n)
+	{
+		assert(n <= Permutation::MARK);
+		
+		std::uint32_t *p = this->data();
+		
+		for (std::uint32_t i = 0; i < n; i++)
+		{
+			p[i] = i;
+		}
+	}
+
+	/**
+	 * Constructs permutation from standard representation.
+	 * 
+	 * @pre standardRepresentation contains every index 0..n-1 exactly once.
+	 * @time O(n)
+	 */
+	public: Permutation(const std::vector <std::uint32_t> &standardRepresentation, DenseIndexOrdering /*stoCompare*/ = DenseIndexOrdering()):
+			std::vector <std::uint32_t> (standardRepresentation)
+	{
+		assert(this->size() <= Permutation::MARK);
+	}
+
+	public: bool operator==(Permutation <std::uint32_t, DenseIndexOrdering> const &other) const
+	{
+		assert(other.size() == this->size());
+		return std::equal(this->begin(), this->end(), other.begin());
+	}
+	public: bool operator<(Permutation <std::uint32_t, DenseIndexOrdering> const &other) const
+	{
+		assert(other.size() == this->size());
+		return std::lexicographical_compare(this->begin(), this->end(), other.begin(), other.end());
+	}
+	public: bool operator>(Permutation <std::uint32_t, DenseIndexOrdering> const &other) const
+	{
+		return other < *this;
+	}
+
+	public: size_type getLength() const
+	{
+		return std::vector <std::uint32_t> ::size();
+	}
+
+	/**
+	 * Returns p(i).
+	 */
+	public: std::uint32_t operator[](std::uint32_t i) const
+	{
+		assert(i < this->size());
+		return std::vector <std::uint32_t> ::operator[](i);
+	}
+
+	public: const std::uint32_t *getData() const
+	{
+		return this->data();
+	}
+
+	public: const_iterator begin() const
+	{
+		return std::vector <std::uint32_t> ::begin();
+	}
+
+	public: const_iterator end() const
+	{
+		return std::vector <std::uint32_t> ::end();
+	}
+
+	/**
+	 * Swaps elements at indexes i and j.
+	 */
+	public: void swap(std::uint32_t i, std::uint32_t j)
+	{
+		assert(i < this->size() && j < this->size());
+		std::swap(this->at(i), this->at(j));
+	}
+
+	/**
+	 * Multiplies two permutations.
+	 * 
+	 * @return Permutation p such that p(i) == this(other(i)).
+	 * @time O(n)
+	 */
+	public: Permutation <std::uint32_t, DenseIndexOrdering> operator*(Permutation <std::uint32_t, DenseIndexOrdering> const &other) const
+	{
+		Permutation <std::uint32_t, DenseIndexOrdering> res = *this;
+		res *= other;
+		return res;
+	}
+
+	/**
+	 * Replaces this permutation with this * other, without allocating memory.
+	 * Every cycle of <other> rotates the elements of this permutation at
+	 * the indexes of the cycle; processed indexes are marked with the high bit.
+	 * 
+	 * @time O(n)
+	 * @space O(1)
+	 */
+	public: Permutation <std::uint32_t, DenseIndexOrdering> &operator*=(Permutation <std::uint32_t, DenseIndexOrdering> const &other)
+	{
+		assert(other.size() == this->size());
+		
+		std::uint32_t *p = this->data();
+		const std::uint32_t *q = other.data();
+		std::uint32_t n = (std::uint32_t) this->size();
+		
+		for (std::uint32_t start = 0; start < n; start++)
+		{
+			if (p[start] & Permutation::MARK)
+			{
+				continue;
+			}
+			
+			// res(i) == p(q(i)) along the cycle start -> q(start) -> ...
+			std::uint32_t first = p[start], i = start;
+			
+			for ( ; q[i] != start; i = q[i])
+			{
+				p[i] = p[q[i]] | Permutation::MARK;
+			}
+			
+			p[i] = first | Permutation::MARK;
+		}
+		
+		this->clearMarks();
+		return *this;
+	}
+
+	/**
+	 * Replaces this permutation with other * this.
+	 * 
+	 * @time O(n)
+	 * @space O(1)
+	 */
+	public: void premultiply(Permutation <std::uint32_t, DenseIndexOrdering> const &other)
+	{
+		assert(other.size() == this->size());
+		
+		std::uint32_t *p = this->data();
+		const std::uint32_t *q = other.data();
+		
+		for (std::size_t i = 0; i < this->size(); i++)
+		{
+			p[i] = q[p[i]];
+		}
+	}
+
+	/**
+	 * Calculates the inverse permutation.
+	 * 
+	 * @time O(n)
+	 */
+	public: Permutation <std::uint32_t, DenseIndexOrdering> getInverse() const
+	{
+		std::vector <std::uint32_t> resArr(this->size());
+		const std::uint32_t *p = this->data();
+		
+		for (std::uint32_t i = 0; i < this->size(); i++)
+		{
+			resArr[p[i]] = i;
+		}
+		
+		return Permutation <std::uint32_t, DenseIndexOrdering> (resArr);
+	}
+
+	/**
+	 * Replaces this permutation with its inverse by reversing every cycle.
+	 * 
+	 * @time O(n)
+	 * @space O(1)
+	 */
+	public: void invert()
+	{
+		std::uint32_t *p = this->data();
+		std::uint32_t n = (std::uint32_t) this->size();
+		
+		for (std::uint32_t start = 0; start < n; start++)
+		{
+			if (p[start] & Permutation::MARK)
+			{
+				continue;
+			}
+			
+			// walk the cycle, pointing every element back to its predecessor
+			std::uint32_t prev = start, cur = p[start];
+			
+			while (cur != start)
+			{
+				std::uint32_t next = p[cur];
+				p[cur] = prev | Permutation::MARK;
+				prev = cur;
+				cur = next;
+			}
+			
+			p[start] = prev | Permutation::MARK;
+		}
+		
+		this->clearMarks();
+	}
+
+	/**
+	 * Returns this ^ k. Negative k means power of the inverse permutation.
+	 * Every cycle of length L is rotated by k mod L.
+	 * 
+	 * @time O(n)
+	 * @space O(n)
+	 */
+	public: Permutation <std::uint32_t, DenseIndexOrdering> power(long long k) const
+	{
+		std::uint32_t n = (std::uint32_t) this->size();
+		const std::uint32_t *p = this->data();
+		std::vector <std::uint32_t> resArr(n);
+		std::vector <bool> isVisited(n);
+		std::vector <std::uint32_t> cycle;
+		
+		for (std::uint32_t start = 0; start < n; start++)
+		{
+			if (isVisited[start])
+			{
+				continue;
+			}
+			
+			cycle.clear();
+			
+			for (std::uint32_t i = start; !isVisited[i]; i = p[i])
+			{
+				isVisited[i] = true;
+				cycle.push_back(i);
+			}
+			
+			long long length = (long long) cycle.size();
+			std::size_t shift = (std::size_t) (((k % length) + length) % length);
+			
+			for (std::size_t t = 0; t < cycle.size(); t++)
+			{
+				std::size_t target = t + shift;
+				resArr[cycle[t]] = cycle[target < cycle.size() ? target : target - cycle.size()];
+			}
+		}
+		
+		return Permutation <std::uint32_t, DenseIndexOrdering> (resArr);
+	}
+
+	/**
+	 * Moves every element src[i] to dst[p(i)].
+	 * 
+	 * For large n the straightforward loop writes to random locations of dst,
+	 * missing the cache on nearly every element. Instead, the elements are
+	 * first distributed (together with their destination indexes) into
+	 * buckets by the block of dst they go to, then every bucket is written
+	 * out; this way both passes access memory in a cache-friendly manner.
+	 * 
+	 * @param src, dst Arrays of length n, must not overlap.
+	 * @param blockSize Number of elements of dst per bucket; arrays not longer
+	 *		than this are permuted directly.
+	 * @time O(n)
+	 * @space O(n) for large n, O(1) otherwise
+	 */
+	public: template <typename TPL_T> void permute(const TPL_T *src, TPL_T *dst, std::size_t blockSize = DEFAULT_BLOCK_SIZE) const
+	{
+		std::size_t n = this->size();
+		const std::uint32_t *p = this->data();
+		
+		if (n <= blockSize)
+		{
+			for (std::size_t i = 0; i < n; i++)
+			{
+				dst[p[i]] = src[i];
+			}
+			
+			return;
+		}
+		
+		struct Entry
+		{
+			public: std::uint32_t index;
+			public: TPL_T value;
+		}
+		
+		std::size_t bucketCount = (n + blockSize - 1) / blockSize;
+		std::vector <std::size_t> offsets(bucketCount + 1);
+		
+		for (std::size_t i = 0; i < n; i++)
+		{
+			offsets[p[i] / blockSize + 1]++;
+		}
+		
+		for (std::size_t b = 0; b < bucketCount; b++)
+		{
+			offsets[b + 1] += offsets[b];
+		}
+		
+		std::vector <Entry> entries(n);
+		
+		for (std::size_t i = 0; i < n; i++)
+		{
+			Entry &entry = entries[offsets[p[i] / blockSize]++];
+			entry.index = p[i];
+			entry.value = src[i];
+		}
+		
+		for (std::size_t i = 0; i < n; i++)
+		{
+			dst[entries[i].index] = entries[i].value;
+		}
+	}
+
+	/**
+	 * Returns canonical representation of the decomposition of
+	 * this permutation in a product of disjoint cycles: every cycle starts
+	 * by its largest element, cycles are ordered by their largest element
+	 * in the ascending order.
+	 *
+	 * For example, canonical representation of permutation [0 2 3 1 4]
+	 * is (0)(3 1 2)(4). In this case, function would return permutation [0 3 1 2 4].
+	 *
+	 * @time O(n)
+	 * @space O(n)
+	 */
+	public: Permutation <std::uint32_t, DenseIndexOrdering> getDecompositionInCycles() const
+	{
+		std::uint32_t n = (std::uint32_t) this->size();
+		const std::uint32_t *p = this->data();
+		std::vector <std::uint32_t> resArr(n);
+		std::vector <bool> isVisited(n);
+		
+		// the largest unvisited element is the largest in its cycle;
+		// cycles are written from the end of the array
+		
+		std::uint32_t end = n;
+		
+		for (std::uint32_t max = n; max-- > 0; )
+		{
+			if (isVisited[max])
+			{
+				continue;
+			}
+			
+			std::uint32_t length = 0;
+			
+			for (std::uint32_t i = max; !isVisited[i]; i = p[i])
+			{
+				isVisited[i] = true;
+				length++;
+			}
+			
+			end -= length;
+			std::uint32_t i = max;
+			
+			for (std::uint32_t t = 0; t < length; t++, i = p[i])
+			{
+				resArr[end + t] = i;
+			}
+		}
+		
+		return Permutation <std::uint32_t, DenseIndexOrdering> (resArr);
+	}
+
+	/**
+	 * Reconstructs original permutation from canonical
+	 * representation of its decomposition in a product of disjoint cycles.
+	 * 
+	 * @see Permutation::reconstructFromDecompositionInCycles
+	 * @time O(n)
+	 */
+	public: void reconstructFromDecompositionInCycles(const Permutation <std::uint32_t, DenseIndexOrdering> &decomposition)
+	{
+		assert(decomposition.size() == this->size());
+		
+		std::uint32_t *p = this->data();
+		const std::uint32_t *d = decomposition.data();
+		std::size_t recordIndex = 0;
+		
+		for (std::size_t i = 0; i < this->size(); i++)
+		{
+			bool isNewRecord = i + 1 == this->size() || d[recordIndex] < d[i + 1];
+			
+			if (isNewRecord)
+			{
+				p[d[i]] = d[recordIndex];
+				recordIndex = i + 1;
+			}
+			else
+			{
+				p[d[i]] = d[i + 1];
+			}
+		}
+	}
+
+	/**
+	 * Returns number of inversions.
+	 *
+	 * @time O(n * log(n))
+	 * @space O(n)
+	 */
+	public: long long calculateInversionsDivideAndConquer() const
+	{
+		return calculateInversionsFenwickDense(this->begin(), this->end(), this->size());
+	}
+
+	/**
+	 * Returns number of inversions.
+	 *
+	 * @time O(n ^ 2)
+	 * @space O(1)
+	 */
+	public: long long calculateInversionsBruteForce() const
+	{
+		return ::eugenejonas::cpp_stuff::calculateInversionsBruteForce(this->begin(), this->end(), DenseIndexOrdering());
+	}
+
+	/**
+	 * Generates the next permutation in lexicographical order.
+	 *
+	 * @return false if the next permutation does not exist (permutation is not changed), true otherwise.
+	 * @time O(n)
+	 */
+	public: bool next()
+	{
+		std::uint32_t *p = this->data();
+		std::size_t i = this->size();
+		
+		// find the longest decreasing suffix p[i - 1..n)
+		
+		while (i > 1 && p[i - 2] > p[i - 1])
+		{
+			i--;
+		}
+		
+		if (i <= 1)
+		{
+			return false;
+		}
+		
+		std::size_t j = this->size() - 1;
+		
+		while (p[j] < p[i - 2])
+		{
+			j--;
+		}
+		
+		std::swap(p[i - 2], p[j]);
+		std::reverse(p + i - 1, p + this->size());
+		return true;
+	}
+
+	/**
+	 * Returns index of this permutation in lexicographical order.
+	 *
+	 * @pre n <= 20. For longer permutations use rankBigInt().
+	 * @time O(n)
+	 */
+	public: unsigned long long rank() const
+	{
+		return LehmerCode::rank(this->data(), (int) this->size());
+	}
+
+	/**
+	 * Returns index of this permutation in lexicographical order.
+	 *
+	 * @time O(n * log(n)) arithmetic operations
+	 */
+	public: BigInt rankBigInt() const
+	{
+		return LehmerCode::rankLarge <BigInt> (this->data(), (int) this->size());
+	}
+
+	/**
+	 * Returns permutation of length n with the given index in lexicographical order.
+	 *
+	 * @param n 20 >= n >= 0.
+	 * @param index 0 <= index < n!
+	 * @time O(n ^ 2) bit operations
+	 */
+	public: static Permutation <std::uint32_t, DenseIndexOrdering> unrank(std::uint32_t n, unsigned long long index, DenseIndexOrdering stoCompare = DenseIndexOrdering())
+	{
+		Permutation <std::uint32_t, DenseIndexOrdering> res(n, stoCompare);
+		LehmerCode::unrank((int) n, index, res.data());
+		return res;
+	}
+
+	/**
+	 * Returns permutation of length n with the given index in lexicographical order.
+	 *
+	 * @param index 0 <= index < n!
+	 * @time O(n * log(n)) arithmetic operations
+	 */
+	public: static Permutation <std::uint32_t, DenseIndexOrdering> unrank(std::uint32_t n, BigInt const &index, DenseIndexOrdering stoCompare = DenseIndexOrdering())
+	{
+		Permutation <std::uint32_t, DenseIndexOrdering> res(n, stoCompare);
+		LehmerCode::unrankLarge((int) n, index, res.data());
+		return res;
+	}
+
+	/**
+	 * Clears marks left by the in-place algorithms.
+	 */
+	private: void clearMarks()
+	{
+		std::uint32_t *p = this->data();
+		
+		for (std::size_t i = 0; i < this->size(); i++)
+		{
+			p[i] &= ~Permutation::MARK;
+		}
+	}
 }
 
+/**
+ * Permutation of indexes 0..n-1 with O(n) composition, inversion and cycle decomposition.
+ */
+typedef Permutation <std::uint32_t, DenseIndexOrdering> DensePermutation;
+
 
 }
 
@@ -0,0 +1,138 @@
+#include <eugenejonas/cpp_stuff/combinatorics/generators.h>
+#include <eugenejonas/cpp_stuff/combinatorics/permutation.h>
+#include <eugenejonas/cpp_stuff/consumers.h>
+#include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+
+using eugenejonas::cpp_stuff::Counter;
+using eugenejonas::cpp_stuff::HeapPermutationIterator;
+using eugenejonas::cpp_stuff::ParallelPermutationGenerator;
+using eugenejonas::cpp_stuff::Permutation;
+using eugenejonas::cpp_stuff::PermutationGenerator;
+using eugenejonas::cpp_stuff::SteinhausJohnsonTrotterIterator;
+using eugenejonas::cpp_stuff::StrictTotalIntegerOrdering;
+using eugenejonas::cpp_stuff::ThreadPool;
+
+using std::cout;
+using std::vector;
+
+
+typedef std::chrono::steady_clock Clock;
+
+
+double getMillisecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration <double, std::milli> (Clock::now() - start).count();
+}
+
+/**
+ * Visits all permutations with the given transposition iterator and maintains
+ * sum of i * p(i) incrementally, using only the reported transpositions.
+ */
+template <typename TPL_Iterator> long long runTranspositionIterator(int n, long long &count)
+{
+	TPL_Iterator it(n);
+	vector <int> const &elements = it.getElements();
+	long long weightedSum = 0;
+	long long checksum = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		weightedSum += (long long) (i + 1) * elements[i];
+	}
+
+	count = 1;
+	checksum += weightedSum;
+
+	while (it.next())
+	{
+		int i = it.getFirstSwappedIndex(), j = it.getSecondSwappedIndex();
+
+		// elements[i] and elements[j] have already been swapped
+		weightedSum += (long long) (i - j) * (elements[i] - elements[j]);
+		checksum += weightedSum;
+		count++;
+	}
+
+	return checksum;
+}
+
+
+/**
+ * This program compares speed of the permutation generators:
+ * PermutationGenerator (recursive swapping with Consumer interface),
+ * Permutation::next() (lexicographical order), HeapPermutationIterator,
+ * SteinhausJohnsonTrotterIterator and ParallelPermutationGenerator. The
+ * latter cuts the permutations into 16 ranges per thread of the pool, and
+ * every range is counted by its own consumer.
+ */
+int main()
+{
+	const int n = 11;
+
+
+
+	{
+		Clock::time_point start = Clock::now();
+		Counter <Permutation> counter;
+		PermutationGenerator(&counter, n);
+
+		cout << "PermutationGenerator: " << counter.getCount() << " permutations, " << getMillisecondsSince(start) << " ms\n";
+	}
+
+
+
+	{
+		Clock::time_point start = Clock::now();
+		Permutation <int, StrictTotalIntegerOrdering> p(n);
+		long long count = 0;
+
+		do
+		{
+			count++;
+		}
+		while (p.next());
+
+		cout << "Permutation::next(): " << count << " permutations, " << getMillisecondsSince(start) << " ms\n";
+	}
+
+
+
+	{
+		Clock::time_point start = Clock::now();
+		long long count;
+		long long checksum = runTranspositionIterator <HeapPermutationIterator> (n, count);
+
+		cout << "HeapPermutationIterator: " << count << " permutations, " << getMillisecondsSince(start) << " ms (checksum " << checksum << ")\n";
+	}
+
+
+
+	{
+		Clock::time_point start = Clock::now();
+		long long count;
+		long long checksum = runTranspositionIterator <SteinhausJohnsonTrotterIterator> (n, count);
+
+		cout << "SteinhausJohnsonTrotterIterator: " << count << " permutations, " << getMillisecondsSince(start) << " ms (checksum " << checksum << ")\n";
+	}
+
+
+
+	{
+		ThreadPool pool;
+		Clock::time_point start = Clock::now();
+		Counter <Permutation <int, StrictTotalIntegerOrdering> > counter;
+		ParallelPermutationGenerator <Counter <Permutation <int, StrictTotalIntegerOrdering> > > (&counter, n, pool, 16 * pool.getThreadCount());
+
+		cout << "ParallelPermutationGenerator (" << pool.getThreadCount() << " threads): " << counter.getCount() << " permutations, " << getMillisecondsSince(start) << " ms\n";
+	}
+
+
+
+	return 0;
+}
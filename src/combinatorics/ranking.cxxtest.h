@@ -0,0 +1,187 @@
+#include <eugenejonas/cpp_stuff/arithm/big_int.h>
+#include <eugenejonas/cpp_stuff/combinatorics/ranking.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::vector;
+
+
+class UnitTest_LehmerCode: public CxxTest::TestSuite
+{
+	public: void test_getPermutationCount()
+	{
+		TS_ASSERT_EQUALS(1ULL, LehmerCode::getPermutationCount(0));
+		TS_ASSERT_EQUALS(1ULL, LehmerCode::getPermutationCount(1));
+		TS_ASSERT_EQUALS(720ULL, LehmerCode::getPermutationCount(6));
+		TS_ASSERT_EQUALS(2432902008176640000ULL, LehmerCode::getPermutationCount(20));
+	}
+	
+	/**
+	 * Unranking must produce permutations in the same order as std::next_permutation.
+	 */
+	public: void test_unrank_in_lexicographical_order()
+	{
+		const int n = 5;
+		vector <int> expected(n), actual(n);
+		
+		for (int i = 0; i < n; i++)
+		{
+			expected[i] = i;
+		}
+		
+		for (unsigned long long index = 0; index < LehmerCode::getPermutationCount(n); index++)
+		{
+			LehmerCode::unrank(n, index, actual.data());
+			TS_ASSERT_EQUALS(expected, actual);
+			TS_ASSERT_EQUALS(index, LehmerCode::rank(actual.data(), n));
+			
+			std::next_permutation(expected.begin(), expected.end());
+		}
+	}
+	
+	public: void test_large_permutation()
+	{
+		const int n = 20;
+		vector <int> ordinals(n);
+		
+		LehmerCode::unrank(n, LehmerCode::getPermutationCount(n) - 1, ordinals.data());
+		
+		for (int i = 0; i < n; i++)
+		{
+			TS_ASSERT_EQUALS(n - 1 - i, ordinals[i]);
+		}
+		
+		TS_ASSERT_EQUALS(LehmerCode::getPermutationCount(n) - 1, LehmerCode::rank(ordinals.data(), n));
+	}
+	
+	public: void test_rankLarge_matches_rank()
+	{
+		const int n = 12;
+		vector <int> ordinals(n), actual(n);
+		
+		for (unsigned long long index = 0; index < LehmerCode::getPermutationCount(n); index += 9973)
+		{
+			LehmerCode::unrank(n, index, ordinals.data());
+			
+			TS_ASSERT_EQUALS(index, LehmerCode::rankLarge <unsigned long long> (ordinals.data(), n));
+			
+			LehmerCode::unrankLarge(n, index, actual.data());
+			
+			TS_ASSERT_EQUALS(ordinals, actual);
+		}
+	}
+	
+	/**
+	 * 25! doesn't fit into 64 bits.
+	 */
+	public: void test_rankLarge_with_BigInt()
+	{
+		const int n = 25;
+		vector <int> ordinals(n);
+		BigInt count = 1;
+		
+		for (int i = 2; i <= n; i++)
+		{
+			count *= (long) i;
+		}
+		
+		LehmerCode::unrankLarge(n, count - 1, ordinals.data());
+		
+		for (int i = 0; i < n; i++)
+		{
+			TS_ASSERT_EQUALS(n - 1 - i, ordinals[i]);
+		}
+		
+		TS_ASSERT_EQUALS(count - 1, LehmerCode::rankLarge <BigInt> (ordinals.data(), n));
+		
+		BigInt index = count / 3;
+		LehmerCode::unrankLarge(n, index, ordinals.data());
+		
+		TS_ASSERT_EQUALS(index, LehmerCode::rankLarge <BigInt> (ordinals.data(), n));
+	}
+	
+	public: void test_rankBatch()
+	{
+		const int n = 7;
+		const std::size_t count = 5040;
+		vector <std::uint8_t> ordinals(count * n);
+		vector <unsigned long long> ranks(count), parallelRanks(count);
+		
+		for (std::size_t k = 0; k < count; k++)
+		{
+			// store the permutations in reversed order
+			LehmerCode::unrank(n, count - 1 - k, ordinals.data() + k * n);
+		}
+		
+		LehmerCode::rankBatch(ordinals.data(), n, count, ranks.data());
+		
+		ThreadPool pool(3);
+		LehmerCode::rankBatch(ordinals.data(), n, count, parallelRanks.data(), pool, 100);
+		
+		for (std::size_t k = 0; k < count; k++)
+		{
+			TS_ASSERT_EQUALS(count - 1 - k, ranks[k]);
+		}
+		
+		TS_ASSERT_EQUALS(ranks, parallelRanks);
+	}
+}
+
+class UnitTest_RestrictedGrowthString: public CxxTest::TestSuite
+{
+	/**
+	 * Bell numbers.
+	 */
+	public: void test_getPartitionCount()
+	{
+		TS_ASSERT_EQUALS(1ULL, RestrictedGrowthString(0).getPartitionCount());
+		TS_ASSERT_EQUALS(1ULL, RestrictedGrowthString(1).getPartitionCount());
+		TS_ASSERT_EQUALS(5ULL, RestrictedGrowthString(3).getPartitionCount());
+		TS_ASSERT_EQUALS(115975ULL, RestrictedGrowthString(10).getPartitionCount());
+		TS_ASSERT_EQUALS(4638590332229999353ULL, RestrictedGrowthString(25).getPartitionCount());
+	}
+	
+	public: void test_order()
+	{
+		int expected[][3] = {{1, 1, 1}, {1, 1, 2}, {1, 2, 1}, {1, 2, 2}, {1, 2, 3}};
+		RestrictedGrowthString rgs(3);
+		int blocks[3] = {1, 1, 1};
+		
+		for (int i = 0; i < 5; i++)
+		{
+			TS_ASSERT(std::equal(blocks, blocks + 3, expected[i]));
+			TS_ASSERT_EQUALS((unsigned long long) i, rgs.rank(blocks));
+			TS_ASSERT_EQUALS(i < 4, RestrictedGrowthString::next(blocks, 3));
+		}
+	}
+	
+	public: void test_rank_unrank()
+	{
+		const int n = 8;
+		RestrictedGrowthString rgs(n);
+		vector <int> expected(n, 1), actual(n);
+		
+		for (unsigned long long index = 0; index < rgs.getPartitionCount(); index++)
+		{
+			rgs.unrank(index, actual.data());
+			TS_ASSERT_EQUALS(expected, actual);
+			TS_ASSERT_EQUALS(index, rgs.rank(actual.data()));
+			
+			RestrictedGrowthString::next(expected.data(), n);
+		}
+	}
+}
+
+
+}
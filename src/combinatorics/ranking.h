@@ -0,0 +1,409 @@
+#ifndef EUGENEJONAS__CPP_STUFF__COMBINATORICS__RANKING_H
+#define EUGENEJONAS__CPP_STUFF__COMBINATORICS__RANKING_H
+
+
+#include <eugenejonas/cpp_stuff/arithm/big_int.h>
+#include <eugenejonas/cpp_stuff/fenwick_tree.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Ranking and unranking of permutations in lexicographical order by
+ * means of the Lehmer code. Permutations are given as arrays of ordinal
+ * numbers of their elements (0..n-1).
+ *
+ * Lehmer code of permutation p is sequence c, where c[i] is the number of
+ * indexes j > i such that p[j] < p[i]. Lexicographical index of p is
+ * c[0] * (n - 1)! + c[1] * (n - 2)! + ... + c[n - 1] * 0!.
+ *
+ * Equivalently, c[i] is the number of ordinals less than p[i] which are
+ * not used by p[0..i). For n <= 20 the used ordinals are kept in a bit mask
+ * and counted by popcount; for larger n (with BigInt indexes) they are kept
+ * in a Fenwick tree.
+ */
+class LehmerCode
+{
+	/**
+	 * Returns n!, the number of n-permutations.
+	 *
+	 * @param n 20 >= n >= 0 (21! doesn't fit into 64 bits).
+	 */
+	public: static unsigned long long getPermutationCount(int n)
+	{
+		assert(n >= 0 && n <= 20);
+
+		unsigned long long res = 1;
+
+		for (int i = 2; i <= n; i++)
+		{
+			res *= i;
+		}
+
+		return res;
+	}
+
+	/**
+	 * Returns lexicographical index of the permutation.
+	 *
+	 * @param ordinals Ordinal numbers of the elements, ordinals[0..n).
+	 * @param n 20 >= n >= 0.
+	 * @time O(n)
+	 */
+	public: template <typename TPL_T> static unsigned long long rank(const TPL_T *ordinals, int n)
+	{
+		assert(n >= 0 && n <= 20);
+
+		unsigned long long res = 0;
+		std::uint32_t used = 0;
+
+		for (int i = 0; i < n; i++)
+		{
+			std::uint32_t bit = 1u << ordinals[i];
+			assert((used & bit) == 0);
+
+			int code = (int) ordinals[i] - std::popcount(used & (bit - 1));
+			used |= bit;
+
+			res = res * (n - i) + code;
+		}
+
+		return res;
+	}
+
+	/**
+	 * Calculates permutation with the given lexicographical index.
+	 *
+	 * @param n 20 >= n >= 0.
+	 * @param index 0 <= index < n!
+	 * @param ordinals Output array of length n, receives ordinal numbers of the elements.
+	 * @time O(n ^ 2) bit operations
+	 */
+	public: template <typename TPL_T> static void unrank(int n, unsigned long long index, TPL_T *ordinals)
+	{
+		assert(index < LehmerCode::getPermutationCount(n));
+
+		// compute Lehmer code digits from the least significant one
+
+		for (int i = n - 1; i >= 0; i--)
+		{
+			ordinals[i] = (TPL_T) (index % (n - i));
+			index /= (n - i);
+		}
+
+		// replace every digit with the corresponding unused ordinal number
+
+		std::uint32_t unused = (1u << n) - 1;
+
+		for (int i = 0; i < n; i++)
+		{
+			std::uint32_t mask = unused;
+
+			for (int code = (int) ordinals[i]; code > 0; code--)
+			{
+				mask &= mask - 1;
+			}
+
+			ordinals[i] = (TPL_T) std::countr_zero(mask);
+			unused &= ~(mask & (~mask + 1));
+		}
+	}
+
+	/**
+	 * Returns lexicographical index of the permutation of any length.
+	 *
+	 * @param TPL_Index Type of the index, e.g. BigInt (n! overflows
+	 *		64 bits for n > 20). Must support * and + with long.
+	 * @param ordinals Ordinal numbers of the elements, ordinals[0..n).
+	 * @time O(n * log(n)) arithmetic operations
+	 */
+	public: template <typename TPL_Index, typename TPL_T> static TPL_Index rankLarge(const TPL_T *ordinals, int n)
+	{
+		assert(n >= 0);
+
+		TPL_Index res(0);
+		FenwickTree <int> used(n);
+
+		for (int i = 0; i < n; i++)
+		{
+			assert(ordinals[i] >= 0 && ordinals[i] < n);
+
+			int code = (int) ordinals[i] - used.getPrefixSum(ordinals[i]);
+			used.add(ordinals[i], 1);
+
+			res *= (long) (n - i);
+			res += (long) code;
+		}
+
+		return res;
+	}
+
+	/**
+	 * Calculates permutation of any length with the given lexicographical index.
+	 *
+	 * @param TPL_Index Type of the index, e.g. BigInt.
+	 * @param index 0 <= index < n!
+	 * @param ordinals Output array of length n, receives ordinal numbers of the elements.
+	 * @time O(n * log(n)) arithmetic operations
+	 */
+	public: template <typename TPL_Index, typename TPL_T> static void unrankLarge(int n, TPL_Index index, TPL_T *ordinals)
+	{
+		assert(n >= 0);
+
+		for (int i = n - 1; i >= 0; i--)
+		{
+			ordinals[i] = (TPL_T) LehmerCode::takeDigit(index, n - i);
+		}
+
+		assert(index == 0);
+
+		// unused[k] == 1 if ordinal k is not used yet; select the code-th unused one
+
+		std::vector <int> ones(n, 1);
+		FenwickTree <int> unused(ones.begin(), ones.end());
+
+		for (int i = 0; i < n; i++)
+		{
+			std::size_t ordinal = unused.getUpperBound((int) ordinals[i]);
+			unused.add(ordinal, -1);
+			ordinals[i] = (TPL_T) ordinal;
+		}
+	}
+
+	/**
+	 * Ranks count permutations of length n stored contiguously:
+	 * permutation k occupies ordinals[k * n .. (k + 1) * n).
+	 *
+	 * @param n 20 >= n >= 0.
+	 * @param ranks Output array of length count.
+	 * @time O(count * n)
+	 */
+	public: template <typename TPL_T> static void rankBatch(const TPL_T *ordinals, int n, std::size_t count, unsigned long long *ranks)
+	{
+		for (std::size_t k = 0; k < count; k++)
+		{
+			ranks[k] = LehmerCode::rank(ordinals + k * n, n);
+		}
+	}
+
+	/**
+	 * Parallel version of rankBatch(). The permutations are split into
+	 * chunks of grainSize, which are ranked by the tasks of the pool.
+	 */
+	public: template <typename TPL_T> static void rankBatch(
+			const TPL_T *ordinals,
+			int n,
+			std::size_t count,
+			unsigned long long *ranks,
+			ThreadPool &pool,
+			std::size_t grainSize = 1 << 16
+	)
+	{
+		assert(grainSize > 0);
+
+		TaskGroup group(pool);
+
+		for (std::size_t first = 0; first < count; first += grainSize)
+		{
+			std::size_t chunkSize = std::min(grainSize, count - first);
+
+			group.run([ordinals, n, first, chunkSize, ranks]()
+			{
+				LehmerCode::rankBatch(ordinals + first * n, n, chunkSize, ranks + first);
+			});
+		}
+
+		group.wait();
+	}
+
+	/**
+	 * Divides index by base.
+	 *
+	 * @return The remainder.
+	 */
+	private: static int takeDigit(unsigned long long &index, int base)
+	{
+		int res = (int) (index % base);
+		index /= base;
+		return res;
+	}
+
+	private: static int takeDigit(BigInt &index, int base)
+	{
+		int res = (int) (index % (long) base).toLong();
+		index /= (long) base;
+		return res;
+	}
+}
+
+/**
+ * Ranking and unranking of set partitions in lexicographical order of their
+ * restricted growth strings. Partition of set [n] is given as array
+ * blocks[0..n), where blocks[k] is the block in which element <k + 1> is
+ * placed, and blocks are enumerated in the order of their smallest elements,
+ * starting from 1 (this is how SetPartitionGenerator represents partitions).
+ * Such array is a restricted growth string:
+ * blocks[0] == 1, blocks[k] <= 1 + max(blocks[0], ..., blocks[k - 1]).
+ */
+class RestrictedGrowthString
+{
+	/**
+	 * completionCounts[i * (n + 1) + m] is the number of ways to fill
+	 * positions [i; n) if the maximum of positions [0; i) is m.
+	 */
+	private: std::vector <unsigned long long> completionCounts;
+
+	private: int n;
+
+
+	/**
+	 * Prepares the table for partitions of set [n].
+	 *
+	 * @param n 25 >= n >= 0 (Bell number B(26) doesn't fit into 64 bits).
+	 * @time O(n ^ 2)
+	 */
+	public: RestrictedGrowthString(int n):
+			completionCounts((n + 1) * (n + 1)),
+			n(n)
+	{
+		assert(n >= 0 && n <= 25);
+
+		for (int m = 0; m <= n; m++)
+		{
+			this->completionCounts[n * (n + 1) + m] = 1;
+		}
+
+		for (int i = n - 1; i >= 0; i--)
+		{
+			for (int m = 0; m <= i; m++)
+			{
+				// put element into one of m existing blocks or into a new block
+				this->completionCounts[i * (n + 1) + m] =
+						m * this->completionCounts[(i + 1) * (n + 1) + m]
+						+ this->completionCounts[(i + 1) * (n + 1) + m + 1];
+			}
+		}
+	}
+
+	/**
+	 * Returns Bell number B(n), the number of partitions of set [n].
+	 */
+	public: unsigned long long getPartitionCount() const
+	{
+		return this->completionCounts[0];
+	}
+
+	/**
+	 * Returns lexicographical index of the partition.
+	 *
+	 * @time O(n)
+	 */
+	public: unsigned long long rank(const int *blocks) const
+	{
+		unsigned long long res = 0;
+		int max = 0;
+
+		for (int i = 0; i < this->n; i++)
+		{
+			assert(blocks[i] >= 1 && blocks[i] <= max + 1);
+
+			// partitions with a smaller block at position i come first
+			res += (blocks[i] - 1) * this->completionCounts[(i + 1) * (this->n + 1) + max];
+
+			if (blocks[i] > max)
+			{
+				max = blocks[i];
+			}
+		}
+
+		return res;
+	}
+
+	/**
+	 * Calculates partition with the given lexicographical index.
+	 *
+	 * @param index 0 <= index < getPartitionCount().
+	 * @param blocks Output array of length n.
+	 * @time O(n)
+	 */
+	public: void unrank(unsigned long long index, int *blocks) const
+	{
+		assert(index < this->getPartitionCount());
+
+		int max = 0;
+
+		for (int i = 0; i < this->n; i++)
+		{
+			// number of partitions for every choice of an existing block
+			unsigned long long count = this->completionCounts[(i + 1) * (this->n + 1) + max];
+
+			if (index < max * count)
+			{
+				blocks[i] = (int) (index / count) + 1;
+				index %= count;
+			}
+			else
+			{
+				// new block
+				index -= max * count;
+				blocks[i] = ++max;
+			}
+		}
+	}
+
+	/**
+	 * Generates the next partition in lexicographical order.
+	 *
+	 * @return false if the next partition does not exist (blocks are not changed), true otherwise.
+	 * @time O(n)
+	 */
+	public: static bool next(int *blocks, int n)
+	{
+		// find the last position which doesn't open a new block;
+		// its block can be incremented without breaking the restricted growth
+
+		int max = 0, last = -1;
+
+		for (int i = 0; i < n; i++)
+		{
+			if (blocks[i] <= max)
+			{
+				last = i;
+			}
+			else
+			{
+				max = blocks[i];
+			}
+		}
+
+		if (last >= 0)
+		{
+			blocks[last]++;
+
+			for (int j = last + 1; j < n; j++)
+			{
+				blocks[j] = 1;
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+}
+
+
+}
+
+
+#endif
@@ -44,7 +44,7 @@ template <typename TPL_Consumer_T> class Consumer
  */
 template <typename TPL_Counter_T> class Counter: public Consumer <TPL_Counter_T>
 {
-	private: int count;
+	private: long long count;
 
 
 	public: Counter()
@@ -67,10 +67,19 @@ template <typename TPL_Counter_T> class Counter: public Consumer <TPL_Counter_T>
 		//nothing
 	}
 
-	public: int getCount()
+	public: long long getCount()
 	{
 		return this->count;
 	}
+
+	/**
+	 * Adds elements counted by another counter (used to combine results
+	 * of the counters working on disjoint parts of a sequence).
+	 */
+	public: void merge(Counter <TPL_Counter_T> const &other)
+	{
+		this->count += other.count;
+	}
 }
 
 #ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
@@ -198,6 +207,15 @@ class Collector: public Consumer <TPL_Collector_T>
 	{
 		return this->vector;
 	}
+
+	/**
+	 * Appends elements collected by another collector (used to combine results
+	 * of the collectors working on consecutive parts of a sequence).
+	 */
+	public: void merge(Collector <TPL_Collector_T> const &other)
+	{
+		this->vector.insert(this->vector.end(), other.vector.begin(), other.vector.end());
+	}
 }
 
 
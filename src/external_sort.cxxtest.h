@@ -0,0 +1,143 @@
+#include <eugenejonas/cpp_stuff/external_sort.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::vector;
+
+
+class UnitTest_ExternalSorter: public CxxTest::TestSuite
+{
+	private: struct Record
+	{
+		public: std::uint32_t key;
+		public: std::uint32_t index;
+	}
+
+	private: struct CompareKeys
+	{
+		public: bool operator()(Record const &a, Record const &b) const
+		{
+			return a.key < b.key;
+		}
+	}
+
+
+	private: static vector <Record> createRecords(std::size_t n, std::uint32_t keyCount)
+	{
+		vector <Record> res(n);
+		std::srand(1);
+
+		for (std::size_t i = 0; i < n; i++)
+		{
+			res[i].key = std::rand() % keyCount;
+			res[i].index = (std::uint32_t) i;
+		}
+
+		return res;
+	}
+
+	/**
+	 * Reads the output back and checks that it is the stably sorted input.
+	 */
+	private: static void checkOutput(vector <Record> const &records, std::FILE *output)
+	{
+		vector <Record> expected = records;
+		std::stable_sort(expected.begin(), expected.end(), CompareKeys());
+
+		std::rewind(output);
+		vector <Record> sorted(records.size() + 1);
+		TS_ASSERT_EQUALS(records.size(), std::fread(sorted.data(), sizeof(Record), sorted.size(), output));
+
+		for (std::size_t i = 0; i < records.size(); i++)
+		{
+			TS_ASSERT_EQUALS(expected[i].key, sorted[i].key);
+			TS_ASSERT_EQUALS(expected[i].index, sorted[i].index);
+		}
+	}
+
+	/**
+	 * The memory holds 1024 records: runs of 341 records are merged with
+	 * blocks of a few records.
+	 */
+	public: void test_from_memory()
+	{
+		ThreadPool pool(2);
+		vector <Record> records = createRecords(20000, 1000);
+		std::FILE *output = std::tmpfile();
+
+		ExternalSorter <Record, CompareKeys> (1024 * sizeof(Record), pool).sort(records.data(), records.data() + records.size(), output);
+
+		checkOutput(records, output);
+		std::fclose(output);
+	}
+
+	public: void test_from_file()
+	{
+		ThreadPool pool(2);
+		vector <Record> records = createRecords(5000, 50);
+		std::FILE *input = std::tmpfile(), *output = std::tmpfile();
+
+		std::fwrite(records.data(), sizeof(Record), records.size(), input);
+		std::rewind(input);
+
+		ExternalSorter <Record, CompareKeys> (4096 * sizeof(Record), pool).sort(input, output);
+
+		checkOutput(records, output);
+		std::fclose(input);
+		std::fclose(output);
+	}
+
+	/**
+	 * With little memory, there are more runs than can be merged at once.
+	 */
+	public: void test_several_merge_passes()
+	{
+		ThreadPool pool(2);
+		vector <Record> records = createRecords(3000, 100000);
+		std::FILE *output = std::tmpfile();
+
+		ExternalSorter <Record, CompareKeys> (48, pool).sort(records.data(), records.data() + records.size(), output);
+
+		checkOutput(records, output);
+		std::fclose(output);
+	}
+
+	public: void test_empty_input()
+	{
+		ThreadPool pool(1);
+		vector <Record> records;
+		std::FILE *output = std::tmpfile();
+
+		ExternalSorter <Record, CompareKeys> (1024, pool).sort(records.data(), records.data(), output);
+
+		checkOutput(records, output);
+		std::fclose(output);
+	}
+
+	public: void test_failed_temporary_file()
+	{
+		ThreadPool pool(1);
+		vector <Record> records = createRecords(100, 10);
+		std::FILE *output = std::tmpfile();
+		typedef ExternalSorter <Record, CompareKeys> Sorter;
+		Sorter sorter(1024, pool, CompareKeys(), []() { return (std::FILE *) nullptr; });
+
+		TS_ASSERT_THROWS(sorter.sort(records.data(), records.data() + records.size(), output), Sorter::IoException);
+		std::fclose(output);
+	}
+}
+
+
+}
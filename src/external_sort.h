@@ -0,0 +1,473 @@
+#ifndef EUGENEJONAS__CPP_STUFF__EXTERNAL_SORT_H
+#define EUGENEJONAS__CPP_STUFF__EXTERNAL_SORT_H
+
+
+#include <eugenejonas/cpp_stuff/error_handling.h>
+#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
+#include <eugenejonas/cpp_stuff/sort.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * External merge sort of fixed-size binary records which don't fit into
+ * memory. The sort is stable.
+ *
+ * 1. Run formation: the input is read in chunks of about a third of the
+ *    memory budget, every chunk is sorted by Sorter::parallelMergeSort() and
+ *    written to a temporary file. Writing of a run overlaps with reading
+ *    and sorting of the next chunk.
+ * 2. Merging: runs are merged by a LoserTree. Every run is read in blocks
+ *    with two buffers: while records of one block are merged, the next
+ *    block is read by a task of the thread pool; the output is written the
+ *    same way. If there are too many runs for blocks of at least
+ *    MIN_BLOCK_SIZE bytes, groups of runs are merged into longer runs first.
+ *
+ * Temporary files are created by std::tmpfile() unless another function is
+ * given; they need as much space as the input (twice as much while runs are
+ * merged in several passes).
+ *
+ * @param TPL_ExternalSorter_Record Type of the records, which are read and
+ *		written byte by byte, so it must be trivially copyable.
+ */
+template <typename TPL_ExternalSorter_Record, class TPL_ExternalSorter_StrictWeakOrdering = std::less <TPL_ExternalSorter_Record> >
+class ExternalSorter
+{
+	static_assert(std::is_trivially_copyable <TPL_ExternalSorter_Record> ::value, "records are stored in files byte by byte");
+
+
+	private: typedef TPL_ExternalSorter_Record value_type;
+
+
+	/**
+	 * Exception that is thrown if a file can't be created, read or written.
+	 */
+	public: class IoException: public ExpectedException
+	{
+		//nothing
+	}
+
+
+	/**
+	 * Blocks of runs which are merged are not made smaller than this
+	 * many bytes, to keep reads sequential.
+	 */
+	private: static const std::size_t MIN_BLOCK_SIZE = 1 << 16;
+
+
+	/**
+	 * Consumes records of a run block by block, reading the next block
+	 * asynchronously.
+	 */
+	private: class RunReader
+	{
+		private: std::FILE *file;
+		private: std::vector <value_type> blocks[2];
+		private: std::size_t sizes[2];
+		private: int current;
+		private: std::size_t position;
+		private: std::atomic <bool> &isFailed;
+		private: TaskGroup prefetch;
+
+
+		public: RunReader(std::FILE *file, std::size_t blockSize, ThreadPool &pool, std::atomic <bool> &isFailed):
+				file(file),
+				current(0),
+				position(0),
+				isFailed(isFailed),
+				prefetch(pool)
+		{
+			this->blocks[0].resize(blockSize);
+			this->blocks[1].resize(blockSize);
+			this->sizes[1] = 0;
+
+			this->read(0);
+
+			if (this->sizes[0] == blockSize)
+			{
+				this->startPrefetch();
+			}
+		}
+
+		public: bool isEmpty() const
+		{
+			return this->position == this->sizes[this->current];
+		}
+
+		public: value_type const &peek() const
+		{
+			assert(!this->isEmpty());
+			return this->blocks[this->current][this->position];
+		}
+
+		/**
+		 * Advances to the next record.
+		 */
+		public: void next()
+		{
+			assert(!this->isEmpty());
+			this->position++;
+
+			// a short block is the last one
+			if (this->position == this->sizes[this->current] && this->sizes[this->current] == this->blocks[0].size())
+			{
+				this->prefetch.wait();
+				this->current = 1 - this->current;
+				this->position = 0;
+
+				if (this->sizes[this->current] == this->blocks[0].size())
+				{
+					this->startPrefetch();
+				}
+			}
+		}
+
+		private: void startPrefetch()
+		{
+			int block = 1 - this->current;
+
+			this->prefetch.run([this, block]()
+			{
+				this->read(block);
+			});
+		}
+
+		private: void read(int block)
+		{
+			this->sizes[block] = std::fread(this->blocks[block].data(), sizeof(value_type), this->blocks[block].size(), this->file);
+
+			if (std::ferror(this->file))
+			{
+				this->isFailed = true;
+			}
+		}
+	}
+
+	/**
+	 * Collects records into blocks and writes every full block
+	 * asynchronously while the other block is being filled.
+	 */
+	private: class RunWriter
+	{
+		private: std::FILE *file;
+		private: std::vector <value_type> blocks[2];
+		private: int current;
+		private: std::size_t size;
+		private: std::atomic <bool> &isFailed;
+		private: TaskGroup writes;
+
+
+		public: RunWriter(std::FILE *file, std::size_t blockSize, ThreadPool &pool, std::atomic <bool> &isFailed):
+				file(file),
+				current(0),
+				size(0),
+				isFailed(isFailed),
+				writes(pool)
+		{
+			this->blocks[0].resize(blockSize);
+			this->blocks[1].resize(blockSize);
+		}
+
+		public: void put(value_type const &record)
+		{
+			this->blocks[this->current][this->size++] = record;
+
+			if (this->size == this->blocks[0].size())
+			{
+				this->flushBlock();
+			}
+		}
+
+		/**
+		 * Writes the records which are left and waits for all writes.
+		 */
+		public: void finish()
+		{
+			if (this->size > 0)
+			{
+				this->flushBlock();
+			}
+
+			this->writes.wait();
+
+			if (std::fflush(this->file) != 0)
+			{
+				this->isFailed = true;
+			}
+		}
+
+		private: void flushBlock()
+		{
+			// the other block must be written before it's filled again
+			this->writes.wait();
+
+			const value_type *data = this->blocks[this->current].data();
+			std::size_t size = this->size;
+
+			this->writes.run([this, data, size]()
+			{
+				if (std::fwrite(data, sizeof(value_type), size, this->file) != size)
+				{
+					this->isFailed = true;
+				}
+			});
+
+			this->current = 1 - this->current;
+			this->size = 0;
+		}
+	}
+
+
+	private: std::size_t memorySize;
+	private: ThreadPool &pool;
+	private: TPL_ExternalSorter_StrictWeakOrdering swoCompare;
+	private: std::function <std::FILE *()> createTemporaryFile;
+
+
+	/**
+	 * @param memorySize Number of bytes of memory the sorter may use for
+	 *		records (a little more is used for bookkeeping).
+	 * @param createTemporaryFile Returns a new file opened for update in
+	 *		binary mode, which is deleted when closed, or nullptr on failure.
+	 */
+	public: ExternalSorter(
+			std::size_t memorySize,
+			ThreadPool &pool,
+			TPL_ExternalSorter_StrictWeakOrdering swoCompare = TPL_ExternalSorter_StrictWeakOrdering(),
+			std::function <std::FILE *()> createTemporaryFile = []() { return std::tmpfile(); }
+	):
+			memorySize(memorySize),
+			pool(pool),
+			swoCompare(swoCompare),
+			createTemporaryFile(createTemporaryFile)
+	{
+		assert(memorySize >= 4 * sizeof(value_type));
+	}
+
+	/**
+	 * Sorts the records of input (from the current position to the end)
+	 * and writes them to output.
+	 *
+	 * @throws IoException If reading or writing fails.
+	 */
+	public: void sort(std::FILE *input, std::FILE *output)
+	{
+		this->sort([input](value_type *buffer, std::size_t count) -> std::size_t
+		{
+			std::size_t res = std::fread(buffer, sizeof(value_type), count, input);
+
+			if (std::ferror(input))
+			{
+				throw IoException();
+			}
+
+			return res;
+		}, output);
+	}
+
+	/**
+	 * Sorts records [first; last), e.g. a memory-mapped file, and writes
+	 * them to output. The records are not modified.
+	 *
+	 * @throws IoException If writing fails.
+	 */
+	public: void sort(const value_type *first, const value_type *last, std::FILE *output)
+	{
+		this->sort([&first, last](value_type *buffer, std::size_t count) -> std::size_t
+		{
+			std::size_t res = std::min(count, (std::size_t) (last - first));
+			std::copy(first, first + res, buffer);
+			first += res;
+			return res;
+		}, output);
+	}
+
+	/**
+	 * @param read Function which reads at most count records into buffer
+	 *		and returns their number, 0 at the end.
+	 */
+	private: void sort(std::function <std::size_t(value_type *buffer, std::size_t count)> read, std::FILE *output)
+	{
+		std::vector <std::FILE *> runs, longerRuns;
+
+		try
+		{
+			this->createRuns(read, runs);
+
+			std::size_t blockBytes = std::max((std::size_t) ExternalSorter::MIN_BLOCK_SIZE, sizeof(value_type));
+			std::size_t maxFanIn = std::max(this->memorySize / (2 * blockBytes), (std::size_t) 3) - 1;
+
+			while (runs.size() > maxFanIn)
+			{
+				// merge groups of runs into longer runs
+
+				for (std::size_t i = 0; i < runs.size(); i += maxFanIn)
+				{
+					std::vector <std::FILE *> group(runs.begin() + i, runs.begin() + std::min(i + maxFanIn, runs.size()));
+					std::FILE *run = this->createRun();
+					longerRuns.push_back(run);
+
+					this->merge(group, run);
+					std::rewind(run);
+				}
+
+				ExternalSorter::closeRuns(runs);
+				runs.swap(longerRuns);
+			}
+
+			this->merge(runs, output);
+		}
+		catch (...)
+		{
+			ExternalSorter::closeRuns(runs);
+			ExternalSorter::closeRuns(longerRuns);
+			throw;
+		}
+
+		ExternalSorter::closeRuns(runs);
+	}
+
+	/**
+	 * Reads the input in chunks, sorts them and writes them to new
+	 * temporary files, which are added to runs and rewound.
+	 */
+	private: void createRuns(std::function <std::size_t(value_type *buffer, std::size_t count)> &read, std::vector <std::FILE *> &runs)
+	{
+		// two chunks, one being sorted and one being written, and the scratch buffer of the sort
+		std::size_t chunkSize = std::max(this->memorySize / (3 * sizeof(value_type)), (std::size_t) 1);
+		std::vector <value_type> chunks[2] = {std::vector <value_type> (chunkSize), std::vector <value_type> (chunkSize)};
+		std::atomic <bool> isFailed(false);
+		TaskGroup writes(this->pool);
+
+		for (int current = 0; ; current = 1 - current)
+		{
+			value_type *data = chunks[current].data();
+			std::size_t size = read(data, chunkSize);
+
+			if (size == 0)
+			{
+				break;
+			}
+
+			Sorter <value_type *, TPL_ExternalSorter_StrictWeakOrdering> (data, data + size, this->swoCompare).parallelMergeSort(this->pool);
+
+			// the previous run must be written before its chunk is read into
+			writes.wait();
+
+			std::FILE *run = this->createRun();
+			runs.push_back(run);
+
+			writes.run([run, data, size, &isFailed]()
+			{
+				if (std::fwrite(data, sizeof(value_type), size, run) != size || std::fflush(run) != 0)
+				{
+					isFailed = true;
+				}
+			});
+		}
+
+		writes.wait();
+
+		if (isFailed)
+		{
+			throw IoException();
+		}
+
+		for (std::FILE *run : runs)
+		{
+			std::rewind(run);
+		}
+	}
+
+	/**
+	 * Merges runs into output.
+	 */
+	private: void merge(std::vector <std::FILE *> const &runs, std::FILE *output)
+	{
+		// two blocks for every run and for the output
+		std::size_t blockSize = std::max(this->memorySize / (2 * (runs.size() + 1) * sizeof(value_type)), (std::size_t) 1);
+		std::atomic <bool> isFailed(false);
+
+		{
+			std::vector <std::unique_ptr <RunReader> > readers;
+			LoserTree <value_type, TPL_ExternalSorter_StrictWeakOrdering> tree(std::max(runs.size(), (std::size_t) 1), this->swoCompare);
+			RunWriter writer(output, blockSize, this->pool, isFailed);
+
+			for (std::size_t i = 0; i < runs.size(); i++)
+			{
+				readers.push_back(std::make_unique <RunReader> (runs[i], blockSize, this->pool, isFailed));
+
+				if (!readers[i]->isEmpty())
+				{
+					tree.set(i, readers[i]->peek());
+				}
+			}
+
+			tree.build();
+
+			while (!tree.isEmpty())
+			{
+				std::size_t i = tree.getWinner();
+				writer.put(tree.peek());
+				readers[i]->next();
+
+				if (readers[i]->isEmpty())
+				{
+					tree.removeWinner();
+				}
+				else
+				{
+					tree.replaceWinner(readers[i]->peek());
+				}
+			}
+
+			writer.finish();
+		}
+
+		if (isFailed)
+		{
+			throw IoException();
+		}
+	}
+
+	private: std::FILE *createRun()
+	{
+		std::FILE *res = this->createTemporaryFile();
+
+		if (res == nullptr)
+		{
+			throw IoException();
+		}
+
+		return res;
+	}
+
+	private: static void closeRuns(std::vector <std::FILE *> &runs)
+	{
+		for (std::FILE *run : runs)
+		{
+			std::fclose(run);
+		}
+
+		runs.clear();
+	}
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,85 @@
+#include <eugenejonas/cpp_stuff/fenwick_tree.h>
+
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::vector;
+
+
+class UnitTest_FenwickTree: public CxxTest::TestSuite
+{
+	public: void test_add_and_prefix_sums()
+	{
+		FenwickTree <int> tree(10);
+		vector <int> a(10, 0);
+		
+		for (int i = 0; i < 10; i++)
+		{
+			tree.add(i, i * i - 7);
+			a[i] += i * i - 7;
+			tree.add((i * 3) % 10, 2);
+			a[(i * 3) % 10] += 2;
+		}
+		
+		int sum = 0;
+		
+		for (int i = 0; i <= 10; i++)
+		{
+			TS_ASSERT_EQUALS(sum, tree.getPrefixSum(i));
+			
+			if (i < 10)
+			{
+				sum += a[i];
+			}
+		}
+		
+		TS_ASSERT_EQUALS(a[3] + a[4] + a[5], tree.getSum(3, 6));
+		TS_ASSERT_EQUALS(0, tree.getSum(4, 4));
+	}
+	
+	public: void test_linear_construction()
+	{
+		int a[] = {5, -2, 7, 1, 0, 3, 3, 9, -4, 6, 2};
+		const int n = sizeof(a) / sizeof(a[0]);
+		FenwickTree <int> tree(a, a + n);
+		
+		TS_ASSERT_EQUALS((std::size_t) n, tree.getSize());
+		
+		int sum = 0;
+		
+		for (int i = 0; i < n; i++)
+		{
+			TS_ASSERT_EQUALS(sum, tree.getPrefixSum(i));
+			sum += a[i];
+		}
+		
+		TS_ASSERT_EQUALS(sum, tree.getPrefixSum(n));
+		
+		tree.clear();
+		
+		TS_ASSERT_EQUALS(0, tree.getPrefixSum(n));
+	}
+	
+	public: void test_getUpperBound()
+	{
+		int a[] = {1, 0, 2, 0, 0, 3, 1};
+		FenwickTree <int> tree(a, a + sizeof(a) / sizeof(a[0]));
+		
+		// prefix sums are 1, 1, 3, 3, 3, 6, 7
+		std::size_t expected[] = {0, 2, 2, 5, 5, 5, 6, 7, 7};
+		
+		for (int sum = 0; sum <= 8; sum++)
+		{
+			TS_ASSERT_EQUALS(expected[sum], tree.getUpperBound(sum));
+		}
+	}
+}
+
+
+}
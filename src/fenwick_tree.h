@@ -0,0 +1,157 @@
+#ifndef EUGENEJONAS__CPP_STUFF__FENWICK_TREE_H
+#define EUGENEJONAS__CPP_STUFF__FENWICK_TREE_H
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Fenwick tree (binary indexed tree) over array a[0..n). It supports adding
+ * a value to an element and calculating sum of a prefix a[0..i) in O(log n) time.
+ *
+ * @param TPL_FenwickTree_T Type of the elements. Must support +, - and
+ *		construction from 0.
+ */
+template <typename TPL_FenwickTree_T = long long> class FenwickTree
+{
+	/**
+	 * tree[i - 1] is the sum of elements a[i - lowbit(i) .. i), where lowbit(i)
+	 * is the lowest set bit of i (1-based indexing of the classic description).
+	 */
+	private: std::vector <TPL_FenwickTree_T> tree;
+
+
+	/**
+	 * Creates tree over n zero elements.
+	 */
+	public: FenwickTree(std::size_t n = 0):
+			tree(n, TPL_FenwickTree_T(0))
+	{
+		//nothing
+	}
+
+	/**
+	 * Creates tree over elements [first; last).
+	 *
+	 * @time O(n)
+	 */
+	public: template <typename TPL_InputIterator> FenwickTree(TPL_InputIterator first, TPL_InputIterator last):
+			tree(first, last)
+	{
+		for (std::size_t i = 1; i <= this->tree.size(); i++)
+		{
+			std::size_t parent = i + FenwickTree::getLowBit(i);
+
+			if (parent <= this->tree.size())
+			{
+				this->tree[parent - 1] = this->tree[parent - 1] + this->tree[i - 1];
+			}
+		}
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->tree.size();
+	}
+
+	/**
+	 * Sets all elements to 0.
+	 */
+	public: void clear()
+	{
+		std::fill(this->tree.begin(), this->tree.end(), TPL_FenwickTree_T(0));
+	}
+
+	/**
+	 * Adds delta to element a[i].
+	 *
+	 * @time O(log n)
+	 */
+	public: void add(std::size_t i, TPL_FenwickTree_T const &delta)
+	{
+		assert(i < this->tree.size());
+
+		for (i++; i <= this->tree.size(); i += FenwickTree::getLowBit(i))
+		{
+			this->tree[i - 1] = this->tree[i - 1] + delta;
+		}
+	}
+
+	/**
+	 * Returns a[0] + a[1] + ... + a[i - 1].
+	 *
+	 * @param i 0 <= i <= n.
+	 * @time O(log n)
+	 */
+	public: TPL_FenwickTree_T getPrefixSum(std::size_t i) const
+	{
+		assert(i <= this->tree.size());
+
+		TPL_FenwickTree_T res(0);
+
+		for ( ; i > 0; i -= FenwickTree::getLowBit(i))
+		{
+			res = res + this->tree[i - 1];
+		}
+
+		return res;
+	}
+
+	/**
+	 * Returns a[i] + a[i + 1] + ... + a[j - 1].
+	 */
+	public: TPL_FenwickTree_T getSum(std::size_t i, std::size_t j) const
+	{
+		assert(i <= j);
+		return this->getPrefixSum(j) - this->getPrefixSum(i);
+	}
+
+	/**
+	 * Returns the smallest i such that a[0] + a[1] + ... + a[i] > sum,
+	 * or n if there is no such i. With elements 0 and 1 this selects
+	 * the (sum + 1)-th element which is 1.
+	 *
+	 * @pre All elements are non-negative.
+	 * @time O(log n)
+	 */
+	public: std::size_t getUpperBound(TPL_FenwickTree_T sum) const
+	{
+		std::size_t pos = 0, step = 1;
+
+		while (step * 2 <= this->tree.size())
+		{
+			step *= 2;
+		}
+
+		// descend the implicit tree, keeping sum of a[0..pos) <= the original sum
+
+		for ( ; step > 0; step /= 2)
+		{
+			if (pos + step <= this->tree.size() && !(sum < this->tree[pos + step - 1]))
+			{
+				pos += step;
+				sum = sum - this->tree[pos - 1];
+			}
+		}
+
+		return pos;
+	}
+
+	private: static std::size_t getLowBit(std::size_t i)
+	{
+		return i & (~i + 1);
+	}
+}
+
+
+}
+
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <vector>
 
 #ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
@@ -116,6 +117,32 @@ struct StrictTotalIntegerOrdering
 	}
 }
 
+/**
+ * Natural ordering of indexes 0, 1, 2, ... in which every element is its own
+ * ordinal number. Permutation <std::uint32_t, DenseIndexOrdering> is specialized
+ * to use this (see DensePermutation).
+ */
+struct DenseIndexOrdering
+{
+	/**
+	 * Compares two elements.
+	 */
+	public: bool operator()(std::uint32_t a, std::uint32_t b) const
+	{
+		return a < b;
+	}
+
+	public: std::uint32_t getOrdinalNumber(std::uint32_t element) const
+	{
+		return element;
+	}
+
+	public: std::uint32_t getElementByOrdinalNumber(std::uint32_t ordinalNumber) const
+	{
+		return ordinalNumber;
+	}
+}
+
 /**
  * Represents custom strict total ordering in which the order of elements is defined by an array
  * (the smallest element is at index 0).
@@ -0,0 +1,410 @@
+#include <eugenejonas/cpp_stuff/pod_containers/lock_free.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::vector;
+
+
+class UnitTest_SpscQueue: public CxxTest::TestSuite
+{
+	public: void test_single_thread()
+	{
+		SpscQueue <int> queue(5);
+		int x;
+		
+		TS_ASSERT_EQUALS(8u, queue.getCapacity());
+		TS_ASSERT(queue.isEmpty());
+		TS_ASSERT(!queue.tryDequeue(x));
+		
+		for (int i = 0; i < 8; i++)
+		{
+			TS_ASSERT(queue.tryEnqueue(i));
+		}
+		
+		TS_ASSERT(!queue.tryEnqueue(8));
+		TS_ASSERT_EQUALS(8u, queue.getSize());
+		TS_ASSERT_EQUALS(0, queue.peek());
+		TS_ASSERT_EQUALS(0, queue.dequeue());
+		TS_ASSERT(queue.tryDequeue(x));
+		TS_ASSERT_EQUALS(1, x);
+		
+		// batches wrap around the end of the buffer
+		int batch[] = {8, 9, 10, 11};
+		int result[8];
+		
+		TS_ASSERT_EQUALS(2u, queue.tryEnqueue(batch, 4));
+		TS_ASSERT_EQUALS(8u, queue.tryDequeue(result, 10));
+		
+		for (int i = 0; i < 8; i++)
+		{
+			TS_ASSERT_EQUALS(i + 2, result[i]);
+		}
+		
+		TS_ASSERT(queue.isEmpty());
+	}
+
+	/**
+	 * A producer thread enqueues numbers in batches and single, the
+	 * consumer must get all of them in order.
+	 */
+	public: void test_producer_and_consumer()
+	{
+		const int n = 200000;
+		SpscQueue <int> queue(64);
+		
+		std::thread producer([&queue, n]()
+		{
+			int batch[7];
+			
+			for (int i = 0; i < n; )
+			{
+				if (i % 3 == 0)
+				{
+					queue.enqueue(i++);
+					continue;
+				}
+				
+				int count = std::min(7, n - i);
+				
+				for (int j = 0; j < count; j++)
+				{
+					batch[j] = i + j;
+				}
+				
+				i += (int) queue.tryEnqueue(batch, count);
+			}
+		});
+		
+		int expected = 0, result[16];
+		
+		while (expected < n)
+		{
+			std::size_t count = queue.tryDequeue(result, 16);
+			
+			for (std::size_t j = 0; j < count; j++)
+			{
+				TS_ASSERT_EQUALS(expected++, result[j]);
+			}
+			
+			if (count == 0 && expected < n)
+			{
+				TS_ASSERT_EQUALS(expected++, queue.dequeue());
+			}
+		}
+		
+		producer.join();
+		
+		TS_ASSERT(queue.isEmpty());
+	}
+}
+
+class UnitTest_MpmcQueue: public CxxTest::TestSuite
+{
+	public: void test_single_thread()
+	{
+		MpmcQueue <int> queue(3);
+		StaticQueue <MpmcQueue <int>, int> &base = queue;
+		int x;
+		
+		TS_ASSERT_EQUALS(4u, queue.getCapacity());
+		TS_ASSERT(!queue.tryDequeue(x));
+		
+		for (int i = 0; i < 4; i++)
+		{
+			base.enqueue(i);
+		}
+		
+		TS_ASSERT(!queue.tryEnqueue(4));
+		TS_ASSERT_EQUALS(4u, base.getSize());
+		
+		for (int round = 0; round < 10; round++)
+		{
+			TS_ASSERT_EQUALS(round, base.peek());
+			TS_ASSERT_EQUALS(round, base.dequeue());
+			TS_ASSERT(queue.tryEnqueue(round + 4));
+		}
+		
+		TS_ASSERT_EQUALS(4u, queue.getSize());
+	}
+
+	/**
+	 * Several producers enqueue disjoint ranges of numbers, several
+	 * consumers dequeue them; every number must be dequeued once, and
+	 * numbers of each producer in order.
+	 */
+	public: void test_producers_and_consumers()
+	{
+		const int producerCount = 3, consumerCount = 3, n = 50000;
+		MpmcQueue <int> queue(128);
+		vector <vector <int> > dequeued(consumerCount);
+		vector <std::thread> threads;
+		
+		for (int p = 0; p < producerCount; p++)
+		{
+			threads.emplace_back([&queue, p, n]()
+			{
+				for (int i = 0; i < n; i++)
+				{
+					queue.enqueue(p * n + i);
+				}
+			});
+		}
+		
+		std::atomic <int> remaining(producerCount * n);
+		
+		for (int c = 0; c < consumerCount; c++)
+		{
+			threads.emplace_back([&queue, &dequeued, &remaining, c]()
+			{
+				int x;
+				
+				while (remaining.load() > 0)
+				{
+					if (queue.tryDequeue(x))
+					{
+						dequeued[c].push_back(x);
+						remaining--;
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		
+		for (std::thread &thread : threads)
+		{
+			thread.join();
+		}
+		
+		vector <int> all;
+		
+		for (vector <int> const &d : dequeued)
+		{
+			for (std::size_t i = 1; i < d.size(); i++)
+			{
+				if (d[i - 1] / n == d[i] / n)
+				{
+					TS_ASSERT(d[i - 1] < d[i]);
+				}
+			}
+			
+			all.insert(all.end(), d.begin(), d.end());
+		}
+		
+		std::sort(all.begin(), all.end());
+		
+		TS_ASSERT_EQUALS((std::size_t) producerCount * n, all.size());
+		
+		for (std::size_t i = 0; i < all.size(); i++)
+		{
+			TS_ASSERT_EQUALS((int) i, all[i]);
+		}
+		
+		TS_ASSERT(queue.isEmpty());
+	}
+}
+
+
+class UnitTest_TreiberStack: public CxxTest::TestSuite
+{
+	public: void test_single_thread()
+	{
+		TreiberStack <int> stack(3);
+		StaticStack <TreiberStack <int>, int> &base = stack;
+		int x;
+		
+		TS_ASSERT(stack.isEmpty());
+		TS_ASSERT(!stack.tryPop(x));
+		
+		base.push(1);
+		base.push(2);
+		TS_ASSERT(stack.tryPush(3));
+		TS_ASSERT(!stack.tryPush(4));
+		
+		TS_ASSERT_EQUALS(3u, base.getSize());
+		TS_ASSERT_EQUALS(3, base.peek());
+		TS_ASSERT_EQUALS(3, base.pop());
+		
+		// the freed node is reused
+		TS_ASSERT(stack.tryPush(5));
+		TS_ASSERT_EQUALS(5, base.pop());
+		TS_ASSERT_EQUALS(2, base.pop());
+		TS_ASSERT(stack.tryPop(x));
+		TS_ASSERT_EQUALS(1, x);
+		TS_ASSERT(base.isEmpty());
+	}
+
+	/**
+	 * Threads push and pop numbers concurrently; every pushed number
+	 * must be popped exactly once.
+	 */
+	public: void test_concurrent_push_and_pop()
+	{
+		const int threadCount = 4, n = 20000;
+		TreiberStack <int> stack(64);
+		vector <vector <int> > popped(threadCount);
+		vector <std::thread> threads;
+		
+		for (int t = 0; t < threadCount; t++)
+		{
+			threads.emplace_back([&stack, &popped, t, n]()
+			{
+				for (int i = 0; i < n; i++)
+				{
+					stack.push(t * n + i);
+					
+					if (i % 2 == 1)
+					{
+						popped[t].push_back(stack.pop());
+						popped[t].push_back(stack.pop());
+					}
+				}
+			});
+		}
+		
+		for (std::thread &thread : threads)
+		{
+			thread.join();
+		}
+		
+		vector <int> all;
+		
+		for (vector <int> const &p : popped)
+		{
+			all.insert(all.end(), p.begin(), p.end());
+		}
+		
+		std::sort(all.begin(), all.end());
+		
+		TS_ASSERT_EQUALS((std::size_t) threadCount * n, all.size());
+		TS_ASSERT(std::adjacent_find(all.begin(), all.end()) == all.end());
+		TS_ASSERT(stack.isEmpty());
+		TS_ASSERT_EQUALS(0u, stack.getSize());
+	}
+}
+
+class UnitTest_WorkStealingDeque: public CxxTest::TestSuite
+{
+	public: void test_single_thread()
+	{
+		WorkStealingDeque <int> deque(2);
+		StaticStack <WorkStealingDeque <int>, int> &base = deque;
+		int x;
+		
+		TS_ASSERT(deque.isEmpty());
+		TS_ASSERT(!deque.tryPop(x));
+		TS_ASSERT(!deque.trySteal(x));
+		
+		// grows twice
+		for (int i = 0; i < 7; i++)
+		{
+			base.push(i);
+		}
+		
+		TS_ASSERT_EQUALS(7u, base.getSize());
+		TS_ASSERT_EQUALS(6, base.peek());
+		TS_ASSERT_EQUALS(6, base.pop());
+		TS_ASSERT(deque.trySteal(x));
+		TS_ASSERT_EQUALS(0, x);
+		TS_ASSERT(deque.trySteal(x));
+		TS_ASSERT_EQUALS(1, x);
+		
+		for (int i = 5; i >= 2; i--)
+		{
+			TS_ASSERT(deque.tryPop(x));
+			TS_ASSERT_EQUALS(i, x);
+		}
+		
+		TS_ASSERT(!deque.tryPop(x));
+		TS_ASSERT(base.isEmpty());
+	}
+
+	/**
+	 * The owner pushes numbers and pops some of them, thieves steal the
+	 * others; every number must be taken exactly once, and thieves take
+	 * the numbers in increasing order.
+	 */
+	public: void test_owner_and_thieves()
+	{
+		const int thiefCount = 3, n = 100000;
+		WorkStealingDeque <int> deque(4);
+		vector <vector <int> > taken(thiefCount + 1);
+		std::atomic <bool> isDone(false);
+		vector <std::thread> thieves;
+		
+		for (int t = 1; t <= thiefCount; t++)
+		{
+			thieves.emplace_back([&deque, &taken, &isDone, t]()
+			{
+				int x;
+				
+				while (!isDone.load() || !deque.isEmpty())
+				{
+					if (deque.trySteal(x))
+					{
+						taken[t].push_back(x);
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		
+		for (int i = 0; i < n; i++)
+		{
+			deque.push(i);
+			int x;
+			
+			if (i % 3 == 0 && deque.tryPop(x))
+			{
+				taken[0].push_back(x);
+			}
+		}
+		
+		isDone = true;
+		
+		for (std::thread &thief : thieves)
+		{
+			thief.join();
+		}
+		
+		vector <int> all;
+		
+		for (int t = 0; t <= thiefCount; t++)
+		{
+			if (t > 0)
+			{
+				TS_ASSERT(std::is_sorted(taken[t].begin(), taken[t].end()));
+			}
+			
+			all.insert(all.end(), taken[t].begin(), taken[t].end());
+		}
+		
+		std::sort(all.begin(), all.end());
+		
+		TS_ASSERT_EQUALS((std::size_t) n, all.size());
+		
+		for (std::size_t i = 0; i < all.size(); i++)
+		{
+			TS_ASSERT_EQUALS((int) i, all[i]);
+		}
+	}
+}
+
+
+}
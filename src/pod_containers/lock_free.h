@@ -0,0 +1,892 @@
+#ifndef EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__LOCK_FREE_H
+#define EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__LOCK_FREE_H
+
+
+#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+/*
+ * Containers in this file can be used by several threads at once without
+ * locks. Their elements are POD, so they are copied in and out of the
+ * containers and never destroyed.
+ *
+ * Methods named try* don't wait: they fail if the container is full or
+ * empty. Methods of the StaticQueue and StaticStack interfaces wait
+ * (yielding the thread) until they can succeed, so a thread must not wait
+ * for itself.
+ */
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Size of a cache line. Indexes written by different threads are kept in
+ * different lines, so that threads don't invalidate each other's caches
+ * (false sharing).
+ */
+const std::size_t LOCK_FREE_CACHE_LINE_SIZE = 64;
+
+
+/**
+ * Bounded queue for one producer thread and one consumer thread: a ring
+ * buffer whose capacity is a power of two, so indexes are masked instead
+ * of taken modulo capacity. Each index is written by one thread only and
+ * published by a release store; the other thread reads it by an acquire
+ * load and caches it, so it touches the other thread's cache line only
+ * when the cached index says the queue is full (or empty).
+ *
+ * Only the producer may call enqueue methods and only the consumer may
+ * call dequeue methods and peek().
+ */
+template <typename TPL_SpscQueue_T> class SpscQueue: public StaticQueue <SpscQueue <TPL_SpscQueue_T>, TPL_SpscQueue_T>
+{
+	private: TPL_SpscQueue_T *arr;
+	private: std::size_t mask;
+
+	/**
+	 * Index of the next element to dequeue, written by the consumer,
+	 * and the consumer's copy of tail.
+	 */
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::size_t> head;
+	private: std::size_t cachedTail;
+
+	/**
+	 * Index behind the last enqueued element, written by the producer,
+	 * and the producer's copy of head.
+	 */
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::size_t> tail;
+	private: std::size_t cachedHead;
+
+
+	/**
+	 * Constructs new empty queue.
+	 *
+	 * @param capacity Minimum number of elements queue can store;
+	 *		it is rounded up to a power of two.
+	 */
+	public: SpscQueue(std::size_t capacity):
+			arr(new TPL_SpscQueue_T[std::bit_ceil(std::max(capacity, (std::size_t) 1))]),
+			mask(std::bit_ceil(std::max(capacity, (std::size_t) 1)) - 1),
+			head(0),
+			cachedTail(0),
+			tail(0),
+			cachedHead(0)
+	{
+		//nothing
+	}
+
+	public: SpscQueue(SpscQueue const &other) = delete;
+
+	public: SpscQueue &operator=(SpscQueue const &other) = delete;
+
+	public: ~SpscQueue()
+	{
+		delete[] this->arr;
+	}
+
+	/**
+	 * Enqueues element if the queue is not full. Called by the producer.
+	 */
+	public: bool tryEnqueue(TPL_SpscQueue_T const &element)
+	{
+		std::size_t tail = this->tail.load(std::memory_order_relaxed);
+		
+		if (tail - this->cachedHead > this->mask)
+		{
+			this->cachedHead = this->head.load(std::memory_order_acquire);
+			
+			if (tail - this->cachedHead > this->mask)
+			{
+				return false;
+			}
+		}
+		
+		this->arr[tail & this->mask] = element;
+		this->tail.store(tail + 1, std::memory_order_release);
+		
+		return true;
+	}
+
+	/**
+	 * Enqueues as many of count elements as there is room for, and
+	 * publishes them at once. Called by the producer.
+	 *
+	 * @return Number of enqueued elements.
+	 */
+	public: std::size_t tryEnqueue(const TPL_SpscQueue_T *elements, std::size_t count)
+	{
+		std::size_t tail = this->tail.load(std::memory_order_relaxed);
+		
+		if (this->mask + 1 - (tail - this->cachedHead) < count)
+		{
+			this->cachedHead = this->head.load(std::memory_order_acquire);
+		}
+		
+		count = std::min(count, this->mask + 1 - (tail - this->cachedHead));
+		
+		for (std::size_t i = 0; i < count; i++)
+		{
+			this->arr[(tail + i) & this->mask] = elements[i];
+		}
+		
+		this->tail.store(tail + count, std::memory_order_release);
+		
+		return count;
+	}
+
+	/**
+	 * Dequeues element to result if the queue is not empty. Called by the consumer.
+	 */
+	public: bool tryDequeue(TPL_SpscQueue_T &result)
+	{
+		return this->tryDequeue(&result, 1) == 1;
+	}
+
+	/**
+	 * Dequeues up to count elements to result. Called by the consumer.
+	 *
+	 * @return Number of dequeued elements.
+	 */
+	public: std::size_t tryDequeue(TPL_SpscQueue_T *result, std::size_t count)
+	{
+		std::size_t head = this->head.load(std::memory_order_relaxed);
+		
+		if (this->cachedTail - head < count)
+		{
+			this->cachedTail = this->tail.load(std::memory_order_acquire);
+		}
+		
+		count = std::min(count, this->cachedTail - head);
+		
+		for (std::size_t i = 0; i < count; i++)
+		{
+			result[i] = this->arr[(head + i) & this->mask];
+		}
+		
+		this->head.store(head + count, std::memory_order_release);
+		
+		return count;
+	}
+
+	/**
+	 * Enqueues element, waiting while the queue is full.
+	 */
+	public: void enqueue(TPL_SpscQueue_T const &element)
+	{
+		while (!this->tryEnqueue(element))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	/**
+	 * Dequeues element, waiting while the queue is empty.
+	 */
+	public: TPL_SpscQueue_T dequeue()
+	{
+		TPL_SpscQueue_T res;
+		
+		while (!this->tryDequeue(res))
+		{
+			std::this_thread::yield();
+		}
+		
+		return res;
+	}
+
+	/**
+	 * Returns element at the head of the queue, waiting while the queue
+	 * is empty. Called by the consumer.
+	 */
+	public: TPL_SpscQueue_T peek() const
+	{
+		std::size_t head = this->head.load(std::memory_order_relaxed);
+		
+		while (this->tail.load(std::memory_order_acquire) == head)
+		{
+			std::this_thread::yield();
+		}
+		
+		return this->arr[head & this->mask];
+	}
+
+	/**
+	 * Returns true if the queue is empty. The result may be outdated
+	 * when it is returned, unless called by the consumer.
+	 */
+	public: bool isEmpty() const
+	{
+		return this->getSize() == 0;
+	}
+
+	/**
+	 * Returns number of elements in the queue. The result may be outdated
+	 * when it is returned.
+	 */
+	public: std::size_t getSize() const
+	{
+		std::size_t head = this->head.load(std::memory_order_acquire);
+		return this->tail.load(std::memory_order_acquire) - head;
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->mask + 1;
+	}
+}
+
+/**
+ * Bounded queue for any number of producer and consumer threads (Dmitry
+ * Vyukov's MPMC queue). Every cell of the ring buffer has a sequence
+ * number telling in which round of the ring it can be written or read:
+ * a producer claims a cell by incrementing the enqueue index with
+ * compare-exchange, writes the element and publishes it by storing the
+ * next sequence number; consumers do the same with the dequeue index.
+ * Threads only contend on the index they increment.
+ */
+template <typename TPL_MpmcQueue_T> class MpmcQueue: public StaticQueue <MpmcQueue <TPL_MpmcQueue_T>, TPL_MpmcQueue_T>
+{
+	private: struct Cell
+	{
+		public: std::atomic <std::size_t> sequence;
+		public: TPL_MpmcQueue_T data;
+	}
+
+
+	private: Cell *cells;
+	private: std::size_t mask;
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::size_t> enqueuePos;
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::size_t> dequeuePos;
+
+
+	/**
+	 * Constructs new empty queue.
+	 *
+	 * @param capacity Minimum number of elements queue can store;
+	 *		it is rounded up to a power of two (at least 2).
+	 */
+	public: MpmcQueue(std::size_t capacity):
+			mask(std::bit_ceil(std::max(capacity, (std::size_t) 2)) - 1),
+			enqueuePos(0),
+			dequeuePos(0)
+	{
+		this->cells = new Cell[this->mask + 1];
+		
+		for (std::size_t i = 0; i <= this->mask; i++)
+		{
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	public: MpmcQueue(MpmcQueue const &other) = delete;
+
+	public: MpmcQueue &operator=(MpmcQueue const &other) = delete;
+
+	public: ~MpmcQueue()
+	{
+		delete[] this->cells;
+	}
+
+	/**
+	 * Enqueues element if the queue is not full.
+	 */
+	public: bool tryEnqueue(TPL_MpmcQueue_T const &element)
+	{
+		std::size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+		Cell *cell;
+		
+		while (true)
+		{
+			cell = &this->cells[pos & this->mask];
+			std::intptr_t difference = (std::intptr_t) cell->sequence.load(std::memory_order_acquire) - (std::intptr_t) pos;
+			
+			if (difference == 0)
+			{
+				if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				// the cell still holds an element from the previous round
+				return false;
+			}
+			else
+			{
+				pos = this->enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		
+		cell->data = element;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		
+		return true;
+	}
+
+	/**
+	 * Dequeues element to result if the queue is not empty.
+	 */
+	public: bool tryDequeue(TPL_MpmcQueue_T &result)
+	{
+		std::size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+		Cell *cell;
+		
+		while (true)
+		{
+			cell = &this->cells[pos & this->mask];
+			std::intptr_t difference = (std::intptr_t) cell->sequence.load(std::memory_order_acquire) - (std::intptr_t) (pos + 1);
+			
+			if (difference == 0)
+			{
+				if (this->dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				// the cell hasn't been written in this round yet
+				return false;
+			}
+			else
+			{
+				pos = this->dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		
+		result = cell->data;
+		cell->sequence.store(pos + this->mask + 1, std::memory_order_release);
+		
+		return true;
+	}
+
+	/**
+	 * Enqueues element, waiting while the queue is full.
+	 */
+	public: void enqueue(TPL_MpmcQueue_T const &element)
+	{
+		while (!this->tryEnqueue(element))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	/**
+	 * Dequeues element, waiting while the queue is empty.
+	 */
+	public: TPL_MpmcQueue_T dequeue()
+	{
+		TPL_MpmcQueue_T res;
+		
+		while (!this->tryDequeue(res))
+		{
+			std::this_thread::yield();
+		}
+		
+		return res;
+	}
+
+	/**
+	 * Returns element at the head of the queue, waiting while the queue
+	 * is empty. The element may be dequeued by another consumer meanwhile,
+	 * so the result is reliable only if there is no other consumer.
+	 */
+	public: TPL_MpmcQueue_T peek() const
+	{
+		std::size_t pos = this->dequeuePos.load(std::memory_order_relaxed);
+		Cell const &cell = this->cells[pos & this->mask];
+		
+		while (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+		{
+			std::this_thread::yield();
+		}
+		
+		return cell.data;
+	}
+
+	/**
+	 * Returns true if the queue is empty. The result may be outdated
+	 * when it is returned.
+	 */
+	public: bool isEmpty() const
+	{
+		return this->getSize() == 0;
+	}
+
+	/**
+	 * Returns number of elements in the queue, including the ones being
+	 * enqueued or dequeued. The result may be outdated when it is returned.
+	 */
+	public: std::size_t getSize() const
+	{
+		std::size_t dequeuePos = this->dequeuePos.load(std::memory_order_acquire);
+		std::size_t enqueuePos = this->enqueuePos.load(std::memory_order_acquire);
+		
+		return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->mask + 1;
+	}
+}
+
+
+/**
+ * Bounded stack for any number of threads (Treiber stack). Elements are
+ * stored in a preallocated array of nodes; the stack and the list of free
+ * nodes are linked lists of node indexes, whose heads are changed by
+ * compare-exchange. The ABA problem (a node popped and pushed again by
+ * other threads between reading the head and the compare-exchange) is
+ * prevented by a tag in the upper half of the head, incremented by every
+ * change. Nodes are never freed while the stack exists, so reading the
+ * next index of a node which has been popped meanwhile is harmless.
+ */
+template <typename TPL_TreiberStack_T> class TreiberStack: public StaticStack <TreiberStack <TPL_TreiberStack_T>, TPL_TreiberStack_T>
+{
+	private: struct Node
+	{
+		public: std::atomic <std::uint32_t> next;
+		public: TPL_TreiberStack_T data;
+	}
+
+
+	/**
+	 * Index of no node, the end of lists.
+	 */
+	private: static const std::uint32_t NIL = 0xffffffffu;
+
+
+	private: Node *nodes;
+	private: std::uint32_t capacity;
+
+	/**
+	 * Heads of the lists: tag << 32 | index of the first node.
+	 */
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::uint64_t> top;
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::uint64_t> freeTop;
+
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::size_t> size;
+
+
+	/**
+	 * Constructs new empty stack.
+	 *
+	 * @param capacity Maximum number of elements, less than 2^32 - 1.
+	 */
+	public: TreiberStack(std::size_t capacity):
+			nodes(new Node[capacity]),
+			capacity((std::uint32_t) capacity),
+			top(TreiberStack::NIL),
+			freeTop(capacity == 0 ? TreiberStack::NIL : 0),
+			size(0)
+	{
+		assert(capacity < TreiberStack::NIL);
+		
+		for (std::uint32_t i = 0; i < this->capacity; i++)
+		{
+			this->nodes[i].next.store(i + 1 < this->capacity ? i + 1 : TreiberStack::NIL, std::memory_order_relaxed);
+		}
+	}
+
+	public: TreiberStack(TreiberStack const &other) = delete;
+
+	public: TreiberStack &operator=(TreiberStack const &other) = delete;
+
+	public: ~TreiberStack()
+	{
+		delete[] this->nodes;
+	}
+
+	/**
+	 * Pushes element if the stack is not full.
+	 */
+	public: bool tryPush(TPL_TreiberStack_T const &element)
+	{
+		std::uint32_t node = this->popNode(this->freeTop);
+		
+		if (node == TreiberStack::NIL)
+		{
+			return false;
+		}
+		
+		// counted before it can be popped, so that the size never drops below 0
+		this->nodes[node].data = element;
+		this->size.fetch_add(1, std::memory_order_relaxed);
+		this->pushNode(this->top, node);
+		
+		return true;
+	}
+
+	/**
+	 * Pops element to result if the stack is not empty.
+	 */
+	public: bool tryPop(TPL_TreiberStack_T &result)
+	{
+		std::uint32_t node = this->popNode(this->top);
+		
+		if (node == TreiberStack::NIL)
+		{
+			return false;
+		}
+		
+		this->size.fetch_sub(1, std::memory_order_relaxed);
+		result = this->nodes[node].data;
+		this->pushNode(this->freeTop, node);
+		
+		return true;
+	}
+
+	/**
+	 * Pushes element, waiting while the stack is full.
+	 */
+	public: void push(TPL_TreiberStack_T const &element)
+	{
+		while (!this->tryPush(element))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	/**
+	 * Pops element, waiting while the stack is empty.
+	 */
+	public: TPL_TreiberStack_T pop()
+	{
+		TPL_TreiberStack_T res;
+		
+		while (!this->tryPop(res))
+		{
+			std::this_thread::yield();
+		}
+		
+		return res;
+	}
+
+	/**
+	 * Returns element at the top of the stack, waiting while the stack is
+	 * empty. The result is reliable only if no other thread pops meanwhile.
+	 */
+	public: TPL_TreiberStack_T peek() const
+	{
+		std::uint32_t node;
+		
+		while ((node = (std::uint32_t) this->top.load(std::memory_order_acquire)) == TreiberStack::NIL)
+		{
+			std::this_thread::yield();
+		}
+		
+		return this->nodes[node].data;
+	}
+
+	/**
+	 * Returns true if the stack is empty. The result may be outdated
+	 * when it is returned.
+	 */
+	public: bool isEmpty() const
+	{
+		return (std::uint32_t) this->top.load(std::memory_order_acquire) == TreiberStack::NIL;
+	}
+
+	/**
+	 * Returns number of elements in the stack. The result may be outdated
+	 * when it is returned.
+	 */
+	public: std::size_t getSize() const
+	{
+		return this->size.load(std::memory_order_relaxed);
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	private: void pushNode(std::atomic <std::uint64_t> &head, std::uint32_t node)
+	{
+		std::uint64_t old = head.load(std::memory_order_relaxed);
+		
+		do
+		{
+			this->nodes[node].next.store((std::uint32_t) old, std::memory_order_relaxed);
+		}
+		while (!head.compare_exchange_weak(old, TreiberStack::getNextHead(old, node), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * Returns the first node of a list, or NIL if the list is empty.
+	 */
+	private: std::uint32_t popNode(std::atomic <std::uint64_t> &head)
+	{
+		std::uint64_t old = head.load(std::memory_order_acquire);
+		
+		while ((std::uint32_t) old != TreiberStack::NIL)
+		{
+			std::uint32_t next = this->nodes[(std::uint32_t) old].next.load(std::memory_order_relaxed);
+			
+			if (head.compare_exchange_weak(old, TreiberStack::getNextHead(old, next), std::memory_order_acquire, std::memory_order_acquire))
+			{
+				break;
+			}
+		}
+		
+		return (std::uint32_t) old;
+	}
+
+	/**
+	 * Returns head pointing to node, with tag incremented.
+	 */
+	private: static std::uint64_t getNextHead(std::uint64_t head, std::uint32_t node)
+	{
+		return ((head >> 32) + 1) << 32 | node;
+	}
+}
+
+/**
+ * Work-stealing deque (Chase and Lev, with the memory orders of Le, Pop,
+ * Cohen and Zappa Nardelli): the owner thread pushes and pops elements at
+ * the bottom like a stack, other threads steal elements from the top.
+ * Only stealing of the last element needs compare-exchange. The ring
+ * buffer grows when it is full; old buffers may still be read by thieves,
+ * so they are freed with the deque.
+ *
+ * Elements are stored in std::atomic <T>, so the deque is lock-free if
+ * std::atomic <T> is (e.g. for pointers and integers).
+ *
+ * Only the owner may call push(), pop(), tryPop() and peek().
+ */
+template <typename TPL_WorkStealingDeque_T> class WorkStealingDeque: public StaticStack <WorkStealingDeque <TPL_WorkStealingDeque_T>, TPL_WorkStealingDeque_T>
+{
+	private: struct Buffer
+	{
+		public: std::int64_t mask;
+		public: std::atomic <TPL_WorkStealingDeque_T> *cells;
+
+
+		public: Buffer(std::int64_t capacity):
+				mask(capacity - 1),
+				cells(new std::atomic <TPL_WorkStealingDeque_T>[capacity])
+		{
+			//nothing
+		}
+
+		public: ~Buffer()
+		{
+			delete[] this->cells;
+		}
+
+		public: TPL_WorkStealingDeque_T get(std::int64_t i) const
+		{
+			return this->cells[i & this->mask].load(std::memory_order_relaxed);
+		}
+
+		public: void put(std::int64_t i, TPL_WorkStealingDeque_T const &element)
+		{
+			this->cells[i & this->mask].store(element, std::memory_order_relaxed);
+		}
+	}
+
+
+	/**
+	 * Index of the top element, incremented by thieves.
+	 */
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::int64_t> top;
+
+	/**
+	 * Index behind the bottom element, changed by the owner.
+	 */
+	private: alignas(LOCK_FREE_CACHE_LINE_SIZE) std::atomic <std::int64_t> bottom;
+	private: std::atomic <Buffer*> buffer;
+
+	/**
+	 * All buffers, including the current one; used by the owner only.
+	 */
+	private: std::vector <Buffer*> buffers;
+
+
+	/**
+	 * Constructs new empty deque.
+	 *
+	 * @param capacity Initial capacity, rounded up to a power of two.
+	 */
+	public: WorkStealingDeque(std::size_t capacity = 64):
+			top(0),
+			bottom(0)
+	{
+		this->buffers.push_back(new Buffer((std::int64_t) std::bit_ceil(std::max(capacity, (std::size_t) 2))));
+		this->buffer.store(this->buffers.back(), std::memory_order_relaxed);
+	}
+
+	public: WorkStealingDeque(WorkStealingDeque const &other) = delete;
+
+	public: WorkStealingDeque &operator=(WorkStealingDeque const &other) = delete;
+
+	public: ~WorkStealingDeque()
+	{
+		for (Buffer *buffer : this->buffers)
+		{
+			delete buffer;
+		}
+	}
+
+	/**
+	 * Pushes element to the bottom. Called by the owner.
+	 */
+	public: void push(TPL_WorkStealingDeque_T const &element)
+	{
+		std::int64_t b = this->bottom.load(std::memory_order_relaxed);
+		std::int64_t t = this->top.load(std::memory_order_acquire);
+		Buffer *buffer = this->buffer.load(std::memory_order_relaxed);
+		
+		if (b - t > buffer->mask)
+		{
+			buffer = this->grow(buffer, t, b);
+		}
+		
+		buffer->put(b, element);
+		std::atomic_thread_fence(std::memory_order_release);
+		this->bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Pops element from the bottom to result if the deque is not empty.
+	 * Called by the owner.
+	 */
+	public: bool tryPop(TPL_WorkStealingDeque_T &result)
+	{
+		std::int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+		Buffer *buffer = this->buffer.load(std::memory_order_relaxed);
+		
+		this->bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		
+		std::int64_t t = this->top.load(std::memory_order_relaxed);
+		
+		if (t > b)
+		{
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		
+		result = buffer->get(b);
+		
+		if (t == b)
+		{
+			// the last element; race with thieves
+			bool isWon = this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+			return isWon;
+		}
+		
+		return true;
+	}
+
+	/**
+	 * Steals element from the top to result. Fails if the deque is empty
+	 * or another thread took the element meanwhile.
+	 */
+	public: bool trySteal(TPL_WorkStealingDeque_T &result)
+	{
+		std::int64_t t = this->top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		std::int64_t b = this->bottom.load(std::memory_order_acquire);
+		
+		if (t >= b)
+		{
+			return false;
+		}
+		
+		result = this->buffer.load(std::memory_order_acquire)->get(t);
+		
+		return this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Pops element from the bottom, waiting while the deque is empty.
+	 * Called by the owner.
+	 */
+	public: TPL_WorkStealingDeque_T pop()
+	{
+		TPL_WorkStealingDeque_T res;
+		
+		while (!this->tryPop(res))
+		{
+			std::this_thread::yield();
+		}
+		
+		return res;
+	}
+
+	/**
+	 * Returns element at the bottom, waiting while the deque is empty.
+	 * The result is reliable only if no thread steals meanwhile. Called by the owner.
+	 */
+	public: TPL_WorkStealingDeque_T peek() const
+	{
+		std::int64_t b = this->bottom.load(std::memory_order_relaxed);
+		
+		while (this->top.load(std::memory_order_acquire) >= b)
+		{
+			std::this_thread::yield();
+		}
+		
+		return this->buffer.load(std::memory_order_relaxed)->get(b - 1);
+	}
+
+	/**
+	 * Returns true if the deque is empty. The result may be outdated
+	 * when it is returned.
+	 */
+	public: bool isEmpty() const
+	{
+		return this->getSize() == 0;
+	}
+
+	/**
+	 * Returns number of elements in the deque. The result may be outdated
+	 * when it is returned.
+	 */
+	public: std::size_t getSize() const
+	{
+		std::int64_t b = this->bottom.load(std::memory_order_acquire);
+		std::int64_t t = this->top.load(std::memory_order_acquire);
+		
+		return b > t ? (std::size_t) (b - t) : 0;
+	}
+
+	/**
+	 * Replaces the buffer by one twice as large with elements [top; bottom).
+	 */
+	private: Buffer *grow(Buffer *buffer, std::int64_t top, std::int64_t bottom)
+	{
+		Buffer *res = new Buffer(2 * (buffer->mask + 1));
+		
+		for (std::int64_t i = top; i < bottom; i++)
+		{
+			res->put(i, buffer->get(i));
+		}
+		
+		this->buffers.push_back(res);
+		this->buffer.store(res, std::memory_order_release);
+		
+		return res;
+	}
+}
+
+
+}
+
+
+#endif
@@ -4,7 +4,12 @@
 #include <eugenejonas/cpp_stuff/sort.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <cxxtest/TestSuite.h>
 
@@ -57,6 +62,105 @@ class UnitTest_PriorityQueue: public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(&str1, queue.extract());
 		TS_ASSERT(queue.isEmpty());
 	}
+
+	public: void test_bulk_operations()
+	{
+		const int capacity = 100;
+		PriorityQueue <int> queue(capacity), other(capacity);
+		std::vector <int> input(capacity), extracted(capacity);
+		std::srand(5);
+		
+		for (int i = 0; i < capacity; i++)
+		{
+			input[i] = std::rand() % 50;
+		}
+		
+		// few elements are inserted one by one, many are rebuilt
+		queue.insertRange(input.begin(), input.begin() + 60);
+		queue.insertRange(input.begin() + 60, input.begin() + 62);
+		other.insertRange(input.begin() + 62, input.end());
+		queue.meld(other);
+		
+		TS_ASSERT(other.isEmpty());
+		TS_ASSERT_EQUALS(extracted.end(), queue.extractN(capacity, extracted.begin()));
+		
+		std::sort(input.begin(), input.end(), std::greater <int> ());
+		
+		TS_ASSERT_EQUALS(input, extracted);
+		TS_ASSERT(queue.isEmpty());
+	}
+}
+
+class UnitTest_LoserTree: public CxxTest::TestSuite
+{
+	/**
+	 * Merges sorted runs of pairs compared by the first component and
+	 * checks that equal keys come out in order of the runs.
+	 */
+	public: void test_merge()
+	{
+		typedef std::pair <int, int> Pair;
+		
+		struct CompareFirst
+		{
+			public: bool operator()(Pair const &a, Pair const &b) const
+			{
+				return a.first < b.first;
+			}
+		}
+		
+		for (std::size_t k = 1; k <= 9; k++)
+		{
+			std::vector <std::vector <Pair> > runs(k);
+			std::vector <Pair> expected;
+			std::srand((unsigned) k);
+			
+			for (std::size_t i = 0; i < k; i++)
+			{
+				// the last run stays empty
+				for (int j = (i + 1 < k || k == 1) ? std::rand() % 20 : 0; j > 0; j--)
+				{
+					runs[i].push_back(Pair(std::rand() % 10, (int) i));
+				}
+				
+				std::sort(runs[i].begin(), runs[i].end());
+				expected.insert(expected.end(), runs[i].begin(), runs[i].end());
+			}
+			
+			std::stable_sort(expected.begin(), expected.end(), CompareFirst());
+			
+			LoserTree <Pair, CompareFirst> tree(k);
+			std::vector <std::size_t> positions(k, 0);
+			std::vector <Pair> merged;
+			
+			for (std::size_t i = 0; i < k; i++)
+			{
+				if (!runs[i].empty())
+				{
+					tree.set(i, runs[i][0]);
+				}
+			}
+			
+			tree.build();
+			
+			while (!tree.isEmpty())
+			{
+				std::size_t i = tree.getWinner();
+				merged.push_back(tree.peek());
+				
+				if (++positions[i] < runs[i].size())
+				{
+					tree.replaceWinner(runs[i][positions[i]]);
+				}
+				else
+				{
+					tree.removeWinner();
+				}
+			}
+			
+			TS_ASSERT_EQUALS(expected, merged);
+		}
+	}
 }
 
 class UnitTest_ArrayStack: public CxxTest::TestSuite
@@ -166,6 +270,155 @@ class UnitTest_ArrayQueue: public CxxTest::TestSuite
 	}
 }
 
+class UnitTest_GrowableArrayStack: public CxxTest::TestSuite
+{
+	public: void test_growth()
+	{
+		GrowableArrayStack <int> stack;
+		
+		TS_ASSERT_EQUALS(0u, stack.getCapacity());
+		
+		for (int i = 0; i < 1000; i++)
+		{
+			stack.push(i);
+		}
+		
+		TS_ASSERT_EQUALS(1000u, stack.getSize());
+		TS_ASSERT(stack.getCapacity() >= 1000);
+		
+		GrowableArrayStack <int> copy(stack), assigned(3);
+		assigned = stack;
+		
+		for (int i = 999; i >= 0; i--)
+		{
+			TS_ASSERT_EQUALS(i, stack.peek());
+			TS_ASSERT_EQUALS(i, stack.pop());
+		}
+		
+		TS_ASSERT(stack.isEmpty());
+		stack.shrinkToFit();
+		TS_ASSERT_EQUALS(0u, stack.getCapacity());
+		
+		TS_ASSERT_EQUALS(999, copy.pop());
+		TS_ASSERT_EQUALS(1000u, assigned.getSize());
+		TS_ASSERT_EQUALS(999, assigned.pop());
+	}
+
+	public: void test_ranges()
+	{
+		std::vector <int> input(100), output(100);
+		GrowableArrayStack <int> stack(10);
+		
+		for (int i = 0; i < 100; i++)
+		{
+			input[i] = i * i;
+		}
+		
+		stack.push(-1);
+		stack.pushRange(input.data(), 100);
+		stack.pushRange(input.data(), 0);
+		
+		TS_ASSERT_EQUALS(101u, stack.getSize());
+		TS_ASSERT_EQUALS(99 * 99, stack.peek());
+		
+		stack.popRange(output.data(), 100);
+		
+		TS_ASSERT_EQUALS(input, output);
+		TS_ASSERT_EQUALS(1u, stack.getSize());
+		
+		stack.shrinkToFit();
+		
+		TS_ASSERT_EQUALS(1u, stack.getCapacity());
+		TS_ASSERT_EQUALS(-1, stack.pop());
+	}
+}
+
+class UnitTest_GrowableArrayQueue: public CxxTest::TestSuite
+{
+	/**
+	 * Grows while the elements wrap around the end of the array, from
+	 * both ends.
+	 */
+	public: void test_growth()
+	{
+		GrowableArrayQueue <int> queue(4);
+		
+		queue.enqueue(0);
+		queue.enqueue(1);
+		queue.enqueue(2);
+		queue.dequeue();
+		queue.dequeue();
+		
+		for (int i = 3; i < 100; i++)
+		{
+			queue.enqueue(i);
+		}
+		
+		for (int i = 1; i >= -100; i--)
+		{
+			queue.pushFront(i);
+		}
+		
+		TS_ASSERT_EQUALS(200u, queue.getSize());
+		TS_ASSERT_EQUALS(99, queue.peekLast());
+		
+		GrowableArrayQueue <int> copy(queue), assigned;
+		assigned = queue;
+		
+		for (int i = -100; i < 99; i++)
+		{
+			TS_ASSERT_EQUALS(i, queue.peek());
+			TS_ASSERT_EQUALS(i, queue.dequeue());
+		}
+		
+		TS_ASSERT_EQUALS(99, queue.popLast());
+		TS_ASSERT(queue.isEmpty());
+		
+		TS_ASSERT_EQUALS(-100, copy.dequeue());
+		TS_ASSERT_EQUALS(99, assigned.popLast());
+		TS_ASSERT_EQUALS(-100, assigned.dequeue());
+	}
+
+	public: void test_ranges()
+	{
+		std::vector <int> input(50), output(50);
+		GrowableArrayQueue <int> queue(16);
+		
+		for (int i = 0; i < 50; i++)
+		{
+			input[i] = 3 * i;
+		}
+		
+		// the ranges wrap around the end of the array
+		for (int round = 0; round < 10; round++)
+		{
+			queue.enqueueRange(input.data(), 7);
+			queue.dequeueRange(output.data(), 5);
+			
+			TS_ASSERT_EQUALS(std::vector <int> (input.begin(), input.begin() + 5), std::vector <int> (output.begin(), output.begin() + 5));
+			queue.dequeueRange(output.data(), 2);
+			TS_ASSERT_EQUALS(15, output[0]);
+		}
+		
+		TS_ASSERT_EQUALS(16u, queue.getCapacity());
+		
+		queue.enqueueRange(input.data(), 10);
+		queue.dequeue();
+		queue.enqueueRange(input.data() + 10, 40);
+		queue.pushFront(0);
+		queue.dequeueRange(output.data(), 50);
+		
+		TS_ASSERT_EQUALS(input, output);
+		
+		queue.enqueueRange(input.data(), 3);
+		queue.shrinkToFit();
+		
+		TS_ASSERT_EQUALS(3u, queue.getCapacity());
+		TS_ASSERT_EQUALS(6, queue.peekLast());
+		TS_ASSERT_EQUALS(0, queue.dequeue());
+	}
+}
+
 class UnitTest_ListStack: public CxxTest::TestSuite
 {
 	public: void test_with_primitive_types()
@@ -249,4 +502,357 @@ class UnitTest_ListQueue: public CxxTest::TestSuite
 }
 
 
+class UnitTest_ChunkedListStack: public CxxTest::TestSuite
+{
+	/**
+	 * Chunks of 4 elements, so that pushes and pops cross chunk boundaries.
+	 */
+	public: void test_with_primitive_types()
+	{
+		const int count = 30;
+		ChunkedListStack <int, 4> stack;
+		
+		for (int i = 0; i < count; i++)
+		{
+			stack.push(i * 7 % 11);
+		}
+		
+		ChunkedListStack <int, 4> copy(stack);
+		
+		for (int i = count - 1; i >= 0; i--)
+		{
+			TS_ASSERT_EQUALS(i * 7 % 11, stack.peek());
+			TS_ASSERT_EQUALS(i * 7 % 11, stack.pop());
+		}
+		
+		TS_ASSERT(stack.isEmpty());
+		TS_ASSERT_EQUALS((std::size_t) count, copy.getSize());
+		
+		for (int i = count - 1; i >= 0; i--)
+		{
+			TS_ASSERT_EQUALS(i * 7 % 11, copy.pop());
+		}
+	}
+
+	public: void test_with_pointers_to_objects()
+	{
+		string str1("abc"), str2("bc"), str3("c");
+		ChunkedListStack <string*> stack;
+		
+		stack.push(&str1);
+		stack.push(&str2);
+		stack.push(&str3);
+		
+		TS_ASSERT_EQUALS(&str3, stack.peek());
+		TS_ASSERT_EQUALS(&str3, stack.pop());
+		TS_ASSERT_EQUALS(&str2, stack.pop());
+		TS_ASSERT_EQUALS(&str1, stack.pop());
+		TS_ASSERT(stack.isEmpty());
+	}
+
+	/**
+	 * Chunks released by pops and by the destructor go to the pool of the
+	 * thread and are reused by next pushes.
+	 */
+	public: void test_node_pool()
+	{
+		typedef ChunkedListStack <long long, 8> LongStack;
+		
+		// no other test uses this type
+		TS_ASSERT_EQUALS(0u, LongStack::getFreeChunkCount());
+		
+		{
+			LongStack stack;
+			
+			for (int i = 0; i < 8 * 5; i++)
+			{
+				stack.push(i);
+			}
+			
+			for (int i = 0; i < 8 * 3; i++)
+			{
+				stack.pop();
+			}
+			
+			TS_ASSERT_EQUALS(3u, LongStack::getFreeChunkCount());
+		}
+		
+		TS_ASSERT_EQUALS(5u, LongStack::getFreeChunkCount());
+		
+		LongStack stack;
+		stack.push(1);
+		stack.push(2);
+		
+		TS_ASSERT_EQUALS(4u, LongStack::getFreeChunkCount());
+		TS_ASSERT_EQUALS(2, stack.pop());
+		TS_ASSERT_EQUALS(1, stack.pop());
+	}
+
+	/**
+	 * The stack is constructed before the pool of the thread, so it is
+	 * destroyed after the pool and its chunks are deleted directly.
+	 */
+	public: void test_thread_local_stack_outlives_node_pool()
+	{
+		std::thread thread([]()
+		{
+			static thread_local ChunkedListStack <short, 4> stack;
+			
+			for (int i = 0; i < 10; i++)
+			{
+				stack.push((short) i);
+			}
+		});
+		
+		thread.join();
+	}
+
+	public: void test_assignment()
+	{
+		ChunkedListStack <int, 4> stack, other;
+		
+		for (int i = 0; i < 10; i++)
+		{
+			stack.push(i);
+		}
+		
+		for (int i = 0; i < 3; i++)
+		{
+			other.push(-i);
+		}
+		
+		other = stack;
+		stack = stack;
+		
+		TS_ASSERT_EQUALS(10u, other.getSize());
+		
+		for (int i = 9; i >= 0; i--)
+		{
+			TS_ASSERT_EQUALS(i, stack.pop());
+			TS_ASSERT_EQUALS(i, other.pop());
+		}
+		
+		other = stack;
+		
+		TS_ASSERT(other.isEmpty());
+	}
+}
+
+class UnitTest_ChunkedListQueue: public CxxTest::TestSuite
+{
+	public: void test_with_primitive_types()
+	{
+		const int count = 30;
+		ChunkedListQueue <int, 4> queue;
+		
+		for (int i = 0; i < count; i++)
+		{
+			queue.enqueue(i * 7 % 11);
+		}
+		
+		// the copy starts in the middle of a chunk
+		queue.dequeue();
+		queue.dequeue();
+		
+		ChunkedListQueue <int, 4> copy(queue);
+		
+		for (int i = 2; i < count; i++)
+		{
+			TS_ASSERT_EQUALS(i * 7 % 11, queue.peek());
+			TS_ASSERT_EQUALS(i * 7 % 11, queue.dequeue());
+			TS_ASSERT_EQUALS(i * 7 % 11, copy.dequeue());
+		}
+		
+		TS_ASSERT(queue.isEmpty());
+		TS_ASSERT(copy.isEmpty());
+	}
+
+	public: void test_assignment()
+	{
+		ChunkedListQueue <int, 4> queue, other;
+		
+		for (int i = 0; i < 10; i++)
+		{
+			queue.enqueue(i);
+		}
+		
+		queue.dequeue();
+		
+		for (int i = 0; i < 3; i++)
+		{
+			other.enqueue(-i);
+		}
+		
+		other = queue;
+		queue = queue;
+		
+		TS_ASSERT_EQUALS(9u, other.getSize());
+		
+		for (int i = 1; i < 10; i++)
+		{
+			TS_ASSERT_EQUALS(i, queue.dequeue());
+			TS_ASSERT_EQUALS(i, other.dequeue());
+		}
+		
+		other = ChunkedListQueue <int, 4> ();
+		other.enqueue(1);
+		
+		TS_ASSERT_EQUALS(1, other.dequeue());
+	}
+
+	public: void test_with_pointers_to_objects()
+	{
+		string str1("abc"), str2("bc"), str3("c");
+		ChunkedListQueue <string*> queue;
+		
+		queue.enqueue(&str1);
+		queue.enqueue(&str2);
+		queue.enqueue(&str3);
+		
+		TS_ASSERT_EQUALS(&str1, queue.peek());
+		TS_ASSERT_EQUALS(&str1, queue.dequeue());
+		TS_ASSERT_EQUALS(&str2, queue.dequeue());
+		TS_ASSERT_EQUALS(&str3, queue.dequeue());
+		TS_ASSERT(queue.isEmpty());
+	}
+
+	/**
+	 * Alternating enqueues and dequeues move through chunks in a loop.
+	 */
+	public: void test_as_pipe()
+	{
+		ChunkedListQueue <int, 5> queue;
+		int next = 0, expected = 0;
+		std::srand(6);
+		
+		for (int step = 0; step < 10000; step++)
+		{
+			if (std::rand() % 2 == 0 || queue.isEmpty())
+			{
+				queue.enqueue(next++);
+			}
+			else
+			{
+				TS_ASSERT_EQUALS(expected++, queue.dequeue());
+			}
+			
+			TS_ASSERT_EQUALS((std::size_t) (next - expected), queue.getSize());
+		}
+	}
+}
+
+
+class UnitTest_static_and_dynamic_interfaces: public CxxTest::TestSuite
+{
+	/**
+	 * Generic code on the static interface; calls are resolved at compile time.
+	 */
+	private: template <typename TPL_Stack> static int pushAndPopAll(StaticStack <TPL_Stack, int> &stack, int n)
+	{
+		for (int i = 1; i <= n; i++)
+		{
+			stack.push(i);
+		}
+		
+		int sum = 0;
+		
+		while (!stack.isEmpty())
+		{
+			sum += stack.pop();
+		}
+		
+		return sum;
+	}
+
+	private: template <typename TPL_Queue> static int enqueueAndDequeueAll(StaticQueue <TPL_Queue, int> &queue, int n)
+	{
+		for (int i = 1; i <= n; i++)
+		{
+			queue.enqueue(i);
+		}
+		
+		int sum = 0;
+		
+		while (queue.getSize() > 0)
+		{
+			int x = queue.peek();
+			TS_ASSERT_EQUALS(x, queue.dequeue());
+			sum += x;
+		}
+		
+		return sum;
+	}
+
+	public: void test_static_interface()
+	{
+		ArrayStack <int> arrayStack(100);
+		ListStack <int> listStack;
+		ChunkedListStack <int, 8> chunkedStack;
+		ArrayQueue <int> arrayQueue(100);
+		ChunkedListQueue <int, 8> chunkedQueue;
+		
+		TS_ASSERT_EQUALS(5050, pushAndPopAll(arrayStack, 100));
+		TS_ASSERT_EQUALS(5050, pushAndPopAll(listStack, 100));
+		TS_ASSERT_EQUALS(5050, pushAndPopAll(chunkedStack, 100));
+		
+		TS_ASSERT(!std::is_polymorphic <ArrayStack <int> > ::value);
+		TS_ASSERT(!std::is_polymorphic <ArrayQueue <int> > ::value);
+		TS_ASSERT_EQUALS(5050, enqueueAndDequeueAll(arrayQueue, 100));
+		TS_ASSERT_EQUALS(5050, enqueueAndDequeueAll(chunkedQueue, 100));
+		
+		TS_ASSERT(arrayQueue.isEmpty());
+		TS_ASSERT(chunkedQueue.isEmpty());
+	}
+
+	/**
+	 * Implementation chosen at runtime through the adapters.
+	 */
+	public: void test_adapters()
+	{
+		for (int kind = 0; kind < 2; kind++)
+		{
+			Stack <int> *stack;
+			Queue <int> *queue;
+			
+			if (kind == 0)
+			{
+				stack = new StackAdapter <ArrayStack <int> > (10);
+				queue = new QueueAdapter <ArrayQueue <int> > (10);
+			}
+			else
+			{
+				stack = new StackAdapter <ListStack <int> > ();
+				queue = new QueueAdapter <ChunkedListQueue <int, 4> > ();
+			}
+			
+			for (int i = 0; i < 10; i++)
+			{
+				stack->push(i);
+				queue->enqueue(i);
+			}
+			
+			TS_ASSERT_EQUALS(10u, stack->getSize());
+			TS_ASSERT_EQUALS(9, stack->peek());
+			TS_ASSERT_EQUALS(0, queue->peek());
+			
+			for (int i = 0; i < 10; i++)
+			{
+				TS_ASSERT_EQUALS(9 - i, stack->pop());
+				TS_ASSERT_EQUALS(i, queue->dequeue());
+			}
+			
+			TS_ASSERT(stack->isEmpty());
+			TS_ASSERT(queue->isEmpty());
+			
+			delete stack;
+			delete queue;
+		}
+		
+		QueueAdapter <ArrayQueue <int> > adapter(4);
+		adapter.getQueue().pushFront(7);
+		TS_ASSERT_EQUALS(7, adapter.dequeue());
+	}
+}
+
+
 }
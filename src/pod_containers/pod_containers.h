@@ -4,9 +4,17 @@
 
 
 #include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/sort.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
 
 #ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
 #include <concepts>
@@ -59,6 +67,15 @@ class PodContainer
 		}
 	}
 
+	/**
+	 * Node of unrolled (chunked) lists: it stores up to TPL_Chunk_CAPACITY elements.
+	 */
+	protected: template <std::size_t TPL_Chunk_CAPACITY> struct Chunk
+	{
+		public: Chunk *next;
+		public: TPL_PodContainer_T data[TPL_Chunk_CAPACITY];
+	}
+
 
 	/**
 	 * Creates a byte-by-byte copy of an array.
@@ -79,6 +96,121 @@ class PodContainer
 	}
 }
 
+/**
+ * Pool of free nodes of linked lists, separate for every thread, so that
+ * it needs no locks. Nodes released to the pool are kept in a list linked
+ * by their next pointers (up to MAX_FREE_COUNT of them) and reused by the
+ * next allocation in the same thread. A node may be released by another
+ * thread than the one which allocated it. After the pool of a thread is
+ * destroyed at the thread exit, nodes are allocated and deleted directly,
+ * so that containers destroyed later (e.g. other thread_local ones) still
+ * may release their nodes.
+ *
+ * @param TPL_NodePool_Node Trivial type with member next.
+ */
+template <typename TPL_NodePool_Node> class NodePool
+{
+	public: static const std::size_t MAX_FREE_COUNT = 64;
+
+
+	private: struct FreeList
+	{
+		public: TPL_NodePool_Node *first = nullptr;
+		public: std::size_t size = 0;
+
+
+		public: ~FreeList()
+		{
+			while (this->first != nullptr)
+			{
+				TPL_NodePool_Node *next = this->first->next;
+				delete this->first;
+				this->first = next;
+			}
+			
+			NodePool::isFreeListDestroyed() = true;
+		}
+	}
+
+
+	/**
+	 * Returns uninitialized node.
+	 */
+	public: static TPL_NodePool_Node *allocate()
+	{
+		if (NodePool::isFreeListDestroyed())
+		{
+			return new TPL_NodePool_Node;
+		}
+		
+		FreeList &freeList = NodePool::getFreeList();
+		
+		if (freeList.first == nullptr)
+		{
+			return new TPL_NodePool_Node;
+		}
+		
+		TPL_NodePool_Node *res = freeList.first;
+		freeList.first = res->next;
+		freeList.size--;
+		
+		return res;
+	}
+
+	public: static void release(TPL_NodePool_Node *node)
+	{
+		if (NodePool::isFreeListDestroyed())
+		{
+			delete node;
+			return;
+		}
+		
+		FreeList &freeList = NodePool::getFreeList();
+		
+		if (freeList.size >= NodePool::MAX_FREE_COUNT)
+		{
+			delete node;
+			return;
+		}
+		
+		node->next = freeList.first;
+		freeList.first = node;
+		freeList.size++;
+	}
+
+	/**
+	 * Returns number of free nodes in the pool of the current thread.
+	 */
+	public: static std::size_t getFreeCount()
+	{
+		return NodePool::isFreeListDestroyed() ? 0 : NodePool::getFreeList().size;
+	}
+
+	private: static FreeList &getFreeList()
+	{
+		static thread_local FreeList freeList;
+		return freeList;
+	}
+
+	/**
+	 * Trivially destructible, so it may be read until the thread ends.
+	 */
+	private: static bool &isFreeListDestroyed()
+	{
+		static thread_local bool res = false;
+		return res;
+	}
+}
+
+/**
+ * Returns default number of elements of size elementSize in a node of
+ * chunked lists: the node takes about 1 KiB.
+ */
+constexpr std::size_t getDefaultChunkCapacity(std::size_t elementSize)
+{
+	return elementSize >= 1024 / 16 ? 16 : 1024 / elementSize;
+}
+
 /**
  * Abstract class representing a queue.
  */
@@ -150,6 +282,229 @@ template <typename TPL_Stack_T> class Stack: public PodContainer <TPL_Stack_T>
 	public: virtual std::size_t getSize() const = 0;
 }
 
+/**
+ * Base class of queues with static polymorphism (curiously recurring
+ * template pattern): it has the methods of Queue, but they are not virtual
+ * and call the methods of TPL_StaticQueue_Derived, which must define all
+ * of them. Generic code taking StaticQueue <D, T> & (or the concrete
+ * class) calls them directly, so they can be inlined. QueueAdapter makes
+ * a Queue of any static queue where runtime polymorphism is needed.
+ */
+template <typename TPL_StaticQueue_Derived, typename TPL_StaticQueue_T> class StaticQueue: public PodContainer <TPL_StaticQueue_T>
+{
+	public: typedef TPL_StaticQueue_T value_type;
+
+
+	public: void enqueue(const TPL_StaticQueue_T &element)
+	{
+		this->getDerived().enqueue(element);
+	}
+
+	public: TPL_StaticQueue_T dequeue()
+	{
+		return this->getDerived().dequeue();
+	}
+
+	public: TPL_StaticQueue_T peek() const
+	{
+		return this->getDerived().peek();
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->getDerived().isEmpty();
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->getDerived().getSize();
+	}
+
+	/**
+	 * Static queues are not deleted through the base class.
+	 */
+	protected: ~StaticQueue()
+	{
+		//nothing
+	}
+
+	private: TPL_StaticQueue_Derived &getDerived()
+	{
+		return static_cast <TPL_StaticQueue_Derived&> (*this);
+	}
+
+	private: TPL_StaticQueue_Derived const &getDerived() const
+	{
+		return static_cast <TPL_StaticQueue_Derived const &> (*this);
+	}
+}
+
+/**
+ * Base class of stacks with static polymorphism, see StaticQueue.
+ * StackAdapter makes a Stack of any static stack.
+ */
+template <typename TPL_StaticStack_Derived, typename TPL_StaticStack_T> class StaticStack: public PodContainer <TPL_StaticStack_T>
+{
+	public: typedef TPL_StaticStack_T value_type;
+
+
+	public: void push(const TPL_StaticStack_T &element)
+	{
+		this->getDerived().push(element);
+	}
+
+	public: TPL_StaticStack_T pop()
+	{
+		return this->getDerived().pop();
+	}
+
+	public: TPL_StaticStack_T peek() const
+	{
+		return this->getDerived().peek();
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->getDerived().isEmpty();
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->getDerived().getSize();
+	}
+
+	/**
+	 * Static stacks are not deleted through the base class.
+	 */
+	protected: ~StaticStack()
+	{
+		//nothing
+	}
+
+	private: TPL_StaticStack_Derived &getDerived()
+	{
+		return static_cast <TPL_StaticStack_Derived&> (*this);
+	}
+
+	private: TPL_StaticStack_Derived const &getDerived() const
+	{
+		return static_cast <TPL_StaticStack_Derived const &> (*this);
+	}
+}
+
+/**
+ * Queue (with virtual methods) containing a static queue, for code which
+ * chooses the implementation at runtime.
+ *
+ * @param TPL_QueueAdapter_Queue Class derived from StaticQueue.
+ */
+template <typename TPL_QueueAdapter_Queue> class QueueAdapter: public Queue <typename TPL_QueueAdapter_Queue::value_type>
+{
+	private: typedef typename TPL_QueueAdapter_Queue::value_type value_type;
+
+
+	private: TPL_QueueAdapter_Queue queue;
+
+
+	/**
+	 * Constructs the contained queue from the arguments.
+	 */
+	public: template <typename... TPL_Args> QueueAdapter(TPL_Args &&... args):
+			queue(std::forward <TPL_Args> (args)...)
+	{
+		//nothing
+	}
+
+	public: void enqueue(const value_type &element)
+	{
+		this->queue.enqueue(element);
+	}
+
+	public: value_type dequeue()
+	{
+		return this->queue.dequeue();
+	}
+
+	public: value_type peek() const
+	{
+		return this->queue.peek();
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->queue.isEmpty();
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->queue.getSize();
+	}
+
+	/**
+	 * Returns the contained queue, for its other methods.
+	 */
+	public: TPL_QueueAdapter_Queue &getQueue()
+	{
+		return this->queue;
+	}
+}
+
+/**
+ * Stack (with virtual methods) containing a static stack, see QueueAdapter.
+ *
+ * @param TPL_StackAdapter_Stack Class derived from StaticStack.
+ */
+template <typename TPL_StackAdapter_Stack> class StackAdapter: public Stack <typename TPL_StackAdapter_Stack::value_type>
+{
+	private: typedef typename TPL_StackAdapter_Stack::value_type value_type;
+
+
+	private: TPL_StackAdapter_Stack stack;
+
+
+	/**
+	 * Constructs the contained stack from the arguments.
+	 */
+	public: template <typename... TPL_Args> StackAdapter(TPL_Args &&... args):
+			stack(std::forward <TPL_Args> (args)...)
+	{
+		//nothing
+	}
+
+	public: void push(const value_type &element)
+	{
+		this->stack.push(element);
+	}
+
+	public: value_type pop()
+	{
+		return this->stack.pop();
+	}
+
+	public: value_type peek() const
+	{
+		return this->stack.peek();
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->stack.isEmpty();
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->stack.getSize();
+	}
+
+	/**
+	 * Returns the contained stack, for its other methods.
+	 */
+	public: TPL_StackAdapter_Stack &getStack()
+	{
+		return this->stack;
+	}
+}
+
 /**
  * Class representing a priority queue. The priority of elements in the
  * queue is determined by strict weak ordering relation swoCompare(a, b).
@@ -225,10 +580,15 @@ class PriorityQueue: public PodContainer <TPL_PriorityQueue_T>
 		delete[] this->arr;
 	}
 
+	/**
+	 * The heap property is checked only if EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
+	 * is defined, because it takes O(n) time on every operation.
+	 */
 	private: bool invariant() const
 	{
 		assert(this->arr != nullptr && this->size <= this->capacity);
 		
+		#ifdef EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
 		for (std::size_t i = 0; i < this->size; i++)
 		{
 			std::size_t lc = PriorityQueue::getLeftChild(i), rc = PriorityQueue::getRightChild(i);
@@ -243,6 +603,7 @@ class PriorityQueue: public PodContainer <TPL_PriorityQueue_T>
 				assert(!this->swoCompare(this->arr[i], this->arr[rc]));
 			}
 		}
+		#endif
 		
 		return true;
 	}
@@ -306,6 +667,84 @@ class PriorityQueue: public PodContainer <TPL_PriorityQueue_T>
 		return res;
 	}
 
+	/**
+	 * Adds elements [first; last) to the queue. If there are many of them
+	 * compared to the queue, the heap is rebuilt bottom-up in O(n + k)
+	 * time instead of k insertions in O(k * log(n + k)) time.
+	 * Queue must have room for the elements.
+	 */
+	public: template <typename TPL_InputIterator> void insertRange(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		assert(this->invariant());
+		
+		std::size_t oldSize = this->size;
+		
+		for ( ; first != last; ++first)
+		{
+			assert(this->size < this->capacity);
+			this->arr[this->size++] = *first;
+		}
+		
+		std::size_t count = this->size - oldSize, depth = 0;
+		
+		for (std::size_t i = this->size; i > 1; i /= 2)
+		{
+			depth++;
+		}
+		
+		// bottom-up construction takes at most 2 * size comparisons
+		if (count * depth > 2 * this->size)
+		{
+			for (std::size_t i = this->size / 2; i-- > 0; )
+			{
+				heapify(this->arr, this->arr + this->size, this->arr + i, this->swoCompare);
+			}
+		}
+		else
+		{
+			std::size_t size = this->size;
+			
+			for (this->size = oldSize; this->size < size; )
+			{
+				TPL_PriorityQueue_T element = this->arr[this->size];
+				this->insert(element);
+			}
+		}
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Deletes count elements with the highest priorities and writes them
+	 * to out in order of decreasing priority.
+	 * Queue must have at least count elements.
+	 *
+	 * @return Iterator behind the last written element.
+	 */
+	public: template <typename TPL_OutputIterator> TPL_OutputIterator extractN(std::size_t count, TPL_OutputIterator out)
+	{
+		assert(count <= this->size);
+		
+		for (std::size_t i = 0; i < count; i++)
+		{
+			*out++ = this->extract();
+		}
+		
+		return out;
+	}
+
+	/**
+	 * Moves all elements of other queue to this queue.
+	 * Queue must have room for the elements.
+	 */
+	public: void meld(PriorityQueue &other)
+	{
+		assert(this != &other);
+		
+		this->insertRange(other.arr, other.arr + other.size);
+		other.size = 0;
+	}
+
 	/**
 	 * Returns element at the head of the queue (element
 	 * with the highest priority), but doesn't remove it.
@@ -349,12 +788,198 @@ class PriorityQueue: public PodContainer <TPL_PriorityQueue_T>
 }
 
 /**
- * Stack implementation using array.
+ * Loser tree (tournament tree) for k-way merging: it holds one current key
+ * of each of k sources and finds the least of them. Replacing the key of
+ * the winner replays ceil(log2(k)) matches along the path from its leaf to
+ * the root, with no matches against siblings. A match compares the keys
+ * once, or twice when the first comparison leaves a tie possible, so the
+ * replay takes at most 2 * ceil(log2(k)) comparisons.
+ *
+ * Every internal node stores the source which lost the match there; the
+ * overall winner is stored separately. Sources that are exhausted lose
+ * every match. Keys which are equivalent are won by the source with the
+ * smaller index, so merging runs in order of their indexes is stable.
+ *
+ * @param TPL_LoserTree_StrictWeakOrdering The winner is the least key.
  */
-template <typename TPL_ArrayStack_T> class ArrayStack: public Stack <TPL_ArrayStack_T>
+template <typename TPL_LoserTree_T, class TPL_LoserTree_StrictWeakOrdering = std::less <TPL_LoserTree_T> >
+#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+requires std::StrictWeakOrder <TPL_LoserTree_StrictWeakOrdering, TPL_LoserTree_T>
+#endif
+class LoserTree: public PodContainer <TPL_LoserTree_T>
 {
-	private: TPL_ArrayStack_T *arr;
-	private: std::size_t capacity, size;
+	#ifndef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_LoserTree_StrictWeakOrdering, TPL_LoserTree_T>));
+	#endif
+
+
+	private: TPL_LoserTree_StrictWeakOrdering swoCompare;
+
+	/**
+	 * keys[i] is the current key of source i, valid if !isExhausted[i].
+	 */
+	private: std::vector <TPL_LoserTree_T> keys;
+	private: std::vector <char> isExhausted;
+
+	/**
+	 * losers[0] is the winner, losers[1..k) are losers of the matches at
+	 * internal nodes; leaf of source i is node k + i, parent of node j is j / 2.
+	 */
+	private: std::vector <std::size_t> losers;
+
+
+	/**
+	 * Creates tree of sourceCount exhausted sources.
+	 *
+	 * @param sourceCount k > 0.
+	 */
+	public: LoserTree(std::size_t sourceCount, TPL_LoserTree_StrictWeakOrdering swoCompare = TPL_LoserTree_StrictWeakOrdering()):
+			swoCompare(swoCompare),
+			keys(sourceCount),
+			isExhausted(sourceCount, 1),
+			losers(sourceCount, 0)
+	{
+		assert(sourceCount > 0);
+	}
+
+	/**
+	 * Sets the initial key of a source. Call build() after all sources are set.
+	 */
+	public: void set(std::size_t source, TPL_LoserTree_T const &key)
+	{
+		assert(source < this->keys.size());
+		this->keys[source] = key;
+		this->isExhausted[source] = 0;
+	}
+
+	/**
+	 * Plays all matches.
+	 *
+	 * @time O(k)
+	 */
+	public: void build()
+	{
+		std::size_t k = this->keys.size();
+		std::vector <std::size_t> winners(2 * k);
+		
+		for (std::size_t i = 0; i < k; i++)
+		{
+			winners[k + i] = i;
+		}
+		
+		for (std::size_t node = k - 1; node >= 1; node--)
+		{
+			std::size_t a = winners[2 * node], b = winners[2 * node + 1];
+			
+			if (this->beats(a, b))
+			{
+				winners[node] = a;
+				this->losers[node] = b;
+			}
+			else
+			{
+				winners[node] = b;
+				this->losers[node] = a;
+			}
+		}
+		
+		this->losers[0] = k == 1 ? 0 : winners[1];
+	}
+
+	/**
+	 * Returns true if all sources are exhausted.
+	 */
+	public: bool isEmpty() const
+	{
+		return this->isExhausted[this->losers[0]] != 0;
+	}
+
+	/**
+	 * Returns index of the source with the least key.
+	 */
+	public: std::size_t getWinner() const
+	{
+		return this->losers[0];
+	}
+
+	/**
+	 * Returns the least key.
+	 */
+	public: TPL_LoserTree_T const &peek() const
+	{
+		assert(!this->isEmpty());
+		return this->keys[this->losers[0]];
+	}
+
+	/**
+	 * Replaces key of the winner with the next key of its source.
+	 *
+	 * @time O(log(k))
+	 */
+	public: void replaceWinner(TPL_LoserTree_T const &key)
+	{
+		assert(!this->isEmpty());
+		this->keys[this->losers[0]] = key;
+		this->replay();
+	}
+
+	/**
+	 * Marks the source of the winner as exhausted.
+	 *
+	 * @time O(log(k))
+	 */
+	public: void removeWinner()
+	{
+		assert(!this->isEmpty());
+		this->isExhausted[this->losers[0]] = 1;
+		this->replay();
+	}
+
+	/**
+	 * Plays the matches on the path from the leaf of the winner to the root.
+	 */
+	private: void replay()
+	{
+		std::size_t k = this->keys.size();
+		std::size_t winner = this->losers[0];
+		
+		for (std::size_t node = (k + winner) / 2; node >= 1; node /= 2)
+		{
+			if (this->beats(this->losers[node], winner))
+			{
+				std::swap(this->losers[node], winner);
+			}
+		}
+		
+		this->losers[0] = winner;
+	}
+
+	/**
+	 * Returns true if source a wins the match against source b.
+	 */
+	private: bool beats(std::size_t a, std::size_t b)
+	{
+		if (this->isExhausted[a] || this->isExhausted[b])
+		{
+			return !this->isExhausted[a] || (this->isExhausted[b] && a < b);
+		}
+		
+		if (this->swoCompare(this->keys[a], this->keys[b]))
+		{
+			return true;
+		}
+		
+		return a < b && !this->swoCompare(this->keys[b], this->keys[a]);
+	}
+}
+
+/**
+ * Stack implementation using array.
+ */
+template <typename TPL_ArrayStack_T> class ArrayStack: public StaticStack <ArrayStack <TPL_ArrayStack_T>, TPL_ArrayStack_T>
+{
+	private: TPL_ArrayStack_T *arr;
+	private: std::size_t capacity, size;
 
 
 	/**
@@ -379,7 +1004,7 @@ template <typename TPL_ArrayStack_T> class ArrayStack: public Stack <TPL_ArraySt
 		assert(this->invariant());
 	}
 
-	public: virtual ~ArrayStack()
+	public: ~ArrayStack()
 	{
 		delete[] this->arr;
 	}
@@ -426,7 +1051,7 @@ template <typename TPL_ArrayStack_T> class ArrayStack: public Stack <TPL_ArraySt
 /**
  * Queue implementation using array.
  */
-template <typename TPL_ArrayQueue_T> class ArrayQueue: public Queue <TPL_ArrayQueue_T>
+template <typename TPL_ArrayQueue_T> class ArrayQueue: public StaticQueue <ArrayQueue <TPL_ArrayQueue_T>, TPL_ArrayQueue_T>
 {
 	private: TPL_ArrayQueue_T *arr;
 	private: std::size_t first, capacity, size;
@@ -456,7 +1081,7 @@ template <typename TPL_ArrayQueue_T> class ArrayQueue: public Queue <TPL_ArrayQu
 		assert(this->invariant());
 	}
 	
-	public: virtual ~ArrayQueue()
+	public: ~ArrayQueue()
 	{
 		delete[] this->arr;
 	}
@@ -491,73 +1116,553 @@ template <typename TPL_ArrayQueue_T> class ArrayQueue: public Queue <TPL_ArrayQu
 
 	public: TPL_ArrayQueue_T peek() const
 	{
-		assert(this->invariant());
-		assert(this->size > 0);
-		return this->arr[this->first];
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[this->first];
+	}
+
+	/**
+	 * Adds element to the head (or the front) of the queue.
+	 */
+	public: void pushFront(const TPL_ArrayQueue_T &element)
+	{
+		assert(this->invariant());
+		assert(this->size < this->capacity);
+		
+		if (this->first == 0)
+		{
+			this->first = this->capacity - 1;
+		}
+		else
+		{
+			this->first = this->first - 1;
+		}
+		
+		this->arr[this->first] = element;
+		this->size++;
+	}
+
+	/**
+	 * Removes element at the end of the queue.
+	 * 
+	 * @return The removed element.
+	 */
+	public: TPL_ArrayQueue_T popLast()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		this->size--;
+		assert(this->invariant());
+		TPL_ArrayQueue_T element = this->arr[(this->first + this->size) % this->capacity];
+		return element;
+	}
+
+	/**
+	 * Returns element at the end of the queue,
+	 * but doesn't remove it.
+	 */
+	public: TPL_ArrayQueue_T peekLast() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[(this->first + this->size - 1) % this->capacity];
+	}
+
+	public: bool isEmpty() const
+	{
+		return (this->size == 0);
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+}
+
+/**
+ * Stack implementation using array which grows when it is full. The array
+ * is allocated by std::malloc, so that it can be relocated by std::realloc
+ * (elements are POD, so moving their bytes is enough).
+ */
+template <typename TPL_GrowableArrayStack_T> class GrowableArrayStack: public StaticStack <GrowableArrayStack <TPL_GrowableArrayStack_T>, TPL_GrowableArrayStack_T>
+{
+	public: static const std::size_t MIN_CAPACITY = 16;
+
+
+	private: TPL_GrowableArrayStack_T *arr;
+	private: std::size_t capacity, size;
+
+
+	/**
+	 * Constructs new empty stack.
+	 * 
+	 * @param capacity Number of elements stack can store without
+	 *		reallocation.
+	 */
+	public: GrowableArrayStack(std::size_t capacity = 0)
+	{
+		this->arr = nullptr;
+		this->capacity = 0;
+		this->size = 0;
+		this->reserve(capacity);
+		assert(this->invariant());
+	}
+
+	public: GrowableArrayStack(GrowableArrayStack const &other):
+			GrowableArrayStack(other.size)
+	{
+		this->pushRange(other.arr, other.size);
+	}
+
+	public: GrowableArrayStack &operator=(GrowableArrayStack const &other)
+	{
+		if (this != &other)
+		{
+			this->size = 0;
+			this->pushRange(other.arr, other.size);
+		}
+		
+		return *this;
+	}
+
+	public: ~GrowableArrayStack()
+	{
+		std::free(this->arr);
+	}
+
+	private: bool invariant() const
+	{
+		assert((this->arr != nullptr || this->capacity == 0) && this->size <= this->capacity);
+		return true;
+	}
+
+	public: void push(const TPL_GrowableArrayStack_T &element)
+	{
+		assert(this->invariant());
+		
+		if (this->size == this->capacity)
+		{
+			// the element may be stored in the array which is relocated
+			TPL_GrowableArrayStack_T copy = element;
+			this->reserve(std::max(2 * this->capacity, (std::size_t) GrowableArrayStack::MIN_CAPACITY));
+			this->arr[this->size++] = copy;
+			return;
+		}
+		
+		this->arr[this->size++] = element;
+	}
+
+	public: TPL_GrowableArrayStack_T pop()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[--this->size];
+	}
+
+	public: TPL_GrowableArrayStack_T peek() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[this->size - 1];
+	}
+
+	/**
+	 * Pushes elements in the given order (the last one ends on the top)
+	 * with one copy of the block, growing the array at most once.
+	 * 
+	 * @param elements Elements to push, they mustn't be stored in this stack.
+	 * @time O(count) amortized
+	 */
+	public: void pushRange(const TPL_GrowableArrayStack_T *elements, std::size_t count)
+	{
+		assert(this->invariant());
+		
+		if (this->size + count > this->capacity)
+		{
+			this->reserve(std::max(this->size + count, 2 * this->capacity));
+		}
+		
+		if (count > 0)
+		{
+			std::memcpy(this->arr + this->size, elements, count * sizeof(TPL_GrowableArrayStack_T));
+			this->size += count;
+		}
+	}
+
+	/**
+	 * Pops the top count elements with one copy of the block. They are
+	 * written in the order in which they were pushed, so that popRange
+	 * reverses pushRange.
+	 * 
+	 * @param out Array of at least count elements.
+	 * @time O(count)
+	 */
+	public: void popRange(TPL_GrowableArrayStack_T *out, std::size_t count)
+	{
+		assert(this->invariant());
+		assert(count <= this->size);
+		this->size -= count;
+		
+		if (count > 0)
+		{
+			std::memcpy(out, this->arr + this->size, count * sizeof(TPL_GrowableArrayStack_T));
+		}
+	}
+
+	public: bool isEmpty() const
+	{
+		return (this->size == 0);
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/**
+	 * Makes the capacity at least the given one.
+	 * 
+	 * @throws std::bad_alloc If memory can't be allocated; the stack is
+	 *		unchanged then.
+	 */
+	public: void reserve(std::size_t capacity)
+	{
+		if (capacity > this->capacity)
+		{
+			this->relocate(capacity);
+		}
+	}
+
+	/**
+	 * Reduces the capacity to the size, freeing the array if the stack is
+	 * empty.
+	 */
+	public: void shrinkToFit()
+	{
+		assert(this->invariant());
+		
+		if (this->size == 0)
+		{
+			std::free(this->arr);
+			this->arr = nullptr;
+			this->capacity = 0;
+		}
+		else if (this->size < this->capacity)
+		{
+			this->relocate(this->size);
+		}
+		
+		assert(this->invariant());
+	}
+
+	private: void relocate(std::size_t capacity)
+	{
+		assert(capacity >= this->size && capacity > 0);
+		void *arr = std::realloc(this->arr, capacity * sizeof(TPL_GrowableArrayStack_T));
+		
+		if (arr == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		
+		this->arr = (TPL_GrowableArrayStack_T*) arr;
+		this->capacity = capacity;
+	}
+}
+
+/**
+ * Queue (and deque) implementation using circular array which grows when
+ * it is full. On relocation, the elements are copied with at most two
+ * block copies to the beginning of the new array.
+ */
+template <typename TPL_GrowableArrayQueue_T> class GrowableArrayQueue: public StaticQueue <GrowableArrayQueue <TPL_GrowableArrayQueue_T>, TPL_GrowableArrayQueue_T>
+{
+	public: static const std::size_t MIN_CAPACITY = 16;
+
+
+	private: TPL_GrowableArrayQueue_T *arr;
+	private: std::size_t first, capacity, size;
+
+
+	/**
+	 * Constructs new empty queue.
+	 * 
+	 * @param capacity Number of elements queue can store without
+	 *		reallocation.
+	 */
+	public: GrowableArrayQueue(std::size_t capacity = 0)
+	{
+		this->arr = nullptr;
+		this->first = 0;
+		this->capacity = 0;
+		this->size = 0;
+		this->reserve(capacity);
+		assert(this->invariant());
+	}
+
+	public: GrowableArrayQueue(GrowableArrayQueue const &other):
+			GrowableArrayQueue(other.size)
+	{
+		other.copyTo(this->arr, other.size);
+		this->size = other.size;
+	}
+
+	public: GrowableArrayQueue &operator=(GrowableArrayQueue const &other)
+	{
+		if (this != &other)
+		{
+			this->first = 0;
+			this->size = 0;
+			this->reserve(other.size);
+			other.copyTo(this->arr, other.size);
+			this->size = other.size;
+		}
+		
+		return *this;
+	}
+
+	public: ~GrowableArrayQueue()
+	{
+		std::free(this->arr);
+	}
+
+	private: bool invariant() const
+	{
+		assert((this->arr != nullptr || this->capacity == 0) && this->size <= this->capacity);
+		assert(this->first < this->capacity || this->first == 0);
+		return true;
+	}
+
+	public: void enqueue(const TPL_GrowableArrayQueue_T &element)
+	{
+		assert(this->invariant());
+		
+		if (this->size == this->capacity)
+		{
+			TPL_GrowableArrayQueue_T copy = element;
+			this->grow();
+			this->arr[this->getIndex(this->size++)] = copy;
+			return;
+		}
+		
+		this->arr[this->getIndex(this->size++)] = element;
+	}
+
+	public: TPL_GrowableArrayQueue_T dequeue()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		TPL_GrowableArrayQueue_T element = this->arr[this->first];
+		this->first = this->getIndex(1);
+		this->size--;
+		return element;
+	}
+
+	public: TPL_GrowableArrayQueue_T peek() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[this->first];
+	}
+
+	/**
+	 * Adds element to the head (or the front) of the queue.
+	 */
+	public: void pushFront(const TPL_GrowableArrayQueue_T &element)
+	{
+		assert(this->invariant());
+		TPL_GrowableArrayQueue_T copy = element;
+		
+		if (this->size == this->capacity)
+		{
+			this->grow();
+		}
+		
+		this->first = (this->first == 0 ? this->capacity : this->first) - 1;
+		this->arr[this->first] = copy;
+		this->size++;
+	}
+
+	/**
+	 * Removes element at the end of the queue.
+	 * 
+	 * @return The removed element.
+	 */
+	public: TPL_GrowableArrayQueue_T popLast()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[this->getIndex(--this->size)];
+	}
+
+	/**
+	 * Returns element at the end of the queue,
+	 * but doesn't remove it.
+	 */
+	public: TPL_GrowableArrayQueue_T peekLast() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[this->getIndex(this->size - 1)];
+	}
+
+	/**
+	 * Enqueues elements in the given order with at most two block copies,
+	 * growing the array at most once.
+	 * 
+	 * @param elements Elements to enqueue, they mustn't be stored in this queue.
+	 * @time O(count) amortized
+	 */
+	public: void enqueueRange(const TPL_GrowableArrayQueue_T *elements, std::size_t count)
+	{
+		assert(this->invariant());
+		
+		if (this->size + count > this->capacity)
+		{
+			this->reserve(std::max(this->size + count, 2 * this->capacity));
+		}
+		
+		if (count == 0)
+		{
+			return;
+		}
+		
+		std::size_t last = this->getIndex(this->size);
+		std::size_t head = std::min(count, this->capacity - last);
+		std::memcpy(this->arr + last, elements, head * sizeof(TPL_GrowableArrayQueue_T));
+		std::memcpy(this->arr, elements + head, (count - head) * sizeof(TPL_GrowableArrayQueue_T));
+		this->size += count;
+	}
+
+	/**
+	 * Dequeues count elements with at most two block copies.
+	 * 
+	 * @param out Array of at least count elements.
+	 * @time O(count)
+	 */
+	public: void dequeueRange(TPL_GrowableArrayQueue_T *out, std::size_t count)
+	{
+		assert(this->invariant());
+		assert(count <= this->size);
+		
+		if (count == 0)
+		{
+			return;
+		}
+		
+		this->copyTo(out, count);
+		this->first = this->getIndex(count);
+		this->size -= count;
+	}
+
+	public: bool isEmpty() const
+	{
+		return (this->size == 0);
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/**
+	 * Makes the capacity at least the given one.
+	 * 
+	 * @throws std::bad_alloc If memory can't be allocated; the queue is
+	 *		unchanged then.
+	 */
+	public: void reserve(std::size_t capacity)
+	{
+		if (capacity > this->capacity)
+		{
+			this->relocate(capacity);
+		}
 	}
 
 	/**
-	 * Adds element to the head (or the front) of the queue.
+	 * Reduces the capacity to the size, freeing the array if the queue is
+	 * empty.
 	 */
-	public: void pushFront(const TPL_ArrayQueue_T &element)
+	public: void shrinkToFit()
 	{
 		assert(this->invariant());
-		assert(this->size < this->capacity);
 		
-		if (this->first == 0)
+		if (this->size == 0)
 		{
-			this->first = this->capacity - 1;
+			std::free(this->arr);
+			this->arr = nullptr;
+			this->first = 0;
+			this->capacity = 0;
 		}
-		else
+		else if (this->size < this->capacity)
 		{
-			this->first = this->first - 1;
+			this->relocate(this->size);
 		}
 		
-		this->arr[this->first] = element;
-		this->size++;
+		assert(this->invariant());
 	}
 
 	/**
-	 * Removes element at the end of the queue.
-	 * 
-	 * @return The removed element.
+	 * Returns index in the array of the element at the given position
+	 * from the head, for position at most the capacity.
 	 */
-	public: TPL_ArrayQueue_T popLast()
+	private: std::size_t getIndex(std::size_t position) const
 	{
-		assert(this->invariant());
-		assert(this->size > 0);
-		this->size--;
-		assert(this->invariant());
-		TPL_ArrayQueue_T element = this->arr[(this->first + this->size) % this->capacity];
-		return element;
+		std::size_t index = this->first + position;
+		return (index >= this->capacity ? index - this->capacity : index);
 	}
 
 	/**
-	 * Returns element at the end of the queue,
-	 * but doesn't remove it.
+	 * Copies the first count elements to out with at most two block copies.
 	 */
-	public: TPL_ArrayQueue_T peekLast() const
+	private: void copyTo(TPL_GrowableArrayQueue_T *out, std::size_t count) const
 	{
-		assert(this->invariant());
-		assert(this->size > 0);
-		return this->arr[(this->first + this->size - 1) % this->capacity];
+		std::size_t head = std::min(count, this->capacity - this->first);
+		
+		if (count > 0)
+		{
+			std::memcpy(out, this->arr + this->first, head * sizeof(TPL_GrowableArrayQueue_T));
+			std::memcpy(out + head, this->arr, (count - head) * sizeof(TPL_GrowableArrayQueue_T));
+		}
 	}
 
-	public: bool isEmpty() const
+	private: void grow()
 	{
-		return (this->size == 0);
+		this->relocate(std::max(2 * this->capacity, (std::size_t) GrowableArrayQueue::MIN_CAPACITY));
 	}
 
-	public: std::size_t getSize() const
+	private: void relocate(std::size_t capacity)
 	{
-		return this->size;
+		assert(capacity >= this->size && capacity > 0);
+		void *arr = std::malloc(capacity * sizeof(TPL_GrowableArrayQueue_T));
+		
+		if (arr == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		
+		this->copyTo((TPL_GrowableArrayQueue_T*) arr, this->size);
+		std::free(this->arr);
+		this->arr = (TPL_GrowableArrayQueue_T*) arr;
+		this->first = 0;
+		this->capacity = capacity;
 	}
 }
 
 /**
  * Stack implementation using linked list.
  */
-template <typename TPL_ListStack_T> class ListStack: public Stack <TPL_ListStack_T>
+template <typename TPL_ListStack_T> class ListStack: public StaticStack <ListStack <TPL_ListStack_T>, TPL_ListStack_T>
 {
 	private: struct ListElement *stackptr;
 	private: std::size_t size;
@@ -596,7 +1701,7 @@ template <typename TPL_ListStack_T> class ListStack: public Stack <TPL_ListStack
 		assert(this->invariant());
 	}
 
-	public: virtual ~ListStack()
+	public: ~ListStack()
 	{
 		ListElement *tmp;
 		while (this->stackptr != nullptr)
@@ -681,7 +1786,7 @@ template <typename TPL_ListStack_T> class ListStack: public Stack <TPL_ListStack
 /**
  * Queue implementation using linked list.
  */
-template <typename TPL_ListQueue_T> class ListQueue: public Queue <TPL_ListQueue_T>
+template <typename TPL_ListQueue_T> class ListQueue: public StaticQueue <ListQueue <TPL_ListQueue_T>, TPL_ListQueue_T>
 {
 	private: struct ListElement *first, *last;
 	private: std::size_t size;
@@ -720,7 +1825,7 @@ template <typename TPL_ListQueue_T> class ListQueue: public Queue <TPL_ListQueue
 		assert(this->invariant());
 	}
 
-	public: virtual ~ListQueue()
+	public: ~ListQueue()
 	{
 		ListElement *tmp;
 		while (this->first != nullptr)
@@ -822,6 +1927,360 @@ template <typename TPL_ListQueue_T> class ListQueue: public Queue <TPL_ListQueue
 	}
 }
 
+/**
+ * Stack implementation using unrolled linked list: every node (chunk)
+ * stores up to CHUNK_CAPACITY elements, so push() and pop() take a node
+ * from the thread's NodePool or return it only once per CHUNK_CAPACITY
+ * elements, and elements are copied in contiguous blocks.
+ */
+template <typename TPL_ChunkedListStack_T, std::size_t TPL_ChunkedListStack_CHUNK_CAPACITY = getDefaultChunkCapacity(sizeof(TPL_ChunkedListStack_T))> class ChunkedListStack: public StaticStack <ChunkedListStack <TPL_ChunkedListStack_T, TPL_ChunkedListStack_CHUNK_CAPACITY>, TPL_ChunkedListStack_T>
+{
+	static_assert(TPL_ChunkedListStack_CHUNK_CAPACITY > 0, "chunk capacity must be positive");
+
+
+	public: static const std::size_t CHUNK_CAPACITY = TPL_ChunkedListStack_CHUNK_CAPACITY;
+
+
+	private: typedef typename PodContainer <TPL_ChunkedListStack_T> ::template Chunk <TPL_ChunkedListStack_CHUNK_CAPACITY> Chunk;
+	private: typedef NodePool <Chunk> Pool;
+
+
+	/**
+	 * The top chunk holds topCount elements, all the others are full.
+	 */
+	private: Chunk *top;
+	private: std::size_t topCount;
+	private: std::size_t size;
+
+
+	public: ChunkedListStack():
+			top(nullptr),
+			topCount(0),
+			size(0)
+	{
+		//nothing
+	}
+
+	public: ChunkedListStack(ChunkedListStack const &other):
+			top(nullptr),
+			topCount(0),
+			size(0)
+	{
+		this->copyChunks(other);
+	}
+
+	public: ChunkedListStack &operator=(ChunkedListStack const &other)
+	{
+		if (this != &other)
+		{
+			this->releaseChunks();
+			this->copyChunks(other);
+		}
+		
+		return *this;
+	}
+
+	public: ~ChunkedListStack()
+	{
+		this->releaseChunks();
+	}
+
+	/**
+	 * Copies elements of other to this empty stack.
+	 */
+	private: void copyChunks(ChunkedListStack const &other)
+	{
+		assert(this->top == nullptr);
+		
+		Chunk **tail = &this->top;
+		
+		for (Chunk *chunk = other.top; chunk != nullptr; chunk = chunk->next)
+		{
+			*tail = Pool::allocate();
+			std::memcpy((void*) (*tail)->data, chunk->data, (chunk == other.top ? other.topCount : ChunkedListStack::CHUNK_CAPACITY) * sizeof(TPL_ChunkedListStack_T));
+			tail = &(*tail)->next;
+		}
+		
+		*tail = nullptr;
+		this->topCount = other.topCount;
+		this->size = other.size;
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Returns all chunks to the pool, leaving this stack empty.
+	 */
+	private: void releaseChunks()
+	{
+		while (this->top != nullptr)
+		{
+			Chunk *next = this->top->next;
+			Pool::release(this->top);
+			this->top = next;
+		}
+		
+		this->topCount = 0;
+		this->size = 0;
+	}
+
+	private: bool invariant() const
+	{
+		assert(this->topCount <= ChunkedListStack::CHUNK_CAPACITY);
+		assert((this->top == nullptr) == (this->size == 0));
+		assert(this->top == nullptr || this->topCount > 0);
+		return true;
+	}
+
+	public: void push(const TPL_ChunkedListStack_T &element)
+	{
+		assert(this->invariant());
+		
+		if (this->top == nullptr || this->topCount == ChunkedListStack::CHUNK_CAPACITY)
+		{
+			Chunk *chunk = Pool::allocate();
+			chunk->next = this->top;
+			this->top = chunk;
+			this->topCount = 0;
+		}
+		
+		this->top->data[this->topCount++] = element;
+		this->size++;
+	}
+
+	public: TPL_ChunkedListStack_T pop()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		
+		TPL_ChunkedListStack_T element = this->top->data[--this->topCount];
+		this->size--;
+		
+		if (this->topCount == 0)
+		{
+			Chunk *next = this->top->next;
+			Pool::release(this->top);
+			this->top = next;
+			this->topCount = next == nullptr ? 0 : ChunkedListStack::CHUNK_CAPACITY;
+		}
+		
+		return element;
+	}
+
+	public: TPL_ChunkedListStack_T peek() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->top->data[this->topCount - 1];
+	}
+
+	public: bool isEmpty() const
+	{
+		return (this->size == 0);
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	/**
+	 * Returns number of free chunks in the pool of the current thread.
+	 */
+	public: static std::size_t getFreeChunkCount()
+	{
+		return Pool::getFreeCount();
+	}
+}
+
+/**
+ * Queue implementation using unrolled linked list: every node (chunk)
+ * stores up to CHUNK_CAPACITY elements, so enqueue() and dequeue() take a
+ * node from the thread's NodePool or return it only once per
+ * CHUNK_CAPACITY elements, and elements are copied in contiguous blocks.
+ */
+template <typename TPL_ChunkedListQueue_T, std::size_t TPL_ChunkedListQueue_CHUNK_CAPACITY = getDefaultChunkCapacity(sizeof(TPL_ChunkedListQueue_T))> class ChunkedListQueue: public StaticQueue <ChunkedListQueue <TPL_ChunkedListQueue_T, TPL_ChunkedListQueue_CHUNK_CAPACITY>, TPL_ChunkedListQueue_T>
+{
+	static_assert(TPL_ChunkedListQueue_CHUNK_CAPACITY > 0, "chunk capacity must be positive");
+
+
+	public: static const std::size_t CHUNK_CAPACITY = TPL_ChunkedListQueue_CHUNK_CAPACITY;
+
+
+	private: typedef typename PodContainer <TPL_ChunkedListQueue_T> ::template Chunk <TPL_ChunkedListQueue_CHUNK_CAPACITY> Chunk;
+	private: typedef NodePool <Chunk> Pool;
+
+
+	/**
+	 * Elements are first->data[firstIndex..], the chunks between first and
+	 * last, and last->data[..lastCount).
+	 */
+	private: Chunk *first, *last;
+	private: std::size_t firstIndex, lastCount;
+	private: std::size_t size;
+
+
+	public: ChunkedListQueue():
+			first(nullptr),
+			last(nullptr),
+			firstIndex(0),
+			lastCount(0),
+			size(0)
+	{
+		//nothing
+	}
+
+	public: ChunkedListQueue(ChunkedListQueue const &other):
+			first(nullptr),
+			last(nullptr),
+			firstIndex(0),
+			lastCount(0),
+			size(0)
+	{
+		this->copyChunks(other);
+	}
+
+	public: ChunkedListQueue &operator=(ChunkedListQueue const &other)
+	{
+		if (this != &other)
+		{
+			this->releaseChunks();
+			this->copyChunks(other);
+		}
+		
+		return *this;
+	}
+
+	public: ~ChunkedListQueue()
+	{
+		this->releaseChunks();
+	}
+
+	/**
+	 * Copies elements of other to this empty queue.
+	 */
+	private: void copyChunks(ChunkedListQueue const &other)
+	{
+		assert(this->first == nullptr);
+		
+		Chunk **tail = &this->first;
+		
+		for (Chunk *chunk = other.first; chunk != nullptr; chunk = chunk->next)
+		{
+			std::size_t begin = chunk == other.first ? other.firstIndex : 0;
+			std::size_t end = chunk == other.last ? other.lastCount : ChunkedListQueue::CHUNK_CAPACITY;
+			
+			this->last = *tail = Pool::allocate();
+			std::memcpy((void*) (this->last->data + begin), chunk->data + begin, (end - begin) * sizeof(TPL_ChunkedListQueue_T));
+			tail = &this->last->next;
+		}
+		
+		*tail = nullptr;
+		this->firstIndex = other.firstIndex;
+		this->lastCount = other.lastCount;
+		this->size = other.size;
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Returns all chunks to the pool, leaving this queue empty.
+	 */
+	private: void releaseChunks()
+	{
+		while (this->first != nullptr)
+		{
+			Chunk *next = this->first->next;
+			Pool::release(this->first);
+			this->first = next;
+		}
+		
+		this->last = nullptr;
+		this->firstIndex = this->lastCount = 0;
+		this->size = 0;
+	}
+
+	private: bool invariant() const
+	{
+		assert((this->first == nullptr) == (this->last == nullptr));
+		assert(this->first != nullptr || this->size == 0);
+		assert(this->firstIndex <= ChunkedListQueue::CHUNK_CAPACITY && this->lastCount <= ChunkedListQueue::CHUNK_CAPACITY);
+		assert(this->first != this->last || this->firstIndex + this->size == this->lastCount);
+		return true;
+	}
+
+	public: void enqueue(const TPL_ChunkedListQueue_T &element)
+	{
+		assert(this->invariant());
+		
+		if (this->last == nullptr)
+		{
+			this->first = this->last = Pool::allocate();
+			this->last->next = nullptr;
+			this->firstIndex = this->lastCount = 0;
+		}
+		else if (this->lastCount == ChunkedListQueue::CHUNK_CAPACITY)
+		{
+			Chunk *chunk = Pool::allocate();
+			chunk->next = nullptr;
+			this->last = this->last->next = chunk;
+			this->lastCount = 0;
+		}
+		
+		this->last->data[this->lastCount++] = element;
+		this->size++;
+	}
+
+	public: TPL_ChunkedListQueue_T dequeue()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		
+		TPL_ChunkedListQueue_T element = this->first->data[this->firstIndex++];
+		this->size--;
+		
+		if (this->size == 0)
+		{
+			// the only chunk is kept for next elements
+			this->firstIndex = this->lastCount = 0;
+		}
+		else if (this->firstIndex == ChunkedListQueue::CHUNK_CAPACITY)
+		{
+			Chunk *next = this->first->next;
+			Pool::release(this->first);
+			this->first = next;
+			this->firstIndex = 0;
+		}
+		
+		return element;
+	}
+
+	public: TPL_ChunkedListQueue_T peek() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->first->data[this->firstIndex];
+	}
+
+	public: bool isEmpty() const
+	{
+		return (this->size == 0);
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	/**
+	 * Returns number of free chunks in the pool of the current thread.
+	 */
+	public: static std::size_t getFreeChunkCount()
+	{
+		return Pool::getFreeCount();
+	}
+}
+
 
 }
 
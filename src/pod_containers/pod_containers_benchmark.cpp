@@ -0,0 +1,147 @@
+#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+using eugenejonas::cpp_stuff::ArrayQueue;
+using eugenejonas::cpp_stuff::ArrayStack;
+using eugenejonas::cpp_stuff::ChunkedListQueue;
+using eugenejonas::cpp_stuff::ChunkedListStack;
+using eugenejonas::cpp_stuff::GrowableArrayQueue;
+using eugenejonas::cpp_stuff::GrowableArrayStack;
+using eugenejonas::cpp_stuff::ListQueue;
+using eugenejonas::cpp_stuff::ListStack;
+using eugenejonas::cpp_stuff::Queue;
+using eugenejonas::cpp_stuff::QueueAdapter;
+using eugenejonas::cpp_stuff::Stack;
+using eugenejonas::cpp_stuff::StackAdapter;
+
+using std::cout;
+using std::string;
+
+
+typedef std::chrono::steady_clock Clock;
+
+
+const int BATCH = 1000;
+const int ROUNDS = 20000;
+
+
+double getNanosecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration <double, std::nano> (Clock::now() - start).count();
+}
+
+/**
+ * Pushes and pops batches of elements and prints time per operation.
+ * TPL_Stack is either a concrete stack (calls are direct) or Stack <int>
+ * (calls are virtual).
+ */
+template <typename TPL_Stack> void runStack(string const &name, TPL_Stack &stack)
+{
+	Clock::time_point start = Clock::now();
+	long long sum = 0;
+	
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int i = 0; i < BATCH; i++)
+		{
+			stack.push(i);
+		}
+		
+		while (!stack.isEmpty())
+		{
+			sum += stack.pop();
+		}
+	}
+	
+	double ns = getNanosecondsSince(start) / (2.0 * ROUNDS * BATCH);
+	
+	cout << "\t" << name << ": " << ns << " ns/op" << (sum == (long long) ROUNDS * BATCH * (BATCH - 1) / 2 ? "" : " WRONG") << "\n";
+}
+
+template <typename TPL_Queue> void runQueue(string const &name, TPL_Queue &queue)
+{
+	Clock::time_point start = Clock::now();
+	long long sum = 0;
+	
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int i = 0; i < BATCH; i++)
+		{
+			queue.enqueue(i);
+		}
+		
+		while (!queue.isEmpty())
+		{
+			sum += queue.dequeue();
+		}
+	}
+	
+	double ns = getNanosecondsSince(start) / (2.0 * ROUNDS * BATCH);
+	
+	cout << "\t" << name << ": " << ns << " ns/op" << (sum == (long long) ROUNDS * BATCH * (BATCH - 1) / 2 ? "" : " WRONG") << "\n";
+}
+
+/**
+ * Runs the same container directly and through its adapter. The adapter
+ * is created behind a condition unknown at compile time, so that the
+ * compiler can't devirtualize the calls; without it there is no virtual run.
+ */
+template <typename TPL_Stack, typename... TPL_Args> void compareStack(string const &name, bool isRuntime, TPL_Args... args)
+{
+	cout << name << ":\n";
+	
+	TPL_Stack stack(args...);
+	runStack("static", stack);
+	
+	Stack <int> *adapter = isRuntime ? new StackAdapter <TPL_Stack> (args...) : nullptr;
+	
+	if (adapter != nullptr)
+	{
+		runStack("virtual", *adapter);
+		delete adapter;
+	}
+}
+
+template <typename TPL_Queue, typename... TPL_Args> void compareQueue(string const &name, bool isRuntime, TPL_Args... args)
+{
+	cout << name << ":\n";
+	
+	TPL_Queue queue(args...);
+	runQueue("static", queue);
+	
+	Queue <int> *adapter = isRuntime ? new QueueAdapter <TPL_Queue> (args...) : nullptr;
+	
+	if (adapter != nullptr)
+	{
+		runQueue("virtual", *adapter);
+		delete adapter;
+	}
+}
+
+
+/**
+ * This program compares time per operation of stacks and queues called
+ * directly (static polymorphism) and through Stack/Queue adapters
+ * (virtual methods). Build it with NDEBUG defined: invariants of the
+ * list containers traverse the whole list.
+ */
+int main(int argc, char **)
+{
+	bool isRuntime = argc < 1000;
+
+	compareStack <ArrayStack <int> > ("ArrayStack", isRuntime, BATCH);
+	compareStack <GrowableArrayStack <int> > ("GrowableArrayStack", isRuntime);
+	compareStack <ListStack <int> > ("ListStack", isRuntime);
+	compareStack <ChunkedListStack <int> > ("ChunkedListStack", isRuntime);
+	compareQueue <ArrayQueue <int> > ("ArrayQueue", isRuntime, BATCH);
+	compareQueue <GrowableArrayQueue <int> > ("GrowableArrayQueue", isRuntime);
+	compareQueue <ListQueue <int> > ("ListQueue", isRuntime);
+	compareQueue <ChunkedListQueue <int> > ("ChunkedListQueue", isRuntime);
+
+	return 0;
+}
@@ -0,0 +1,382 @@
+#include <eugenejonas/cpp_stuff/pod_containers/priority_queues.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::vector;
+
+
+class UnitTest_GrowablePriorityQueue: public CxxTest::TestSuite
+{
+	private: static vector <int> createInput(std::size_t n)
+	{
+		vector <int> res(n);
+		std::srand(1);
+		
+		for (std::size_t i = 0; i < n; i++)
+		{
+			res[i] = std::rand() % 1000 - 500;
+		}
+		
+		return res;
+	}
+
+	/**
+	 * Extracts all elements and compares them with the input sorted in
+	 * descending order.
+	 */
+	private: template <typename TPL_Queue> static void checkExtractAll(TPL_Queue &queue, vector <int> input)
+	{
+		std::sort(input.begin(), input.end(), std::greater <int> ());
+		TS_ASSERT_EQUALS(input.size(), queue.getSize());
+		
+		for (int x : input)
+		{
+			TS_ASSERT_EQUALS(x, queue.peek());
+			TS_ASSERT_EQUALS(x, queue.extract());
+		}
+		
+		TS_ASSERT(queue.isEmpty());
+	}
+
+	public: void test_insert_and_extract()
+	{
+		vector <int> input = createInput(1000);
+		GrowablePriorityQueue <int> queue;
+		
+		for (int x : input)
+		{
+			queue.insert(x);
+		}
+		
+		TS_ASSERT(queue.getCapacity() >= 1000);
+		checkExtractAll(queue, input);
+	}
+
+	public: void test_arities()
+	{
+		vector <int> input = createInput(777);
+		GrowablePriorityQueue <int, std::less <int>, 2> binary(input.begin(), input.end());
+		GrowablePriorityQueue <int, std::less <int>, 3> ternary(input.begin(), input.end());
+		GrowablePriorityQueue <int, std::less <int>, 8> octonary(input.begin(), input.end());
+		
+		checkExtractAll(binary, input);
+		checkExtractAll(ternary, input);
+		checkExtractAll(octonary, input);
+	}
+
+	public: void test_buildHeap()
+	{
+		vector <int> input = createInput(1000);
+		GrowablePriorityQueue <int> queue(input.begin(), input.end());
+		
+		checkExtractAll(queue, input);
+		
+		// replaces the contents and grows
+		queue.insert(1);
+		queue.buildHeap(input.begin(), input.begin() + 10);
+		checkExtractAll(queue, vector <int> (input.begin(), input.begin() + 10));
+		
+		queue.buildHeap(input.begin(), input.begin());
+		TS_ASSERT(queue.isEmpty());
+	}
+
+	public: void test_bulk_operations()
+	{
+		vector <int> input = createInput(1000);
+		GrowablePriorityQueue <int> queue, other;
+		
+		// few elements are inserted one by one, many are rebuilt
+		queue.insertRange(input.begin(), input.begin() + 500);
+		queue.insertRange(input.begin() + 500, input.begin() + 510);
+		other.insertRange(input.begin() + 510, input.end());
+		queue.meld(other);
+		
+		TS_ASSERT(other.isEmpty());
+		
+		vector <int> expected = input, extracted(100);
+		std::sort(expected.begin(), expected.end(), std::greater <int> ());
+		
+		TS_ASSERT_EQUALS(extracted.end(), queue.extractN(100, extracted.begin()));
+		TS_ASSERT_EQUALS(vector <int> (expected.begin(), expected.begin() + 100), extracted);
+		
+		queue.insertRange(extracted.begin(), extracted.end());
+		checkExtractAll(queue, input);
+	}
+
+	public: void test_aligned_siblings()
+	{
+		std::int32_t *arr = DaryHeap <16> ::allocate <std::int32_t> (100);
+		
+		// children of the root fill the first cache line
+		TS_ASSERT_EQUALS(0u, (std::uintptr_t) (arr + 1) % 64);
+		
+		DaryHeap <16> ::deallocate(arr);
+	}
+
+	public: void test_copy()
+	{
+		vector <int> input = createInput(100);
+		GrowablePriorityQueue <int, std::greater <int> > queue(input.begin(), input.end());
+		GrowablePriorityQueue <int, std::greater <int> > copy(queue), assigned;
+		
+		assigned = queue;
+		queue.extract();
+		
+		std::sort(input.begin(), input.end());
+		
+		for (int x : input)
+		{
+			TS_ASSERT_EQUALS(x, copy.extract());
+			TS_ASSERT_EQUALS(x, assigned.extract());
+		}
+	}
+}
+
+class UnitTest_IndexedPriorityQueue: public CxxTest::TestSuite
+{
+	typedef IndexedPriorityQueue <long long, std::greater <long long> > MinQueue;
+
+
+	public: void test_operations_by_handle()
+	{
+		IndexedPriorityQueue <int> queue;
+		IndexedPriorityQueue <int> ::Handle a = queue.insert(5), b = queue.insert(10), c = queue.insert(7);
+		
+		TS_ASSERT_EQUALS(b, queue.peekHandle());
+		TS_ASSERT_EQUALS(7, queue.get(c));
+		
+		queue.increasePriority(a, 20);
+		TS_ASSERT_EQUALS(a, queue.peekHandle());
+		
+		queue.changePriority(a, 1);
+		TS_ASSERT_EQUALS(b, queue.peekHandle());
+		
+		queue.erase(b);
+		TS_ASSERT(!queue.contains(b));
+		TS_ASSERT_EQUALS(2u, queue.getSize());
+		
+		// handles are reused
+		TS_ASSERT_EQUALS(b, queue.insert(3));
+		
+		TS_ASSERT_EQUALS(7, queue.extract());
+		TS_ASSERT(!queue.contains(c));
+		TS_ASSERT_EQUALS(3, queue.extract());
+		TS_ASSERT_EQUALS(1, queue.extract());
+		TS_ASSERT(queue.isEmpty());
+	}
+
+	public: void test_random_operations()
+	{
+		IndexedPriorityQueue <int, std::less <int>, 3> queue;
+		vector <std::pair <int, IndexedPriorityQueue <int> ::Handle> > model;
+		std::srand(2);
+		
+		for (int step = 0; step < 20000; step++)
+		{
+			int operation = std::rand() % 4;
+			
+			if (operation == 0 || model.empty())
+			{
+				int x = std::rand() % 1000;
+				model.push_back({x, queue.insert(x)});
+			}
+			else if (operation == 1)
+			{
+				std::size_t i = std::rand() % model.size();
+				model[i].first = std::rand() % 1000;
+				queue.changePriority(model[i].second, model[i].first);
+			}
+			else if (operation == 2)
+			{
+				std::size_t i = std::rand() % model.size();
+				queue.erase(model[i].second);
+				model.erase(model.begin() + i);
+			}
+			else
+			{
+				auto top = std::max_element(model.begin(), model.end());
+				TS_ASSERT_EQUALS(top->first, queue.get(queue.peekHandle()));
+				TS_ASSERT_EQUALS(top->first, queue.peek());
+				
+				std::size_t i = std::find_if(model.begin(), model.end(), [&queue](auto const &p) { return p.second == queue.peekHandle(); }) - model.begin();
+				queue.extract();
+				model.erase(model.begin() + i);
+			}
+			
+			TS_ASSERT_EQUALS(model.size(), queue.getSize());
+		}
+	}
+
+	/**
+	 * Dijkstra's algorithm on a grid with random weights, compared with
+	 * Bellman-Ford relaxation.
+	 */
+	public: void test_dijkstra()
+	{
+		const int side = 20, n = side * side;
+		vector <vector <std::pair <int, long long> > > edges(n);
+		std::srand(3);
+		
+		for (int v = 0; v < n; v++)
+		{
+			if (v % side + 1 < side)
+			{
+				long long w = std::rand() % 100;
+				edges[v].push_back({v + 1, w});
+				edges[v + 1].push_back({v, w});
+			}
+			
+			if (v + side < n)
+			{
+				long long w = std::rand() % 100;
+				edges[v].push_back({v + side, w});
+				edges[v + side].push_back({v, w});
+			}
+		}
+		
+		const long long infinity = std::numeric_limits <long long> ::max();
+		vector <long long> expected(n, infinity);
+		expected[0] = 0;
+		
+		for (bool isChanged = true; isChanged; )
+		{
+			isChanged = false;
+			
+			for (int v = 0; v < n; v++)
+			{
+				for (auto const &e : edges[v])
+				{
+					if (expected[v] != infinity && expected[v] + e.second < expected[e.first])
+					{
+						expected[e.first] = expected[v] + e.second;
+						isChanged = true;
+					}
+				}
+			}
+		}
+		
+		vector <long long> distances(n, infinity);
+		distances[0] = 0;
+		MinQueue queue(distances.begin(), distances.end());
+		
+		while (!queue.isEmpty())
+		{
+			MinQueue::Handle v = queue.peekHandle();
+			queue.extract();
+			
+			for (auto const &e : edges[v])
+			{
+				if (queue.contains(e.first) && distances[v] + e.second < distances[e.first])
+				{
+					distances[e.first] = distances[v] + e.second;
+					queue.increasePriority(e.first, distances[e.first]);
+				}
+			}
+		}
+		
+		TS_ASSERT_EQUALS(expected, distances);
+	}
+}
+
+
+class UnitTest_RadixHeap: public CxxTest::TestSuite
+{
+	/**
+	 * Inserts keys not less than the last extracted one and compares
+	 * extracted keys with a GrowablePriorityQueue.
+	 */
+	public: void test_monotone_operations()
+	{
+		RadixHeap <std::uint32_t> heap;
+		GrowablePriorityQueue <std::uint32_t, std::greater <std::uint32_t> > expected;
+		std::uint32_t last = 0;
+		std::srand(4);
+		
+		for (int step = 0; step < 20000; step++)
+		{
+			if (std::rand() % 3 != 0 || heap.isEmpty())
+			{
+				std::uint32_t key = last + (std::uint32_t) (std::rand() % 3 == 0 ? std::rand() : std::rand() % 16);
+				heap.insert(key);
+				expected.insert(key);
+			}
+			else
+			{
+				TS_ASSERT_EQUALS(expected.peek(), heap.peek());
+				last = heap.extract();
+				TS_ASSERT_EQUALS(expected.extract(), last);
+			}
+			
+			TS_ASSERT_EQUALS(expected.getSize(), heap.getSize());
+		}
+	}
+
+	public: void test_signed_and_floating_keys()
+	{
+		vector <int> ints = {5, -3, 0, -3, 100, -2000000000, 7};
+		vector <double> doubles = {2.5, -1.0, 0.0, 1e100, -1e-100, 3.0};
+		RadixHeap <int> intHeap;
+		RadixHeap <double> doubleHeap;
+		
+		intHeap.insertRange(ints.begin(), ints.end());
+		doubleHeap.insertRange(doubles.begin(), doubles.end());
+		
+		vector <int> sortedInts(ints.size());
+		vector <double> sortedDoubles(doubles.size());
+		
+		intHeap.extractN(ints.size(), sortedInts.begin());
+		doubleHeap.extractN(doubles.size(), sortedDoubles.begin());
+		
+		std::sort(ints.begin(), ints.end());
+		std::sort(doubles.begin(), doubles.end());
+		
+		TS_ASSERT_EQUALS(ints, sortedInts);
+		TS_ASSERT_EQUALS(doubles, sortedDoubles);
+	}
+
+	public: void test_meld_with_key_extractor()
+	{
+		typedef std::pair <std::uint64_t, int> Pair;
+		
+		struct FirstKey
+		{
+			public: std::uint64_t operator()(Pair const &p) const
+			{
+				return p.first;
+			}
+		}
+		
+		RadixHeap <Pair, FirstKey> a, b;
+		
+		a.insert({10, 0});
+		a.insert({1, 1});
+		b.insert({5, 2});
+		b.insert({1ull << 40, 3});
+		
+		TS_ASSERT_EQUALS(1, a.extract().second);
+		
+		a.meld(b);
+		
+		TS_ASSERT(b.isEmpty());
+		TS_ASSERT_EQUALS(3u, a.getSize());
+		TS_ASSERT_EQUALS(2, a.extract().second);
+		TS_ASSERT_EQUALS(0, a.extract().second);
+		TS_ASSERT_EQUALS(3, a.extract().second);
+	}
+}
+
+
+}
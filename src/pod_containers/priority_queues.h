@@ -0,0 +1,1038 @@
+#ifndef EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__PRIORITY_QUEUES_H
+#define EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__PRIORITY_QUEUES_H
+
+
+#include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
+#include <eugenejonas/cpp_stuff/radix_sort.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+#include <concepts>
+#else
+#include <boost/concept_check.hpp>
+#include <boost/concept/assert.hpp>
+#endif
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Layout and sift operations of a d-ary heap stored in array arr[0..size):
+ * children of node i are arr[ARITY * i + 1 .. ARITY * i + ARITY]. With
+ * ARITY = 4, the heap is about half as deep as a binary one, and the
+ * children compared in sift-down share a cache line.
+ *
+ * The array is allocated aligned to a cache line and shifted by ARITY - 1
+ * elements, so that every group of siblings starts at a multiple of
+ * ARITY * sizeof(T) bytes from the start of a line.
+ *
+ * The element at the top of the heap is the greatest one with respect to
+ * swoCompare, as in PriorityQueue.
+ */
+template <std::size_t TPL_DaryHeap_ARITY> class DaryHeap
+{
+	static_assert(TPL_DaryHeap_ARITY >= 2, "heap arity must be at least 2");
+
+
+	public: static const std::size_t ARITY = TPL_DaryHeap_ARITY;
+	public: static const std::size_t CACHE_LINE_SIZE = 64;
+
+
+	public: static std::size_t getFirstChild(std::size_t i)
+	{
+		return DaryHeap::ARITY * i + 1;
+	}
+
+	public: static std::size_t getParent(std::size_t i)
+	{
+		assert(i > 0);
+		return (i - 1) / DaryHeap::ARITY;
+	}
+
+	/**
+	 * Allocates uninitialized aligned array of capacity elements.
+	 * Free it by deallocate().
+	 */
+	public: template <typename TPL_T> static TPL_T *allocate(std::size_t capacity)
+	{
+		void *storage = ::operator new((capacity + DaryHeap::ARITY - 1) * sizeof(TPL_T), std::align_val_t(DaryHeap::CACHE_LINE_SIZE));
+		return (TPL_T*) storage + (DaryHeap::ARITY - 1);
+	}
+
+	public: template <typename TPL_T> static void deallocate(TPL_T *arr)
+	{
+		if (arr != nullptr)
+		{
+			::operator delete((void*) (arr - (DaryHeap::ARITY - 1)), std::align_val_t(DaryHeap::CACHE_LINE_SIZE));
+		}
+	}
+
+	/**
+	 * Moves element up from the hole at position pos to its place.
+	 * Every element is written by place(position, element), which lets
+	 * indexed heaps track positions of elements.
+	 */
+	public: template <typename TPL_T, typename TPL_StrictWeakOrdering, typename TPL_Place> static void siftUp(
+			TPL_T *arr,
+			std::size_t pos,
+			TPL_T const &element,
+			TPL_StrictWeakOrdering &swoCompare,
+			TPL_Place place
+	)
+	{
+		while (pos > 0)
+		{
+			std::size_t parent = DaryHeap::getParent(pos);
+			
+			if (!swoCompare(arr[parent], element))
+			{
+				break;
+			}
+			
+			place(pos, arr[parent]);
+			pos = parent;
+		}
+		
+		place(pos, element);
+	}
+
+	/**
+	 * Moves element down from the hole at position pos to its place in
+	 * heap arr[0..size).
+	 */
+	public: template <typename TPL_T, typename TPL_StrictWeakOrdering, typename TPL_Place> static void siftDown(
+			TPL_T *arr,
+			std::size_t size,
+			std::size_t pos,
+			TPL_T const &element,
+			TPL_StrictWeakOrdering &swoCompare,
+			TPL_Place place
+	)
+	{
+		while (true)
+		{
+			std::size_t first = DaryHeap::getFirstChild(pos);
+			
+			if (first >= size)
+			{
+				break;
+			}
+			
+			std::size_t last = std::min(first + DaryHeap::ARITY, size), best = first;
+			
+			for (std::size_t child = first + 1; child < last; child++)
+			{
+				if (swoCompare(arr[best], arr[child]))
+				{
+					best = child;
+				}
+			}
+			
+			if (!swoCompare(element, arr[best]))
+			{
+				break;
+			}
+			
+			place(pos, arr[best]);
+			pos = best;
+		}
+		
+		place(pos, element);
+	}
+
+	/**
+	 * Makes heap of arr[0..size) bottom-up (Floyd's method).
+	 *
+	 * @time O(n)
+	 */
+	public: template <typename TPL_T, typename TPL_StrictWeakOrdering, typename TPL_Place> static void build(
+			TPL_T *arr,
+			std::size_t size,
+			TPL_StrictWeakOrdering &swoCompare,
+			TPL_Place place
+	)
+	{
+		if (size < 2)
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				place(i, arr[i]);
+			}
+			
+			return;
+		}
+		
+		// leaves are heaps already, but they have to be placed too
+		for (std::size_t i = DaryHeap::getParent(size - 1) + 1; i < size; i++)
+		{
+			place(i, arr[i]);
+		}
+		
+		for (std::size_t i = DaryHeap::getParent(size - 1) + 1; i-- > 0; )
+		{
+			TPL_T element = arr[i];
+			DaryHeap::siftDown(arr, size, i, element, swoCompare, place);
+		}
+	}
+
+	/**
+	 * Checks the heap property of arr[0..size).
+	 */
+	public: template <typename TPL_T, typename TPL_StrictWeakOrdering> static bool isHeap(
+			TPL_T const *arr,
+			std::size_t size,
+			TPL_StrictWeakOrdering &swoCompare
+	)
+	{
+		for (std::size_t i = 1; i < size; i++)
+		{
+			if (swoCompare(arr[DaryHeap::getParent(i)], arr[i]))
+			{
+				return false;
+			}
+		}
+		
+		return true;
+	}
+}
+
+/**
+ * Priority queue with the interface of PriorityQueue, but without fixed
+ * capacity: the array grows twice when it is full. It is a d-ary heap
+ * (see DaryHeap), 4-ary by default.
+ *
+ * The heap property is checked by invariant() only if the macro
+ * EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS is defined, because it
+ * takes O(n) time on every operation.
+ *
+ * @param TPL_GrowablePriorityQueue_StrictWeakOrdering If swoCompare(a, b) == true,
+ *		element b has greater priority than element a.
+ * @param TPL_GrowablePriorityQueue_ARITY Number of children of a node.
+ */
+template <typename TPL_GrowablePriorityQueue_T, class TPL_GrowablePriorityQueue_StrictWeakOrdering = std::less <TPL_GrowablePriorityQueue_T>, std::size_t TPL_GrowablePriorityQueue_ARITY = 4>
+#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+requires std::StrictWeakOrder <TPL_GrowablePriorityQueue_StrictWeakOrdering, TPL_GrowablePriorityQueue_T>
+#endif
+class GrowablePriorityQueue: public PodContainer <TPL_GrowablePriorityQueue_T>
+{
+	#ifndef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_GrowablePriorityQueue_StrictWeakOrdering, TPL_GrowablePriorityQueue_T>));
+	#endif
+
+
+	private: typedef DaryHeap <TPL_GrowablePriorityQueue_ARITY> Heap;
+
+
+	public: static const std::size_t MIN_CAPACITY = 16;
+
+
+	/**
+	 * Mutable for the same reason as in PriorityQueue.
+	 */
+	private: mutable TPL_GrowablePriorityQueue_StrictWeakOrdering swoCompare;
+	private: TPL_GrowablePriorityQueue_T *arr;
+	private: std::size_t capacity, size;
+
+
+	/**
+	 * Constructs a new empty priority queue.
+	 *
+	 * @param capacity Number of elements the queue can store without
+	 *		reallocation.
+	 */
+	public: GrowablePriorityQueue(std::size_t capacity = 0, TPL_GrowablePriorityQueue_StrictWeakOrdering swoCompare = TPL_GrowablePriorityQueue_StrictWeakOrdering()):
+			swoCompare(swoCompare),
+			arr(nullptr),
+			capacity(0),
+			size(0)
+	{
+		this->reserve(capacity);
+		assert(this->invariant());
+	}
+
+	/**
+	 * Constructs a priority queue of elements [first; last).
+	 *
+	 * @time O(n)
+	 */
+	public: template <typename TPL_InputIterator> GrowablePriorityQueue(
+			TPL_InputIterator first,
+			TPL_InputIterator last,
+			TPL_GrowablePriorityQueue_StrictWeakOrdering swoCompare = TPL_GrowablePriorityQueue_StrictWeakOrdering()
+	):
+			GrowablePriorityQueue(0, swoCompare)
+	{
+		this->buildHeap(first, last);
+	}
+
+	public: GrowablePriorityQueue(GrowablePriorityQueue const &other):
+			swoCompare(other.swoCompare),
+			arr(nullptr),
+			capacity(0),
+			size(0)
+	{
+		this->reserve(other.size);
+		std::memcpy((void*) this->arr, other.arr, other.size * sizeof(TPL_GrowablePriorityQueue_T));
+		this->size = other.size;
+		assert(this->invariant());
+	}
+
+	public: GrowablePriorityQueue &operator=(GrowablePriorityQueue const &other)
+	{
+		if (this != &other)
+		{
+			this->swoCompare = other.swoCompare;
+			this->size = 0;
+			this->reserve(other.size);
+			std::memcpy((void*) this->arr, other.arr, other.size * sizeof(TPL_GrowablePriorityQueue_T));
+			this->size = other.size;
+		}
+		
+		assert(this->invariant());
+		return *this;
+	}
+
+	public: ~GrowablePriorityQueue()
+	{
+		Heap::deallocate(this->arr);
+	}
+
+	private: bool invariant() const
+	{
+		assert(this->size <= this->capacity);
+		assert(this->capacity == 0 || this->arr != nullptr);
+		
+		#ifdef EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
+		assert(Heap::isHeap(this->arr, this->size, this->swoCompare));
+		#endif
+		
+		return true;
+	}
+
+	/**
+	 * Replaces contents of the queue by elements [first; last).
+	 *
+	 * @time O(n)
+	 */
+	public: template <typename TPL_InputIterator> void buildHeap(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		this->size = 0;
+		this->append(first, last);
+		Heap::build(this->arr, this->size, this->swoCompare, this->getPlace());
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Adds an element to the queue.
+	 *
+	 * @time O(log(n)) amortized
+	 */
+	public: void insert(TPL_GrowablePriorityQueue_T const &element)
+	{
+		assert(this->invariant());
+		
+		if (this->size == this->capacity)
+		{
+			this->reserve(std::max(2 * this->capacity, (std::size_t) GrowablePriorityQueue::MIN_CAPACITY));
+		}
+		
+		Heap::siftUp(this->arr, this->size++, element, this->swoCompare, this->getPlace());
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Adds elements [first; last) to the queue. If there are many of them
+	 * compared to the queue, the heap is rebuilt bottom-up in O(n + k)
+	 * time instead of k insertions in O(k * log(n + k)) time.
+	 */
+	public: template <typename TPL_InputIterator> void insertRange(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		assert(this->invariant());
+		
+		std::size_t oldSize = this->size;
+		this->append(first, last);
+		
+		std::size_t count = this->size - oldSize, depth = 0;
+		
+		for (std::size_t i = this->size; i > 1; i /= Heap::ARITY)
+		{
+			depth++;
+		}
+		
+		// bottom-up construction takes about 2 * size comparisons
+		if (count * depth > 2 * this->size)
+		{
+			Heap::build(this->arr, this->size, this->swoCompare, this->getPlace());
+		}
+		else
+		{
+			for (std::size_t i = oldSize; i < this->size; i++)
+			{
+				TPL_GrowablePriorityQueue_T element = this->arr[i];
+				Heap::siftUp(this->arr, i, element, this->swoCompare, this->getPlace());
+			}
+		}
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Deletes element at the top of the queue (with the highest priority).
+	 * Queue must not be empty.
+	 *
+	 * @return The deleted element.
+	 */
+	public: TPL_GrowablePriorityQueue_T extract()
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		
+		TPL_GrowablePriorityQueue_T res = this->arr[0];
+		TPL_GrowablePriorityQueue_T last = this->arr[--this->size];
+		
+		if (this->size > 0)
+		{
+			Heap::siftDown(this->arr, this->size, 0, last, this->swoCompare, this->getPlace());
+		}
+		
+		assert(this->invariant());
+		
+		return res;
+	}
+
+	/**
+	 * Deletes count elements with the highest priorities and writes them
+	 * to out in order of decreasing priority.
+	 * Queue must have at least count elements.
+	 *
+	 * @return Iterator behind the last written element.
+	 */
+	public: template <typename TPL_OutputIterator> TPL_OutputIterator extractN(std::size_t count, TPL_OutputIterator out)
+	{
+		assert(count <= this->size);
+		
+		for (std::size_t i = 0; i < count; i++)
+		{
+			*out++ = this->extract();
+		}
+		
+		return out;
+	}
+
+	/**
+	 * Moves all elements of other queue to this queue.
+	 */
+	public: void meld(GrowablePriorityQueue &other)
+	{
+		assert(this != &other);
+		
+		this->insertRange(other.arr, other.arr + other.size);
+		other.size = 0;
+	}
+
+	/**
+	 * Returns element at the head of the queue (element with the highest
+	 * priority), but doesn't remove it. Queue must not be empty.
+	 */
+	public: TPL_GrowablePriorityQueue_T peek() const
+	{
+		assert(this->invariant());
+		assert(this->size > 0);
+		return this->arr[0];
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->size == 0;
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	public: std::size_t getCapacity() const
+	{
+		return this->capacity;
+	}
+
+	/**
+	 * Makes room for at least capacity elements.
+	 */
+	public: void reserve(std::size_t capacity)
+	{
+		if (capacity <= this->capacity)
+		{
+			return;
+		}
+		
+		TPL_GrowablePriorityQueue_T *arr = Heap::template allocate <TPL_GrowablePriorityQueue_T> (capacity);
+		
+		if (this->size > 0)
+		{
+			std::memcpy((void*) arr, this->arr, this->size * sizeof(TPL_GrowablePriorityQueue_T));
+		}
+		
+		Heap::deallocate(this->arr);
+		this->arr = arr;
+		this->capacity = capacity;
+	}
+
+	/**
+	 * Appends elements [first; last) to the array, without restoring the heap.
+	 */
+	private: template <typename TPL_InputIterator> void append(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		for ( ; first != last; ++first)
+		{
+			if (this->size == this->capacity)
+			{
+				this->reserve(std::max(2 * this->capacity, (std::size_t) GrowablePriorityQueue::MIN_CAPACITY));
+			}
+			
+			this->arr[this->size++] = *first;
+		}
+	}
+
+	/**
+	 * Returns function writing an element to the heap.
+	 */
+	private: auto getPlace()
+	{
+		TPL_GrowablePriorityQueue_T *arr = this->arr;
+		
+		return [arr](std::size_t i, TPL_GrowablePriorityQueue_T const &element)
+		{
+			arr[i] = element;
+		};
+	}
+}
+
+/**
+ * Priority queue whose elements are accessed by handles returned by
+ * insert(), so that priority of an element can be changed and an element
+ * can be erased, e.g. for Dijkstra's algorithm. It is a d-ary heap (see
+ * DaryHeap) of elements with their handles, and positions of elements in
+ * the heap are indexed by handles. Handles of extracted and erased
+ * elements are reused.
+ *
+ * increasePriority() is the decrease-key operation when the queue is
+ * used as a min-queue (with std::greater).
+ *
+ * The heap property is checked by invariant() only if the macro
+ * EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS is defined.
+ *
+ * @param TPL_IndexedPriorityQueue_StrictWeakOrdering If swoCompare(a, b) == true,
+ *		element b has greater priority than element a.
+ */
+template <typename TPL_IndexedPriorityQueue_T, class TPL_IndexedPriorityQueue_StrictWeakOrdering = std::less <TPL_IndexedPriorityQueue_T>, std::size_t TPL_IndexedPriorityQueue_ARITY = 4>
+#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+requires std::StrictWeakOrder <TPL_IndexedPriorityQueue_StrictWeakOrdering, TPL_IndexedPriorityQueue_T>
+#endif
+class IndexedPriorityQueue: public PodContainer <TPL_IndexedPriorityQueue_T>
+{
+	#ifndef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_IndexedPriorityQueue_StrictWeakOrdering, TPL_IndexedPriorityQueue_T>));
+	#endif
+
+
+	public: typedef std::size_t Handle;
+
+
+	private: typedef DaryHeap <TPL_IndexedPriorityQueue_ARITY> Heap;
+
+	private: struct Entry
+	{
+		public: TPL_IndexedPriorityQueue_T element;
+		public: Handle handle;
+	}
+
+	/**
+	 * Compares entries by their elements.
+	 */
+	private: struct EntryOrdering
+	{
+		public: TPL_IndexedPriorityQueue_StrictWeakOrdering swoCompare;
+
+
+		public: bool operator()(Entry const &a, Entry const &b)
+		{
+			return this->swoCompare(a.element, b.element);
+		}
+	}
+
+
+	/**
+	 * Position of an element which is not in the queue.
+	 */
+	private: static const std::size_t NO_POSITION = (std::size_t) -1;
+
+
+	private: mutable EntryOrdering entryCompare;
+	private: std::vector <Entry> entries;
+
+	/**
+	 * positions[handle] is index of the element in entries, or NO_POSITION.
+	 */
+	private: std::vector <std::size_t> positions;
+
+	private: std::vector <Handle> freeHandles;
+
+
+	public: IndexedPriorityQueue(TPL_IndexedPriorityQueue_StrictWeakOrdering swoCompare = TPL_IndexedPriorityQueue_StrictWeakOrdering()):
+			entryCompare{swoCompare}
+	{
+		//nothing
+	}
+
+	/**
+	 * Constructs a priority queue of elements [first; last); their handles
+	 * are 0, 1, ... in order of the range.
+	 *
+	 * @time O(n)
+	 */
+	public: template <typename TPL_InputIterator> IndexedPriorityQueue(
+			TPL_InputIterator first,
+			TPL_InputIterator last,
+			TPL_IndexedPriorityQueue_StrictWeakOrdering swoCompare = TPL_IndexedPriorityQueue_StrictWeakOrdering()
+	):
+			entryCompare{swoCompare}
+	{
+		for ( ; first != last; ++first)
+		{
+			this->entries.push_back({*first, this->entries.size()});
+		}
+		
+		this->positions.resize(this->entries.size());
+		Heap::build(this->entries.data(), this->entries.size(), this->entryCompare, this->getPlace());
+		
+		assert(this->invariant());
+	}
+
+	private: bool invariant() const
+	{
+		assert(this->entries.size() + this->freeHandles.size() == this->positions.size());
+		
+		#ifdef EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
+		assert(Heap::isHeap(this->entries.data(), this->entries.size(), this->entryCompare));
+		
+		for (std::size_t i = 0; i < this->entries.size(); i++)
+		{
+			assert(this->positions[this->entries[i].handle] == i);
+		}
+		#endif
+		
+		return true;
+	}
+
+	/**
+	 * Adds an element to the queue.
+	 *
+	 * @return Handle of the element, valid until it is extracted or erased.
+	 * @time O(log(n)) amortized
+	 */
+	public: Handle insert(TPL_IndexedPriorityQueue_T const &element)
+	{
+		assert(this->invariant());
+		
+		Handle handle;
+		
+		if (this->freeHandles.empty())
+		{
+			handle = this->positions.size();
+			this->positions.push_back((std::size_t) IndexedPriorityQueue::NO_POSITION);
+		}
+		else
+		{
+			handle = this->freeHandles.back();
+			this->freeHandles.pop_back();
+		}
+		
+		Entry entry = {element, handle};
+		this->entries.push_back(entry);
+		Heap::siftUp(this->entries.data(), this->entries.size() - 1, entry, this->entryCompare, this->getPlace());
+		
+		assert(this->invariant());
+		
+		return handle;
+	}
+
+	/**
+	 * Deletes element at the top of the queue (with the highest priority).
+	 * Queue must not be empty.
+	 *
+	 * @return The deleted element.
+	 */
+	public: TPL_IndexedPriorityQueue_T extract()
+	{
+		assert(!this->isEmpty());
+		
+		TPL_IndexedPriorityQueue_T res = this->entries[0].element;
+		this->erase(this->entries[0].handle);
+		
+		return res;
+	}
+
+	/**
+	 * Returns element at the head of the queue, but doesn't remove it.
+	 * Queue must not be empty.
+	 */
+	public: TPL_IndexedPriorityQueue_T peek() const
+	{
+		assert(this->invariant());
+		assert(!this->isEmpty());
+		return this->entries[0].element;
+	}
+
+	/**
+	 * Returns handle of the element at the head of the queue.
+	 * Queue must not be empty.
+	 */
+	public: Handle peekHandle() const
+	{
+		assert(!this->isEmpty());
+		return this->entries[0].handle;
+	}
+
+	/**
+	 * Returns true if the handle belongs to an element in the queue.
+	 */
+	public: bool contains(Handle handle) const
+	{
+		return handle < this->positions.size() && this->positions[handle] != IndexedPriorityQueue::NO_POSITION;
+	}
+
+	public: TPL_IndexedPriorityQueue_T get(Handle handle) const
+	{
+		assert(this->contains(handle));
+		return this->entries[this->positions[handle]].element;
+	}
+
+	/**
+	 * Replaces an element with one of the same or greater priority.
+	 *
+	 * @time O(log(n))
+	 */
+	public: void increasePriority(Handle handle, TPL_IndexedPriorityQueue_T const &element)
+	{
+		assert(this->invariant());
+		assert(this->contains(handle));
+		
+		std::size_t pos = this->positions[handle];
+		Entry entry = {element, handle};
+		
+		assert(!this->entryCompare(entry, this->entries[pos]));
+		
+		Heap::siftUp(this->entries.data(), pos, entry, this->entryCompare, this->getPlace());
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Replaces an element with one of any priority.
+	 *
+	 * @time O(log(n))
+	 */
+	public: void changePriority(Handle handle, TPL_IndexedPriorityQueue_T const &element)
+	{
+		assert(this->invariant());
+		assert(this->contains(handle));
+		
+		std::size_t pos = this->positions[handle];
+		Entry entry = {element, handle};
+		
+		this->moveEntry(pos, entry);
+		
+		assert(this->invariant());
+	}
+
+	/**
+	 * Removes an element from the queue; its handle becomes invalid.
+	 *
+	 * @time O(log(n))
+	 */
+	public: void erase(Handle handle)
+	{
+		assert(this->invariant());
+		assert(this->contains(handle));
+		
+		std::size_t pos = this->positions[handle];
+		Entry last = this->entries.back();
+		
+		this->entries.pop_back();
+		this->positions[handle] = IndexedPriorityQueue::NO_POSITION;
+		this->freeHandles.push_back(handle);
+		
+		if (pos < this->entries.size())
+		{
+			this->moveEntry(pos, last);
+		}
+		
+		assert(this->invariant());
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->entries.empty();
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->entries.size();
+	}
+
+	/**
+	 * Places entry to the hole at position pos and restores the heap.
+	 */
+	private: void moveEntry(std::size_t pos, Entry const &entry)
+	{
+		if (pos > 0 && this->entryCompare(this->entries[Heap::getParent(pos)], entry))
+		{
+			Heap::siftUp(this->entries.data(), pos, entry, this->entryCompare, this->getPlace());
+		}
+		else
+		{
+			Heap::siftDown(this->entries.data(), this->entries.size(), pos, entry, this->entryCompare, this->getPlace());
+		}
+	}
+
+	/**
+	 * Returns function writing an entry to the heap and its position to the index.
+	 */
+	private: auto getPlace()
+	{
+		Entry *entries = this->entries.data();
+		std::size_t *positions = this->positions.data();
+		
+		return [entries, positions](std::size_t i, Entry const &entry)
+		{
+			entries[i] = entry;
+			positions[entry.handle] = i;
+		};
+	}
+}
+
+/**
+ * Radix heap: priority queue for monotone keys, where no inserted key is
+ * less than the last extracted one (e.g. distances in Dijkstra's algorithm).
+ * The element with the least key is at the top, as in a PriorityQueue with
+ * std::greater. Keys are mapped to unsigned integers by RadixKeyTraits,
+ * and an element is kept in bucket i if the highest bit in which its key
+ * differs from the last extracted key is bit i - 1 (bucket 0 holds keys
+ * equal to it). Each element moves to lower buckets at most once per bit,
+ * so operations take O(number of bits) amortized time and no comparisons
+ * of elements.
+ *
+ * @param TPL_RadixHeap_KeyExtractor Functor returning key of an element,
+ *		as in radix sorts; key type must have RadixKeyTraits.
+ */
+template <typename TPL_RadixHeap_T, typename TPL_RadixHeap_KeyExtractor = IdentityKey> class RadixHeap: public PodContainer <TPL_RadixHeap_T>
+{
+	private: typedef std::decay_t <std::invoke_result_t <TPL_RadixHeap_KeyExtractor, TPL_RadixHeap_T const &> > key_type;
+	private: typedef typename RadixKeyTraits <key_type> ::bits_type bits_type;
+
+	private: struct Entry
+	{
+		public: bits_type bits;
+		public: TPL_RadixHeap_T element;
+	}
+
+
+	public: static const std::size_t BUCKET_COUNT = 8 * sizeof(bits_type) + 1;
+
+
+	private: TPL_RadixHeap_KeyExtractor getKey;
+
+	/**
+	 * Buckets are refilled from higher ones when bucket 0 is empty, also by
+	 * peek(), which doesn't change the contents of the queue.
+	 */
+	private: mutable std::vector <Entry> buckets[RadixHeap::BUCKET_COUNT];
+
+	/**
+	 * Bits of the last extracted key, or of the least key after refill.
+	 */
+	private: mutable bits_type lastBits;
+
+	private: std::size_t size;
+
+
+	public: RadixHeap(TPL_RadixHeap_KeyExtractor getKey = TPL_RadixHeap_KeyExtractor()):
+			getKey(getKey),
+			lastBits(0),
+			size(0)
+	{
+		//nothing
+	}
+
+	/**
+	 * Adds an element; its key must not be less than the last extracted key.
+	 *
+	 * @time O(1)
+	 */
+	public: void insert(TPL_RadixHeap_T const &element)
+	{
+		bits_type bits = RadixKeyTraits <key_type> ::toBits(this->getKey(element));
+		
+		assert(bits >= this->lastBits);
+		
+		this->buckets[this->getBucket(bits)].push_back({bits, element});
+		this->size++;
+	}
+
+	/**
+	 * Adds elements [first; last).
+	 */
+	public: template <typename TPL_InputIterator> void insertRange(TPL_InputIterator first, TPL_InputIterator last)
+	{
+		for ( ; first != last; ++first)
+		{
+			this->insert(*first);
+		}
+	}
+
+	/**
+	 * Deletes element with the least key. Queue must not be empty.
+	 *
+	 * @return The deleted element.
+	 * @time O(number of bits of keys) amortized
+	 */
+	public: TPL_RadixHeap_T extract()
+	{
+		assert(this->size > 0);
+		
+		this->refill();
+		
+		TPL_RadixHeap_T res = this->buckets[0].back().element;
+		this->buckets[0].pop_back();
+		this->size--;
+		
+		return res;
+	}
+
+	/**
+	 * Deletes count elements with the least keys and writes them to out
+	 * in order of increasing keys.
+	 * Queue must have at least count elements.
+	 *
+	 * @return Iterator behind the last written element.
+	 */
+	public: template <typename TPL_OutputIterator> TPL_OutputIterator extractN(std::size_t count, TPL_OutputIterator out)
+	{
+		assert(count <= this->size);
+		
+		for (std::size_t i = 0; i < count; i++)
+		{
+			*out++ = this->extract();
+		}
+		
+		return out;
+	}
+
+	/**
+	 * Moves all elements of other queue to this queue; their keys must not
+	 * be less than the last key extracted from this queue.
+	 */
+	public: void meld(RadixHeap &other)
+	{
+		assert(this != &other);
+		
+		for (std::vector <Entry> &bucket : other.buckets)
+		{
+			for (Entry const &entry : bucket)
+			{
+				assert(entry.bits >= this->lastBits);
+				this->buckets[this->getBucket(entry.bits)].push_back(entry);
+			}
+			
+			this->size += bucket.size();
+			bucket.clear();
+		}
+		
+		other.size = 0;
+	}
+
+	/**
+	 * Returns element with the least key, but doesn't remove it.
+	 * Queue must not be empty.
+	 */
+	public: TPL_RadixHeap_T peek() const
+	{
+		assert(this->size > 0);
+		
+		this->refill();
+		
+		return this->buckets[0].back().element;
+	}
+
+	public: bool isEmpty() const
+	{
+		return this->size == 0;
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	private: std::size_t getBucket(bits_type bits) const
+	{
+		return (std::size_t) std::bit_width((bits_type) (bits ^ this->lastBits));
+	}
+
+	/**
+	 * If bucket 0 is empty, moves the least key to lastBits and
+	 * redistributes the first non-empty bucket into lower ones.
+	 */
+	private: void refill() const
+	{
+		if (!this->buckets[0].empty())
+		{
+			return;
+		}
+		
+		std::size_t i = 1;
+		
+		while (this->buckets[i].empty())
+		{
+			i++;
+		}
+		
+		std::vector <Entry> &bucket = this->buckets[i];
+		bits_type least = bucket[0].bits;
+		
+		for (Entry const &entry : bucket)
+		{
+			least = std::min(least, entry.bits);
+		}
+		
+		this->lastBits = least;
+		
+		for (Entry const &entry : bucket)
+		{
+			this->buckets[this->getBucket(entry.bits)].push_back(entry);
+		}
+		
+		bucket.clear();
+	}
+}
+
+
+}
+
+
+#endif
@@ -1,25 +1,940 @@
+#ifndef EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__SHELF_H
+#define EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__SHELF_H
+
+
+#include <eugenejonas/cpp_stuff/fenwick_tree.h>
+#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
+#include <concepts>
+#else
+#include <boost/concept_check.hpp>
+#include <boost/concept/assert.hpp>
+#endif
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Index of Shelf blocks which scans them: finding the block containing a
+ * position takes O(blocks) time, updates take O(1) time. The first empty
+ * block is searched from cursor k (all blocks before it are non-empty), so
+ * that repeated adds don't rescan the filled beginning of the shelf.
+ * 
+ * Shelf calls insert, erase and update after it has changed its blocks, so
+ * that an index may keep own data about them; the blocks are passed as
+ * TPL_Blocks with operator[] returning blocks with count and isEmpty().
+ */
+class LinearShelfIndex
+{
+	private: int32_t k;				//start search for first empty block from this index
+
+
+	public: LinearShelfIndex():
+			k(0)
+	{
+		//nothing
+	}
+
+	public: template <typename TPL_Blocks> bool invariant(TPL_Blocks const &blocks, int32_t size) const
+	{
+		assert(this->k >= 0 && this->k <= size);
+		
+		for (int32_t i = 0; i < this->k; i++)
+		{
+			assert(!blocks[i].isEmpty());
+		}
+		
+		return true;
+	}
+
+	/**
+	 * Block blocks[i] has been inserted.
+	 */
+	public: template <typename TPL_Blocks> void insert(TPL_Blocks const &blocks, int32_t i)
+	{
+		if (blocks[i].isEmpty())
+		{
+			if (i < this->k)
+			{
+				this->k = i;
+			}
+		}
+		else if (i <= this->k)
+		{
+			this->k++;
+		}
+	}
+
+	/**
+	 * Blocks [i .. i + count - 1] have been erased.
+	 */
+	public: void erase(int32_t i, int32_t count)
+	{
+		if (this->k >= i + count)
+		{
+			this->k -= count;
+		}
+		else if (this->k > i)
+		{
+			this->k = i;
+		}
+	}
+
+	/**
+	 * Count of block blocks[i] has been changed.
+	 */
+	public: template <typename TPL_Blocks> void update(TPL_Blocks const &blocks, int32_t i)
+	{
+		if (blocks[i].isEmpty())
+		{
+			if (i < this->k)
+			{
+				this->k = i;
+			}
+		}
+		else if (i == this->k)
+		{
+			this->k++;
+		}
+	}
+
+	/**
+	 * Returns index of the block containing position n.
+	 */
+	public: template <typename TPL_Blocks> int32_t findBlock(TPL_Blocks const &blocks, int32_t size, int32_t n) const
+	{
+		int32_t sum = 0;
+		
+		for (int32_t i = 0; i < size; i++)
+		{
+			/*
+			 * Loop invariant:
+			 * sum == |blocks[0].count| + |blocks[1].count| + ... + |blocks[i - 1].count| <= n
+			 */
+
+			sum += (blocks[i].isEmpty() ? -blocks[i].count : blocks[i].count);
+			
+			if (sum > n)
+			{
+				return i;
+			}
+		}
+		
+		assert(false);
+		return size;
+	}
+
+	/**
+	 * Returns the position of the first element of block blocks[i].
+	 */
+	public: template <typename TPL_Blocks> int32_t getBlockStart(TPL_Blocks const &blocks, int32_t i) const
+	{
+		int32_t sum = 0;
+		
+		for (int32_t j = 0; j < i; j++)
+		{
+			sum += (blocks[j].isEmpty() ? -blocks[j].count : blocks[j].count);
+		}
+		
+		return sum;
+	}
+
+	/**
+	 * Returns index of the first empty block.
+	 * 
+	 * @pre There is an empty block.
+	 */
+	public: template <typename TPL_Blocks> int32_t findFirstEmptyBlock(TPL_Blocks const &blocks, int32_t size)
+	{
+		for ( ; this->k < size; this->k++)
+		{
+			if (blocks[this->k].isEmpty())
+			{
+				return this->k;
+			}
+		}
+		
+		assert(false);
+		return size;
+	}
+}
+
+/**
+ * Index of Shelf blocks in an order-statistic tree: a treap with implicit
+ * keys (block indexes), whose nodes store the number of blocks, positions
+ * and empty blocks in their subtrees. Finding the block containing a
+ * position, finding the first empty block and all updates take O(log blocks)
+ * expected time, so Shelf::poll doesn't depend on the number of blocks.
+ * See LinearShelfIndex for the interface.
+ */
+class TreeShelfIndex
+{
+	private: static const int32_t NIL = 0;
+
+
+	private: struct Node
+	{
+		public: int32_t left, right;
+		public: uint32_t priority;
+		public: int32_t length;
+		public: bool isEmpty;
+
+		/**
+		 * Sums over the subtree. Sum of lengths may exceed 2 ^ 31 - 1 in the
+		 * middle of a Shelf operation (new block is inserted before the old
+		 * one is shortened).
+		 */
+		public: int32_t blockCount, emptyBlockCount;
+		public: int64_t lengthSum;
+	}
+
+
+	/**
+	 * nodes[NIL] is a sentinel with zero sums, so that children needn't be checked.
+	 * Erased nodes are reused from freeNodes.
+	 */
+	private: std::vector <Node> nodes;
+	private: std::vector <int32_t> freeNodes;
+	private: int32_t root;
+	private: uint32_t seed;
+
+
+	public: TreeShelfIndex():
+			nodes(1, Node{NIL, NIL, 0, 0, false, 0, 0, 0}),
+			root(NIL),
+			seed(2463534242u)
+	{
+		//nothing
+	}
+
+	public: template <typename TPL_Blocks> bool invariant([[maybe_unused]] TPL_Blocks const &blocks, int32_t size) const
+	{
+		assert(this->nodes[this->root].blockCount == size);
+		assert(this->nodes[NIL].blockCount == 0 && this->nodes[NIL].lengthSum == 0 && this->nodes[NIL].emptyBlockCount == 0);
+		
+		#ifdef EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
+		int32_t i = 0;
+		this->checkSubtree(blocks, this->root, i);
+		#endif
+		
+		return true;
+	}
+
+	public: template <typename TPL_Blocks> void insert(TPL_Blocks const &blocks, int32_t i)
+	{
+		int32_t a, b;
+		this->split(this->root, i, a, b);
+		this->root = this->merge(this->merge(a, this->createNode(blocks[i])), b);
+	}
+
+	public: void erase(int32_t i, int32_t count)
+	{
+		int32_t a, b, c;
+		this->split(this->root, i, a, b);
+		this->split(b, count, b, c);
+		this->releaseSubtree(b);
+		this->root = this->merge(a, c);
+	}
+
+	public: template <typename TPL_Blocks> void update(TPL_Blocks const &blocks, int32_t i)
+	{
+		this->update(this->root, i, blocks[i].isEmpty() ? -blocks[i].count : blocks[i].count, blocks[i].isEmpty());
+	}
+
+	public: template <typename TPL_Blocks> int32_t findBlock(TPL_Blocks const &, int32_t, int32_t n) const
+	{
+		assert(n < this->nodes[this->root].lengthSum);
+		int64_t position = n;
+		int32_t x = this->root, res = 0;
+		
+		while (true)
+		{
+			Node const &node = this->nodes[x];
+			Node const &left = this->nodes[node.left];
+			
+			if (position < left.lengthSum)
+			{
+				x = node.left;
+				continue;
+			}
+			
+			position -= left.lengthSum;
+			res += left.blockCount;
+			
+			if (position < node.length)
+			{
+				return res;
+			}
+			
+			position -= node.length;
+			res++;
+			x = node.right;
+		}
+	}
+
+	public: template <typename TPL_Blocks> int32_t getBlockStart(TPL_Blocks const &, int32_t i) const
+	{
+		assert(i < this->nodes[this->root].blockCount);
+		int32_t x = this->root;
+		int64_t res = 0;
+		
+		while (true)
+		{
+			Node const &node = this->nodes[x];
+			Node const &left = this->nodes[node.left];
+			
+			if (i < left.blockCount)
+			{
+				x = node.left;
+				continue;
+			}
+			
+			res += left.lengthSum;
+			
+			if (i == left.blockCount)
+			{
+				return (int32_t) res;
+			}
+			
+			res += node.length;
+			i -= left.blockCount + 1;
+			x = node.right;
+		}
+	}
+
+	public: template <typename TPL_Blocks> int32_t findFirstEmptyBlock(TPL_Blocks const &, int32_t)
+	{
+		assert(this->nodes[this->root].emptyBlockCount > 0);
+		int32_t x = this->root, res = 0;
+		
+		while (true)
+		{
+			Node const &node = this->nodes[x];
+			Node const &left = this->nodes[node.left];
+			
+			if (left.emptyBlockCount > 0)
+			{
+				x = node.left;
+				continue;
+			}
+			
+			res += left.blockCount;
+			
+			if (node.isEmpty)
+			{
+				return res;
+			}
+			
+			res++;
+			x = node.right;
+		}
+	}
+
+	private: template <typename TPL_Block> int32_t createNode(TPL_Block const &block)
+	{
+		// xorshift32
+		this->seed ^= this->seed << 13;
+		this->seed ^= this->seed >> 17;
+		this->seed ^= this->seed << 5;
+		
+		int32_t length = block.isEmpty() ? -block.count : block.count;
+		Node node = {NIL, NIL, this->seed, length, block.isEmpty(), 1, block.isEmpty() ? 1 : 0, length};
+		
+		if (this->freeNodes.empty())
+		{
+			this->nodes.push_back(node);
+			return (int32_t) this->nodes.size() - 1;
+		}
+		
+		int32_t x = this->freeNodes.back();
+		this->freeNodes.pop_back();
+		this->nodes[x] = node;
+		return x;
+	}
+
+	private: void releaseSubtree(int32_t x)
+	{
+		if (x != NIL)
+		{
+			this->releaseSubtree(this->nodes[x].left);
+			this->releaseSubtree(this->nodes[x].right);
+			this->freeNodes.push_back(x);
+		}
+	}
+
+	/**
+	 * Recalculates sums of node x from its children.
+	 */
+	private: void pull(int32_t x)
+	{
+		Node &node = this->nodes[x];
+		Node const &left = this->nodes[node.left], &right = this->nodes[node.right];
+		node.blockCount = left.blockCount + 1 + right.blockCount;
+		node.lengthSum = left.lengthSum + node.length + right.lengthSum;
+		node.emptyBlockCount = left.emptyBlockCount + (node.isEmpty ? 1 : 0) + right.emptyBlockCount;
+	}
+
+	/**
+	 * Splits subtree x into the first count blocks (a) and the rest (b).
+	 */
+	private: void split(int32_t x, int32_t count, int32_t &a, int32_t &b)
+	{
+		if (x == NIL)
+		{
+			a = b = NIL;
+			return;
+		}
+		
+		if (this->nodes[this->nodes[x].left].blockCount < count)
+		{
+			this->split(this->nodes[x].right, count - this->nodes[this->nodes[x].left].blockCount - 1, a, b);
+			this->nodes[x].right = a;
+			a = x;
+		}
+		else
+		{
+			this->split(this->nodes[x].left, count, a, b);
+			this->nodes[x].left = b;
+			b = x;
+		}
+		
+		this->pull(x);
+	}
+
+	/**
+	 * Returns root of the concatenation of subtrees a and b.
+	 */
+	private: int32_t merge(int32_t a, int32_t b)
+	{
+		if (a == NIL || b == NIL)
+		{
+			return (a == NIL ? b : a);
+		}
+		
+		if (this->nodes[a].priority > this->nodes[b].priority)
+		{
+			this->nodes[a].right = this->merge(this->nodes[a].right, b);
+			this->pull(a);
+			return a;
+		}
+		else
+		{
+			this->nodes[b].left = this->merge(a, this->nodes[b].left);
+			this->pull(b);
+			return b;
+		}
+	}
+
+	private: void update(int32_t x, int32_t i, int32_t length, bool isEmpty)
+	{
+		int32_t leftCount = this->nodes[this->nodes[x].left].blockCount;
+		
+		if (i < leftCount)
+		{
+			this->update(this->nodes[x].left, i, length, isEmpty);
+		}
+		else if (i > leftCount)
+		{
+			this->update(this->nodes[x].right, i - leftCount - 1, length, isEmpty);
+		}
+		else
+		{
+			this->nodes[x].length = length;
+			this->nodes[x].isEmpty = isEmpty;
+		}
+		
+		this->pull(x);
+	}
+
+	/**
+	 * Compares nodes of subtree x with blocks starting from blocks[i].
+	 */
+	private: template <typename TPL_Blocks> void checkSubtree(TPL_Blocks const &blocks, int32_t x, int32_t &i) const
+	{
+		if (x == NIL)
+		{
+			return;
+		}
+		
+		Node const &node = this->nodes[x];
+		this->checkSubtree(blocks, node.left, i);
+		assert(node.isEmpty == blocks[i].isEmpty());
+		assert(node.length == (blocks[i].isEmpty() ? -blocks[i].count : blocks[i].count));
+		i++;
+		this->checkSubtree(blocks, node.right, i);
+		
+		Node const &left = this->nodes[node.left], &right = this->nodes[node.right];
+		assert(node.blockCount == left.blockCount + 1 + right.blockCount);
+		assert(node.lengthSum == left.lengthSum + node.length + right.lengthSum);
+		assert(node.emptyBlockCount == left.emptyBlockCount + (node.isEmpty ? 1 : 0) + right.emptyBlockCount);
+		assert(left.priority <= node.priority && right.priority <= node.priority);
+	}
+}
+
+/**
+ * Index of Shelf blocks by elements which scans the blocks backwards to
+ * find the last block of an element, in O(blocks) time.
+ * 
+ * Shelf calls erase before a block holding elements is removed or moved
+ * (its first position changes) and insert after a block holding elements
+ * has been added or moved, when both Shelf and its TPL_Index are updated.
+ */
+class LinearShelfElementIndex
+{
+	public: template <typename TPL_Blocks, typename TPL_Index> bool invariant(TPL_Blocks const &, int32_t, TPL_Index const &) const
+	{
+		return true;
+	}
+
+	public: template <typename TPL_Blocks, typename TPL_Index> void insert(TPL_Blocks const &, TPL_Index const &, int32_t)
+	{
+		//nothing
+	}
+
+	public: template <typename TPL_Blocks, typename TPL_Index> void erase(TPL_Blocks const &, TPL_Index const &, int32_t)
+	{
+		//nothing
+	}
+
+	/**
+	 * Returns index of the last block holding the element.
+	 * 
+	 * @pre There is such block.
+	 */
+	public: template <typename TPL_Blocks, typename TPL_Index, typename TPL_T> int32_t findLastBlock(TPL_Blocks const &blocks, int32_t size, TPL_Index const &, TPL_T const &element) const
+	{
+		int32_t i = size - 1;
+		
+		while (blocks[i].isEmpty() || blocks[i].element != element)
+		{
+			i--;
+		}
+		
+		assert(i >= 0);
+		return i;
+	}
+}
+
+/**
+ * Index of Shelf blocks by elements for small element domains (like char):
+ * a table with an ordered set of first positions of the blocks for every
+ * element value. Positions (unlike block indexes) don't change when other
+ * blocks are split or merged, so the table needs updates only for blocks
+ * of the element; the last block is found by TPL_Index::findBlock, which
+ * takes O(log blocks) time with TreeShelfIndex.
+ * 
+ * The table needs an index which finds blocks and their first positions in
+ * O(log blocks) time: with LinearShelfIndex every update of the table would
+ * sum the lengths of all preceding blocks, which makes add take O(blocks)
+ * time, so Shelf accepts the table only with TreeShelfIndex.
+ * 
+ * @param TPL_TableShelfElementIndex_T Integral type of at most 16 bits.
+ */
+template <typename TPL_TableShelfElementIndex_T> class TableShelfElementIndex
+{
+	static_assert(std::is_integral <TPL_TableShelfElementIndex_T> ::value && sizeof(TPL_TableShelfElementIndex_T) <= 2,
+			"TableShelfElementIndex needs integral type of at most 16 bits");
+
+
+	private: typedef typename std::make_unsigned <TPL_TableShelfElementIndex_T> ::type Key;
+
+
+	private: std::vector <std::set <int32_t> > starts;
+	private: int32_t blockCount;
+
+
+	public: TableShelfElementIndex():
+			starts((std::size_t) 1 << (8 * sizeof(TPL_TableShelfElementIndex_T))),
+			blockCount(0)
+	{
+		//nothing
+	}
+
+	public: template <typename TPL_Blocks, typename TPL_Index> bool invariant([[maybe_unused]] TPL_Blocks const &blocks, [[maybe_unused]] int32_t size, TPL_Index const &) const
+	{
+		#ifdef EUGENEJONAS__CPP_STUFF__HEAVY_INVARIANTS
+		int32_t start = 0, count = 0;
+		
+		for (int32_t i = 0; i < size; i++)
+		{
+			if (!blocks[i].isEmpty())
+			{
+				assert(this->starts[(Key) blocks[i].element].count(start) == 1);
+				count++;
+			}
+			
+			start += (blocks[i].isEmpty() ? -blocks[i].count : blocks[i].count);
+		}
+		
+		assert(count == this->blockCount);
+		#endif
+		
+		return true;
+	}
+
+	public: template <typename TPL_Blocks, typename TPL_Index> void insert(TPL_Blocks const &blocks, TPL_Index const &index, int32_t i)
+	{
+		assert(!blocks[i].isEmpty());
+		this->starts[(Key) blocks[i].element].insert(index.getBlockStart(blocks, i));
+		this->blockCount++;
+	}
+
+	public: template <typename TPL_Blocks, typename TPL_Index> void erase(TPL_Blocks const &blocks, TPL_Index const &index, int32_t i)
+	{
+		assert(!blocks[i].isEmpty());
+		this->starts[(Key) blocks[i].element].erase(index.getBlockStart(blocks, i));
+		this->blockCount--;
+	}
 
-#ifndef EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__SHELF_H
-#define EUGENEJONAS__CPP_STUFF__POD_CONTAINERS__SHELF_H
+	public: template <typename TPL_Blocks, typename TPL_Index> int32_t findLastBlock(TPL_Blocks const &blocks, int32_t size, TPL_Index const &index, TPL_TableShelfElementIndex_T element) const
+	{
+		std::set <int32_t> const &elementStarts = this->starts[(Key) element];
+		assert(!elementStarts.empty());
+		return index.findBlock(blocks, size, *elementStarts.rbegin());
+	}
+}
 
+/**
+ * Storage of Shelf blocks in one array. Inserting or erasing a block moves
+ * all the following blocks, in O(blocks) time. The array grows by doubling.
+ * 
+ * @param TPL_ArrayShelfBlocks_Block Byte-copyable type of blocks.
+ */
+template <typename TPL_ArrayShelfBlocks_Block> class ArrayShelfBlocks
+{
+	private: TPL_ArrayShelfBlocks_Block *arr;
+	private: int32_t capacity, size;
 
-#include <eugenejonas/cpp_stuff/pod_containers/pod_containers.h>
 
-#include <cassert>
-#include <cstdint>
-#include <cstring>
+	/**
+	 * Constructs empty storage.
+	 * 
+	 * @param capacity Number of blocks it can store without reallocation.
+	 */
+	public: ArrayShelfBlocks(int32_t capacity):
+			arr(new TPL_ArrayShelfBlocks_Block[capacity]),
+			capacity(capacity),
+			size(0)
+	{
+		assert(capacity > 0);
+	}
 
-#ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
-#include <concepts>
-#else
-#include <boost/concept_check.hpp>
-#include <boost/concept/assert.hpp>
-#endif
+	public: ~ArrayShelfBlocks()
+	{
+		delete[] this->arr;
+	}
 
+	public: TPL_ArrayShelfBlocks_Block &operator[](int32_t i)
+	{
+		assert(i >= 0 && i < this->size);
+		return this->arr[i];
+	}
 
-namespace eugenejonas::cpp_stuff
+	public: TPL_ArrayShelfBlocks_Block const &operator[](int32_t i) const
+	{
+		assert(i >= 0 && i < this->size);
+		return this->arr[i];
+	}
+
+	public: int32_t getSize() const
+	{
+		return this->size;
+	}
+
+	/**
+	 * Inserts count uninitialized blocks before block i (or at the end, if
+	 * i == size).
+	 */
+	public: void insert(int32_t i, int32_t count)
+	{
+		assert(i >= 0 && i <= this->size && count > 0);
+		this->ensureCapacity(this->size + count);
+		
+		if (this->size - i > 0)
+		{
+			std::memmove(&this->arr[i + count], &this->arr[i], sizeof(TPL_ArrayShelfBlocks_Block) * (this->size - i));
+		}
+		
+		this->size += count;
+	}
+
+	/**
+	 * Erases blocks [i .. i + count - 1].
+	 */
+	public: void erase(int32_t i, int32_t count)
+	{
+		assert(i >= 0 && count > 0 && i + count <= this->size);
+		
+		if (this->size - i - count > 0)
+		{
+			std::memmove(&this->arr[i], &this->arr[i + count], sizeof(TPL_ArrayShelfBlocks_Block) * (this->size - i - count));
+		}
+		
+		this->size -= count;
+	}
+
+	private: void ensureCapacity(int32_t minCapacity)
+	{
+		assert(minCapacity > 0);
+		
+		if (minCapacity <= this->capacity)
+		{
+			return;
+		}
+		
+		this->capacity = (int32_t) std::max((int64_t) minCapacity, std::min((int64_t) 2 * this->capacity, (int64_t) 2147483647));
+		TPL_ArrayShelfBlocks_Block *tmp = new TPL_ArrayShelfBlocks_Block[this->capacity];
+		std::memcpy(tmp, this->arr, this->size * sizeof(TPL_ArrayShelfBlocks_Block));
+		delete[] this->arr;
+		this->arr = tmp;
+	}
+}
+
+/**
+ * Storage of Shelf blocks in chunks of up to CHUNK_CAPACITY blocks (an
+ * unrolled list with an index). Inserting or erasing a block moves only
+ * blocks of its chunk; a full chunk is split in halves and a chunk is
+ * merged with its neighbour when they fit into half of a chunk together,
+ * so that chunks are at least a quarter full on average.
+ * 
+ * Block i is found by a FenwickTree over sizes of the chunks in O(log chunks)
+ * time; the last found chunk is remembered, so that accessing the same block
+ * or its neighbours (as Shelf and LinearShelfIndex do) takes O(1) time.
+ * 
+ * @param TPL_ChunkedShelfBlocks_Block Byte-copyable type of blocks.
+ */
+template <typename TPL_ChunkedShelfBlocks_Block> class ChunkedShelfBlocks
 {
+	public: static const int32_t CHUNK_CAPACITY = 256;
+
+
+	private: struct Chunk
+	{
+		public: int32_t size;
+		public: TPL_ChunkedShelfBlocks_Block blocks[CHUNK_CAPACITY];
+	}
+
+
+	private: std::vector <Chunk*> chunks;
+	private: FenwickTree <int32_t> chunkSizes;
+	private: int32_t size;
+
+	/**
+	 * Index of the last found chunk and index of its first block.
+	 */
+	private: mutable int32_t cachedChunk, cachedFirst;
+
+
+	/**
+	 * Constructs empty storage.
+	 * 
+	 * @param capacity Expected number of blocks.
+	 */
+	public: ChunkedShelfBlocks(int32_t capacity):
+			chunks(1, new Chunk),
+			chunkSizes(1),
+			size(0),
+			cachedChunk(0),
+			cachedFirst(0)
+	{
+		this->chunks.reserve(capacity / CHUNK_CAPACITY + 1);
+		this->chunks[0]->size = 0;
+	}
+
+	public: ~ChunkedShelfBlocks()
+	{
+		for (Chunk *chunk : this->chunks)
+		{
+			delete chunk;
+		}
+	}
+
+	public: TPL_ChunkedShelfBlocks_Block &operator[](int32_t i)
+	{
+		assert(i >= 0 && i < this->size);
+		this->find(i);
+		return this->chunks[this->cachedChunk]->blocks[i - this->cachedFirst];
+	}
+
+	public: TPL_ChunkedShelfBlocks_Block const &operator[](int32_t i) const
+	{
+		assert(i >= 0 && i < this->size);
+		this->find(i);
+		return this->chunks[this->cachedChunk]->blocks[i - this->cachedFirst];
+	}
+
+	public: int32_t getSize() const
+	{
+		return this->size;
+	}
+
+	/**
+	 * Inserts count uninitialized blocks before block i (or at the end, if
+	 * i == size).
+	 * 
+	 * @param count 0 < count <= CHUNK_CAPACITY / 2.
+	 */
+	public: void insert(int32_t i, int32_t count)
+	{
+		assert(i >= 0 && i <= this->size && count > 0 && count <= CHUNK_CAPACITY / 2);
+		this->findForInsert(i);
+		
+		if (this->chunks[this->cachedChunk]->size + count > CHUNK_CAPACITY)
+		{
+			this->split(this->cachedChunk);
+			this->findForInsert(i);
+		}
+		
+		Chunk *chunk = this->chunks[this->cachedChunk];
+		int32_t j = i - this->cachedFirst;
+		std::memmove(&chunk->blocks[j + count], &chunk->blocks[j], sizeof(TPL_ChunkedShelfBlocks_Block) * (chunk->size - j));
+		chunk->size += count;
+		this->chunkSizes.add(this->cachedChunk, count);
+		this->size += count;
+	}
+
+	/**
+	 * Erases blocks [i .. i + count - 1].
+	 */
+	public: void erase(int32_t i, int32_t count)
+	{
+		assert(i >= 0 && count > 0 && i + count <= this->size);
+		
+		while (count > 0)
+		{
+			this->find(i);
+			Chunk *chunk = this->chunks[this->cachedChunk];
+			int32_t j = i - this->cachedFirst;
+			int32_t erasedCount = std::min(count, chunk->size - j);
+			std::memmove(&chunk->blocks[j], &chunk->blocks[j + erasedCount], sizeof(TPL_ChunkedShelfBlocks_Block) * (chunk->size - j - erasedCount));
+			chunk->size -= erasedCount;
+			this->chunkSizes.add(this->cachedChunk, -erasedCount);
+			this->size -= erasedCount;
+			count -= erasedCount;
+			this->mergeWithNeighbour(this->cachedChunk);
+		}
+	}
+
+	/**
+	 * Sets the cached chunk to the chunk containing block i.
+	 */
+	private: void find(int32_t i) const
+	{
+		Chunk const *cached = this->chunks[this->cachedChunk];
+		
+		if (i >= this->cachedFirst && i < this->cachedFirst + cached->size)
+		{
+			return;
+		}
+		
+		if (i == this->cachedFirst + cached->size && this->cachedChunk + 1 < (int32_t) this->chunks.size() && this->chunks[this->cachedChunk + 1]->size > 0)
+		{
+			this->cachedFirst += cached->size;
+			this->cachedChunk++;
+			return;
+		}
+		
+		if (i == this->cachedFirst - 1 && this->chunks[this->cachedChunk - 1]->size > 0)
+		{
+			this->cachedChunk--;
+			this->cachedFirst -= this->chunks[this->cachedChunk]->size;
+			return;
+		}
+		
+		this->cachedChunk = (int32_t) this->chunkSizes.getUpperBound(i);
+		this->cachedFirst = this->chunkSizes.getPrefixSum(this->cachedChunk);
+	}
+
+	/**
+	 * Like find, but block i may be at the end of the storage.
+	 */
+	private: void findForInsert(int32_t i)
+	{
+		if (i < this->size)
+		{
+			this->find(i);
+		}
+		else
+		{
+			this->cachedChunk = (int32_t) this->chunks.size() - 1;
+			this->cachedFirst = this->size - this->chunks.back()->size;
+		}
+	}
+
+	/**
+	 * Moves the second half of chunk c to a new chunk after it.
+	 */
+	private: void split(int32_t c)
+	{
+		Chunk *chunk = this->chunks[c], *next = new Chunk;
+		next->size = chunk->size / 2;
+		chunk->size -= next->size;
+		std::memcpy(next->blocks, &chunk->blocks[chunk->size], sizeof(TPL_ChunkedShelfBlocks_Block) * next->size);
+		this->chunks.insert(this->chunks.begin() + c + 1, next);
+		this->rebuildIndex();
+	}
+
+	/**
+	 * Merges chunk c with its next or previous chunk, if they fit into
+	 * half of a chunk together or chunk c is empty.
+	 */
+	private: void mergeWithNeighbour(int32_t c)
+	{
+		bool isEmpty = (this->chunks[c]->size == 0);
+		
+		if (c + 1 < (int32_t) this->chunks.size() && (isEmpty || this->chunks[c]->size + this->chunks[c + 1]->size <= CHUNK_CAPACITY / 2))
+		{
+			this->merge(c);
+		}
+		else if (c > 0 && (isEmpty || this->chunks[c - 1]->size + this->chunks[c]->size <= CHUNK_CAPACITY / 2))
+		{
+			this->merge(c - 1);
+		}
+	}
+
+	/**
+	 * Moves blocks of chunk c + 1 to the end of chunk c and deletes chunk c + 1.
+	 */
+	private: void merge(int32_t c)
+	{
+		Chunk *chunk = this->chunks[c], *next = this->chunks[c + 1];
+		std::memcpy(&chunk->blocks[chunk->size], next->blocks, sizeof(TPL_ChunkedShelfBlocks_Block) * next->size);
+		chunk->size += next->size;
+		delete next;
+		this->chunks.erase(this->chunks.begin() + c + 1);
+		this->rebuildIndex();
+	}
 
+	/**
+	 * Rebuilds chunkSizes after chunks have been added or deleted.
+	 * 
+	 * @time O(chunks)
+	 */
+	private: void rebuildIndex()
+	{
+		std::vector <int32_t> sizes(this->chunks.size());
+		
+		for (std::size_t c = 0; c < this->chunks.size(); c++)
+		{
+			sizes[c] = this->chunks[c]->size;
+		}
+		
+		this->chunkSizes = FenwickTree <int32_t> (sizes.begin(), sizes.end());
+		this->cachedChunk = 0;
+		this->cachedFirst = 0;
+	}
+}
 
 /**
  * This class represents specific data structure created to solve task
@@ -34,9 +949,26 @@ namespace eugenejonas::cpp_stuff
  * This class supports only byte-copyable element types.
  * 
  * @param TPL_Shelf_T Type of elements stored in the container.
+ * @param TPL_Shelf_Index LinearShelfIndex or TreeShelfIndex, which finds
+ *		blocks by position (see poll) in O(log blocks) time, but needs more
+ *		memory and time for updates.
+ * @param TPL_Shelf_ElementIndex LinearShelfElementIndex or
+ *		TableShelfElementIndex <TPL_Shelf_T>, which finds the last block of
+ *		an element (see remove) without scanning the blocks; the latter
+ *		needs TreeShelfIndex.
+ * @param TPL_Shelf_Blocks ArrayShelfBlocks or ChunkedShelfBlocks, which
+ *		inserts and erases blocks in O(CHUNK_CAPACITY) time instead of moving
+ *		all the following blocks, but accesses them in O(log blocks) time
+ *		(O(1) for neighbours of the last accessed block).
  */
-template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
+template <typename TPL_Shelf_T, typename TPL_Shelf_Index = LinearShelfIndex, typename TPL_Shelf_ElementIndex = LinearShelfElementIndex,
+		template <typename> class TPL_Shelf_Blocks = ArrayShelfBlocks>
+class Shelf: public PodContainer <TPL_Shelf_T>
 {
+	static_assert(!std::is_same <TPL_Shelf_ElementIndex, TableShelfElementIndex <TPL_Shelf_T> > ::value || std::is_same <TPL_Shelf_Index, TreeShelfIndex> ::value,
+			"TableShelfElementIndex needs TreeShelfIndex");
+
+
 	/**
 	 * Represents continuos block of same elements (or empty cells).
 	 */
@@ -80,76 +1012,57 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 	
 	
 	/**
-	 * capacity is length of array arr.
-	 * size indicates how many array arr elements (of type ElementBlock) are used,
-	 * 		it's not number of elements of type TPL_Shelf_T stored in the container.
+	 * blocks.getSize() is the number of blocks, it's not number of elements
+	 * 		of type TPL_Shelf_T stored in the container.
 	 * emptyCount indicates how many elements can be put into the container.
 	 *
-	 * Methods can safely access elements at indexes [0 .. size - 1].
-	 * Maximum possible value for capacity, size and k is 2 ^ 31 - 1.
+	 * Methods can safely access blocks at indexes [0 .. blocks.getSize() - 1].
+	 * Maximum possible value for the number of blocks is 2 ^ 31 - 1.
 	 */
-	private: int32_t capacity, size, emptyCount;
-	private: mutable int32_t k;				//start search for first empty block from this index
-	private: ElementBlock *arr;
+	private: int32_t emptyCount;
+	private: TPL_Shelf_Blocks <ElementBlock> blocks;
+	private: TPL_Shelf_Index index;
+	private: TPL_Shelf_ElementIndex elements;
 
 
 	public: Shelf():
-			arr(new ElementBlock[100000]),
-			capacity(100000),
-			size(1),
 			emptyCount(2147483647),
-			k(0)
+			blocks(100000)
 	{
-		this->arr[0].count = -2147483647;
+		this->blocks.insert(0, 1);
+		this->blocks[0].count = -2147483647;
+		this->index.insert(this->blocks, 0);
 		assert(this->invariant());
 	}
 
-	public: ~Shelf()
-	{
-		delete[] this->arr;
-	}
-
 	private: bool invariant() const
 	{
-		assert(this->arr != nullptr);
-		assert(this->capacity > 0 && this->size > 0 && this->size <= this->capacity && this->emptyCount >= 0 && this->k >= 0);
-		
-		if (this->emptyCount > 0)
-		{
-			assert(this->k < this->size);
-		}
-		else
-		{
-			assert(this->k <= this->size);
-		}
+		assert(this->blocks.getSize() > 0 && this->emptyCount >= 0);
+		assert(this->index.invariant(this->blocks, this->blocks.getSize()));
+		assert(this->elements.invariant(this->blocks, this->blocks.getSize(), this->index));
 		
 		int32_t countSum = 0, emptyCountSum = 0;
 		
-		for (int32_t i = 0; i < this->size; i++)
+		for (int32_t i = 0; i < this->blocks.getSize(); i++)
 		{
-			assert(this->arr[i].count != -2147483648 && this->arr[i].count != 0);
+			assert(this->blocks[i].count != -2147483648 && this->blocks[i].count != 0);
 			
-			countSum += (this->arr[i].isEmpty() ? -this->arr[i].count : this->arr[i].count);
+			countSum += (this->blocks[i].isEmpty() ? -this->blocks[i].count : this->blocks[i].count);
 			
-			if (this->arr[i].isEmpty())
+			if (this->blocks[i].isEmpty())
 			{
-				emptyCountSum -= this->arr[i].count;
+				emptyCountSum -= this->blocks[i].count;
 			}
 			
 			if (i > 0)
 			{
-				assert(this->arr[i] != this->arr[i - 1]);
+				assert(this->blocks[i] != this->blocks[i - 1]);
 			}
 		}
 		
 		assert(emptyCountSum == this->emptyCount);
 		assert(countSum == 2147483647);
 		
-		for (int32_t i = 0; i < this->k; i++)
-		{
-			assert(!this->arr[i].isEmpty());
-		}
-		
 		return true;
 	}
 
@@ -177,12 +1090,12 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 		{
 			int32_t i = this->getFirstEmptyBlock();
 			
-			if (-this->arr[i].count > count)
+			if (-this->blocks[i].count > count)
 			{
 				// enough place in arr[i] for all elements
 				// ensure that arr[i].element != arr[i - 1].element
 
-				bool isPreviousBlockEqual = i > 0 && this->arr[i - 1].count > 0 && this->arr[i - 1].element == element;
+				bool isPreviousBlockEqual = i > 0 && this->blocks[i - 1].count > 0 && this->blocks[i - 1].element == element;
 				
 				if (isPreviousBlockEqual)
 				{
@@ -190,26 +1103,27 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 
 					// do not need to call memmove
 
-					this->arr[i - 1].count += count;
-					this->arr[i].count += count;			// (!) not -=
-					assert(this->arr[i].count < 0 && this->arr[i - 1].count > 0);
+					this->blocks[i - 1].count += count;
+					this->blocks[i].count += count;			// (!) not -=
+					assert(this->blocks[i].count < 0 && this->blocks[i - 1].count > 0);
+					this->index.update(this->blocks, i - 1);
+					this->index.update(this->blocks, i);
 				}
 				else
 				{
 					//subcase 1.1.2 (shelf.odt)
 
 					// move to the right
-					this->ensureCapacity(this->size + 1);
-					std::memmove(&this->arr[i + 1], &this->arr[i], sizeof(ElementBlock) * (this->size - i));
-
-					assert(this->size - i > 0);
-					this->arr[i].count = count;
-					this->arr[i].element = element;
-					this->arr[i + 1].count += count;		// (!) not -=
-					assert(this->arr[i + 1].count < 0);
-					this->size++;
-					assert(this->k < i + 1);
-					this->k = i + 1;
+					this->blocks.insert(i, 1);
+
+					assert(this->blocks.getSize() - i > 1);
+					this->blocks[i].count = count;
+					this->blocks[i].element = element;
+					this->blocks[i + 1].count += count;		// (!) not -=
+					assert(this->blocks[i + 1].count < 0);
+					this->index.insert(this->blocks, i);
+					this->index.update(this->blocks, i + 1);
+					this->elements.insert(this->blocks, this->index, i);
 				}
 				
 				this->emptyCount -= count;
@@ -217,11 +1131,11 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 			}
 			else
 			{
-				bool isPreviousBlockEqual = i > 0 && this->arr[i - 1].count > 0 && element == this->arr[i - 1].element;
-				bool isNextBlockEqual = i < this->size - 1 && this->arr[i + 1].count > 0 && element == this->arr[i + 1].element;
+				bool isPreviousBlockEqual = i > 0 && this->blocks[i - 1].count > 0 && element == this->blocks[i - 1].element;
+				bool isNextBlockEqual = i < this->blocks.getSize() - 1 && this->blocks[i + 1].count > 0 && element == this->blocks[i + 1].element;
 				
-				this->emptyCount += this->arr[i].count;
-				count += this->arr[i].count;		// this->arr[i].count < 0
+				this->emptyCount += this->blocks[i].count;
+				count += this->blocks[i].count;		// this->blocks[i].count < 0
 				
 				if (isPreviousBlockEqual)
 				{
@@ -229,29 +1143,22 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 					{
 						//subcase 1.2.1 (shelf.odt)
 						
-						this->arr[i - 1].count += this->arr[i + 1].count - this->arr[i].count;
-						assert(this->size - i - 2 >= 0);
-						
-						if (this->size - i - 2 > 0)
-						{
-							std::memmove(&this->arr[i], &this->arr[i + 2], sizeof(ElementBlock) * (this->size - i - 2));
-						}
-						
-						this->size -= 2;
+						this->elements.erase(this->blocks, this->index, i + 1);
+						this->blocks[i - 1].count += this->blocks[i + 1].count - this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 2 >= 0);
+						this->blocks.erase(i, 2);
+						this->index.update(this->blocks, i - 1);
+						this->index.erase(i, 2);
 					}
 					else
 					{
 						//subcase 1.2.2 (shelf.odt)
 						
-						this->arr[i - 1].count -= this->arr[i].count;
-						assert(this->size - i - 1 >= 0);
-						
-						if (this->size - i - 1 > 0)
-						{
-							std::memmove(&this->arr[i], &this->arr[i + 1], sizeof(ElementBlock) * (this->size - i - 1));
-						}
-						
-						this->size--;
+						this->blocks[i - 1].count -= this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 1 >= 0);
+						this->blocks.erase(i, 1);
+						this->index.update(this->blocks, i - 1);
+						this->index.erase(i, 1);
 					}
 				}
 				else
@@ -260,19 +1167,22 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 					{
 						//subcase 1.2.3 (shelf.odt)
 						
-						this->arr[i + 1].count -= this->arr[i].count;
-						assert(this->size - i - 2 >= 0);
-						std::memmove(&this->arr[i], &this->arr[i + 1], sizeof(ElementBlock) * (this->size - i - 1));
-						this->size--;
-						this->k = i + 1;
+						this->elements.erase(this->blocks, this->index, i + 1);
+						this->blocks[i + 1].count -= this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 2 >= 0);
+						this->blocks.erase(i, 1);
+						this->index.erase(i, 1);
+						this->index.update(this->blocks, i);
+						this->elements.insert(this->blocks, this->index, i);
 					}
 					else
 					{
 						//subcase 1.2.4 (shelf.odt)
 						
-						this->arr[i].count = -this->arr[i].count;
-						this->arr[i].element = element;
-						this->k = i + 1;
+						this->blocks[i].count = -this->blocks[i].count;
+						this->blocks[i].element = element;
+						this->index.update(this->blocks, i);
+						this->elements.insert(this->blocks, this->index, i);
 					}
 				}
 			}
@@ -295,19 +1205,12 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 		
 		while (count > 0)
 		{
-			ElementBlock elementBlock = {element, 1};
-			int32_t i = this->size - 1;
-			
-			while (this->arr[i] != elementBlock)
-			{
-				i--;
-			}
-			
-			assert(i >= 0);
+			int32_t i = this->elements.findLastBlock(this->blocks, this->blocks.getSize(), this->index, element);
+			assert(i >= 0 && !this->blocks[i].isEmpty() && this->blocks[i].element == element);
 			
-			if (this->arr[i].count > count)
+			if (this->blocks[i].count > count)
 			{
-				bool isNextBlockEmpty = i < this->size - 1 && this->arr[i + 1].isEmpty();
+				bool isNextBlockEmpty = i < this->blocks.getSize() - 1 && this->blocks[i + 1].isEmpty();
 			
 				if (isNextBlockEmpty)
 				{
@@ -315,34 +1218,28 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 
 					// do not need to call memmove
 
-					this->arr[i + 1].count -= count;
-					this->arr[i].count -= count;
+					this->blocks[i + 1].count -= count;
+					this->blocks[i].count -= count;
 					
-					assert(this->arr[i].count > 0 && this->arr[i + 1].count < 0);
+					assert(this->blocks[i].count > 0 && this->blocks[i + 1].count < 0);
+					this->index.update(this->blocks, i);
+					this->index.update(this->blocks, i + 1);
 				}
 				else
 				{
 					//subcase 2.1.2 (shelf.odt)
 
-					this->ensureCapacity(this->size + 1);
-					assert(this->size - i - 1 >= 0);
+					assert(this->blocks.getSize() - i - 1 >= 0);
 
 					// move to the right
-					if (this->size - i - 1 > 0)
-					{
-						std::memmove(&this->arr[i + 2], &this->arr[i + 1], sizeof(ElementBlock) * (this->size - i - 1));
-					}
+					this->blocks.insert(i + 1, 1);
 
-					this->arr[i + 1].count = -count;
-					this->arr[i].count -= count;
+					this->blocks[i + 1].count = -count;
+					this->blocks[i].count -= count;
 					
-					assert(this->arr[i + 1].count < 0);
-					this->size++;
-					
-					if (this->k > i + 1)
-					{
-						this->k = i + 1;
-					}
+					assert(this->blocks[i + 1].count < 0);
+					this->index.update(this->blocks, i);
+					this->index.insert(this->blocks, i + 1);
 				}
 				
 				this->emptyCount += count;
@@ -350,11 +1247,12 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 			}
 			else
 			{
-				bool isPreviousBlockEmpty = i > 0 && this->arr[i - 1].isEmpty();
-				bool isNextBlockEmpty = i < this->size - 1 && this->arr[i + 1].isEmpty();
+				bool isPreviousBlockEmpty = i > 0 && this->blocks[i - 1].isEmpty();
+				bool isNextBlockEmpty = i < this->blocks.getSize() - 1 && this->blocks[i + 1].isEmpty();
 				
-				this->emptyCount += this->arr[i].count;
-				count -= this->arr[i].count;
+				this->elements.erase(this->blocks, this->index, i);
+				this->emptyCount += this->blocks[i].count;
+				count -= this->blocks[i].count;
 				
 				if (isPreviousBlockEmpty)
 				{
@@ -362,30 +1260,21 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 					{
 						//subcase 2.2.1 (shelf.odt)
 						
-						this->arr[i - 1].count += this->arr[i + 1].count - this->arr[i].count;
-						assert(this->size - i - 2 >= 0);
-						
-						if (this->size - i - 2 > 0)
-						{
-							std::memmove(&this->arr[i], &this->arr[i + 2], sizeof(ElementBlock) * (this->size - i - 2));
-						}
-						
-						this->size -= 2;
-						assert(this->k < i);
+						this->blocks[i - 1].count += this->blocks[i + 1].count - this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 2 >= 0);
+						this->blocks.erase(i, 2);
+						this->index.update(this->blocks, i - 1);
+						this->index.erase(i, 2);
 					}
 					else
 					{
 						//subcase 2.2.2 (shelf.odt)
 						
-						this->arr[i - 1].count -= this->arr[i].count;
-						assert(this->size - i - 1 >= 0);
-						
-						if (this->size - i - 1 > 0)
-						{
-							std::memmove(&this->arr[i], &this->arr[i + 1], sizeof(ElementBlock) * (this->size - i - 1));
-						}
-						
-						this->size--;
+						this->blocks[i - 1].count -= this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 1 >= 0);
+						this->blocks.erase(i, 1);
+						this->index.update(this->blocks, i - 1);
+						this->index.erase(i, 1);
 					}
 				}
 				else
@@ -394,35 +1283,18 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 					{
 						//subcase 2.2.3 (shelf.odt)
 						
-						this->arr[i + 1].count -= this->arr[i].count;
-						assert(this->size - i - 2 >= 0);
-						
-						std::memmove(&this->arr[i], &this->arr[i + 1], sizeof(ElementBlock) * (this->size - i - 1));
-						this->size--;
-						
-						if (this->k > i)
-						{
-							this->k = i;
-						}
-						else
-						{
-							this->k = 0;
-						}
+						this->blocks[i + 1].count -= this->blocks[i].count;
+						assert(this->blocks.getSize() - i - 2 >= 0);
+						this->blocks.erase(i, 1);
+						this->index.erase(i, 1);
+						this->index.update(this->blocks, i);
 					}
 					else
 					{
 						//subcase 2.2.4 (shelf.odt)
 						
-						this->arr[i].count = -this->arr[i].count;
-						
-						if (this->k > i)
-						{
-							this->k = i;
-						}
-						else
-						{
-							this->k = 0;
-						}
+						this->blocks[i].count = -this->blocks[i].count;
+						this->index.update(this->blocks, i);
 					}
 				}
 			}
@@ -439,59 +1311,16 @@ template <typename TPL_Shelf_T> class Shelf: public PodContainer <TPL_Shelf_T>
 	{
 		assert(n >= 0 && n < 2147483647);
 		
-		int sum = 0;
-		
-		for (int i = 0; i < this->size; i++)
-		{
-			/*
-			 * Loop invariant:
-			 * sum == |arr[0].count| + |arr[1].count| + ... + |arr[i - 1].count| <= n
-			 */
-
-			sum += (this->arr[i].isEmpty() ? -this->arr[i].count : this->arr[i].count);
-			
-			if (sum > n)
-			{
-				return this->arr[i].isEmpty() ? nullptr : &this->arr[i].element;
-			}
-		}
-		
-		assert(false);
-	}
-
-	private: int32_t getFirstEmptyBlock() const
-	{
-		assert(this->invariant());
-		assert(this->emptyCount > 0);						// => this->k < this->size
-		
-		for ( ; this->k < this->size; this->k++)
-		{
-			if (this->arr[this->k].isEmpty())
-			{
-				return this->k;
-			}
-		}
-		
-		assert(false);
+		int32_t i = this->index.findBlock(this->blocks, this->blocks.getSize(), n);
+		return this->blocks[i].isEmpty() ? nullptr : &this->blocks[i].element;
 	}
 
-	private: void ensureCapacity(int32_t minCapacity)
+	private: int32_t getFirstEmptyBlock()
 	{
 		assert(this->invariant());
-		assert(minCapacity > 0);
-		
-		if (minCapacity <= this->capacity)
-		{
-			return;
-		}
+		assert(this->emptyCount > 0);
 		
-		this->capacity = minCapacity;
-		ElementBlock *tmp = new ElementBlock[this->capacity];
-		std::memcpy(tmp, this->arr, this->size * sizeof(ElementBlock));
-		delete[] this->arr;
-		this->arr = tmp;
-		
-		assert(this->invariant());
+		return this->index.findFirstEmptyBlock(this->blocks, this->blocks.getSize());
 	}
 }
 
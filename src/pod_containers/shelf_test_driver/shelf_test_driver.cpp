@@ -11,6 +11,27 @@
 #endif
 
 
+#ifdef EUGENEJONAS__CPP_STUFF__SHELF_TREE_INDEX
+typedef eugenejonas::cpp_stuff::TreeShelfIndex ShelfIndex;
+#else
+typedef eugenejonas::cpp_stuff::LinearShelfIndex ShelfIndex;
+#endif
+
+#ifdef EUGENEJONAS__CPP_STUFF__SHELF_ELEMENT_TABLE
+typedef eugenejonas::cpp_stuff::TableShelfElementIndex <char> ShelfElementIndex;
+#else
+typedef eugenejonas::cpp_stuff::LinearShelfElementIndex ShelfElementIndex;
+#endif
+
+#ifdef EUGENEJONAS__CPP_STUFF__SHELF_CHUNKED_BLOCKS
+template <typename TPL_Block> using ShelfBlocks = eugenejonas::cpp_stuff::ChunkedShelfBlocks <TPL_Block>;
+#else
+template <typename TPL_Block> using ShelfBlocks = eugenejonas::cpp_stuff::ArrayShelfBlocks <TPL_Block>;
+#endif
+
+typedef eugenejonas::cpp_stuff::Shelf <char, ShelfIndex, ShelfElementIndex, ShelfBlocks> CharShelf;
+
+
 /**
  * Test driver for class Shelf. It uses format of test cases as given in the
  * original task from the Latvian Olympiads in Informatics. This program reads
@@ -21,6 +42,16 @@
  *
  * EUGENEJONAS__CPP_STUFF__SHELF_STREAM_IO - if defined, C++ style I/O (<fstream>) will be used.
  * If not defined, C style I/O (<cstdio> and "fscanf") will be used.
+ *
+ * EUGENEJONAS__CPP_STUFF__SHELF_TREE_INDEX - if defined, Shelf will use TreeShelfIndex.
+ * If not defined, it will use the default LinearShelfIndex.
+ *
+ * EUGENEJONAS__CPP_STUFF__SHELF_ELEMENT_TABLE - if defined, Shelf will use TableShelfElementIndex,
+ * which needs EUGENEJONAS__CPP_STUFF__SHELF_TREE_INDEX as well.
+ * If not defined, it will use the default LinearShelfElementIndex.
+ *
+ * EUGENEJONAS__CPP_STUFF__SHELF_CHUNKED_BLOCKS - if defined, Shelf will use ChunkedShelfBlocks.
+ * If not defined, it will use the default ArrayShelfBlocks.
  */
 int main(int argc, char **argv)
 {
@@ -33,7 +64,7 @@ int main(int argc, char **argv)
 	int32_t pos, count;
 	int n;
 	char c;
-	eugenejonas::cpp_stuff::Shelf <char> shelf;
+	CharShelf shelf;
 	
 	fin >> n;
 	
@@ -82,7 +113,7 @@ int main(int argc, char **argv)
 	int32_t m;
 	int n;
 	char c;
-	eugenejonas::cpp_stuff::Shelf <char> shelf;
+	CharShelf shelf;
 	
 	std::fscanf(fin, "%d\n", &n);
 	
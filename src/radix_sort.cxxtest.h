@@ -0,0 +1,165 @@
+#include <eugenejonas/cpp_stuff/radix_sort.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::string;
+using std::vector;
+
+
+class UnitTest_lsdRadixSort: public CxxTest::TestSuite
+{
+	private: typedef std::pair <std::int32_t, int> Pair;
+
+
+	private: struct FirstKey
+	{
+		public: std::int32_t operator()(Pair const &element) const
+		{
+			return element.first;
+		}
+	}
+
+	private: struct CompareFirst
+	{
+		public: bool operator()(Pair const &a, Pair const &b) const
+		{
+			return a.first < b.first;
+		}
+	}
+
+
+	public: void test_unsigned()
+	{
+		vector <std::uint32_t> v(5000);
+		std::srand(1);
+		
+		for (std::size_t i = 0; i < v.size(); i++)
+		{
+			v[i] = (std::uint32_t) std::rand() * 7919u;
+		}
+		
+		vector <std::uint32_t> expected = v;
+		std::sort(expected.begin(), expected.end());
+		lsdRadixSort(v.begin(), v.end());
+		
+		TS_ASSERT_EQUALS(expected, v);
+	}
+	
+	public: void test_signed_64()
+	{
+		std::int64_t a[] = {5, -3, 0, 1LL << 40, -(1LL << 50), 7, -1, 0};
+		vector <std::int64_t> v(a, a + sizeof(a) / sizeof(a[0])), expected = v;
+		std::sort(expected.begin(), expected.end());
+		lsdRadixSort(v.begin(), v.end());
+		
+		TS_ASSERT_EQUALS(expected, v);
+	}
+	
+	/**
+	 * long long and std::int64_t are different types on some platforms.
+	 */
+	public: void test_long_long()
+	{
+		long long a[] = {5, -3, 0, 1LL << 40, -(1LL << 50), 7, -1, 0};
+		vector <long long> v(a, a + sizeof(a) / sizeof(a[0])), expected = v;
+		std::sort(expected.begin(), expected.end());
+		lsdRadixSort(v.begin(), v.end());
+		
+		TS_ASSERT_EQUALS(expected, v);
+		
+		unsigned long long b[] = {5, 3, 0, 1ULL << 63, 1ULL << 40, 7, ~0ULL, 0};
+		vector <unsigned long long> w(b, b + sizeof(b) / sizeof(b[0])), expectedW = w;
+		std::sort(expectedW.begin(), expectedW.end());
+		lsdRadixSort(w.begin(), w.end());
+		
+		TS_ASSERT_EQUALS(expectedW, w);
+	}
+	
+	public: void test_float()
+	{
+		float a[] = {1.5f, -2.25f, 0.0f, -0.5f, 1e30f, -1e30f, 3.0f, 1.5f};
+		vector <float> v(a, a + sizeof(a) / sizeof(a[0])), expected = v;
+		std::sort(expected.begin(), expected.end());
+		lsdRadixSort(v.begin(), v.end());
+		
+		TS_ASSERT_EQUALS(expected, v);
+	}
+	
+	public: void test_stable_with_key_extractor()
+	{
+		ThreadPool pool(3);
+		vector <Pair> source(20000);
+		std::srand(2);
+		
+		for (int i = 0; i < (int) source.size(); i++)
+		{
+			source[i] = Pair(std::rand() % 1000 - 500, i);
+		}
+		
+		vector <Pair> expected = source, v = source;
+		std::stable_sort(expected.begin(), expected.end(), CompareFirst());
+		
+		lsdRadixSort(v.begin(), v.end(), FirstKey());
+		
+		TS_ASSERT_EQUALS(expected, v);
+		
+		v = source;
+		lsdRadixSort(v.begin(), v.end(), FirstKey(), pool, 1000);
+		
+		TS_ASSERT_EQUALS(expected, v);
+	}
+}
+
+class UnitTest_americanFlagSort: public CxxTest::TestSuite
+{
+	public: void test_strings()
+	{
+		vector <string> v;
+		std::srand(3);
+		
+		for (int i = 0; i < 3000; i++)
+		{
+			string s(std::rand() % 6, 'a');
+			
+			for (std::size_t j = 0; j < s.size(); j++)
+			{
+				s[j] = (char) ("ab\xff" [std::rand() % 3]);
+			}
+			
+			v.push_back(s);
+		}
+		
+		vector <string> expected = v;
+		std::sort(expected.begin(), expected.end());
+		americanFlagSort(v.begin(), v.end());
+		
+		TS_ASSERT_EQUALS(expected, v);
+	}
+	
+	public: void test_pointers_to_strings()
+	{
+		string a("abc"), b(""), c("ab"), d("abd");
+		const string *arr[] = {&a, &b, &c, &d, &a, &b};
+		const string *expected[] = {&b, &b, &c, &a, &a, &d};
+		
+		americanFlagSort(arr, arr + 6, DereferencedKey());
+		
+		TS_ASSERT(std::equal(arr, arr + 6, expected));
+	}
+}
+
+
+}
@@ -0,0 +1,622 @@
+#ifndef EUGENEJONAS__CPP_STUFF__RADIX_SORT_H
+#define EUGENEJONAS__CPP_STUFF__RADIX_SORT_H
+
+
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/*
+ * Radix sorts don't compare elements, so unlike Sorter they don't take
+ * a strict weak ordering and don't count inversions. Elements are ordered by
+ * keys, which are obtained from elements by key extractors (functors).
+ *
+ * lsdRadixSort is stable. americanFlagSort is not stable.
+ */
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Maps keys to unsigned integers of the same width whose natural order
+ * agrees with the order of the keys.
+ * Specialized for 32-bit and 64-bit integer types (int, long, long long,
+ * their unsigned counterparts and so the fixed width ones), float and double.
+ */
+template <typename TPL_RadixKeyTraits_T> struct RadixKeyTraits;
+
+/**
+ * RadixKeyTraits of integer type TPL_IntegerRadixKeyTraits_T.
+ */
+template <typename TPL_IntegerRadixKeyTraits_T> struct IntegerRadixKeyTraits
+{
+	static_assert(sizeof(TPL_IntegerRadixKeyTraits_T) == 4 || sizeof(TPL_IntegerRadixKeyTraits_T) == 8, "keys must be 32-bit or 64-bit");
+
+
+	public: typedef typename std::conditional <sizeof(TPL_IntegerRadixKeyTraits_T) == 4, std::uint32_t, std::uint64_t> ::type bits_type;
+
+
+	/**
+	 * Flipping the sign bit puts negative numbers before non-negative ones.
+	 */
+	public: static bits_type toBits(TPL_IntegerRadixKeyTraits_T key)
+	{
+		if constexpr (std::is_signed <TPL_IntegerRadixKeyTraits_T> ::value)
+		{
+			return (bits_type) key ^ ((bits_type) 1 << (8 * sizeof(bits_type) - 1));
+		}
+		else
+		{
+			return (bits_type) key;
+		}
+	}
+}
+
+template <> struct RadixKeyTraits <int>: public IntegerRadixKeyTraits <int>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <unsigned>: public IntegerRadixKeyTraits <unsigned>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <long>: public IntegerRadixKeyTraits <long>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <unsigned long>: public IntegerRadixKeyTraits <unsigned long>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <long long>: public IntegerRadixKeyTraits <long long>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <unsigned long long>: public IntegerRadixKeyTraits <unsigned long long>
+{
+	//nothing
+}
+
+template <> struct RadixKeyTraits <float>
+{
+	public: typedef std::uint32_t bits_type;
+
+
+	/**
+	 * Negative numbers have all bits flipped (their magnitude order is reversed),
+	 * non-negative numbers have the sign bit set. -0.0 goes before 0.0;
+	 * NaNs go to the ends.
+	 */
+	public: static bits_type toBits(float key)
+	{
+		bits_type bits = std::bit_cast <bits_type> (key);
+		return (bits & ((bits_type) 1 << 31)) ? ~bits : bits | ((bits_type) 1 << 31);
+	}
+}
+
+template <> struct RadixKeyTraits <double>
+{
+	public: typedef std::uint64_t bits_type;
+
+
+	public: static bits_type toBits(double key)
+	{
+		bits_type bits = std::bit_cast <bits_type> (key);
+		return (bits & ((bits_type) 1 << 63)) ? ~bits : bits | ((bits_type) 1 << 63);
+	}
+}
+
+/**
+ * Key extractor which uses elements themselves as keys.
+ */
+struct IdentityKey
+{
+	public: template <typename TPL_T> TPL_T const &operator()(TPL_T const &element) const
+	{
+		return element;
+	}
+}
+
+/**
+ * Key extractor for pointers to strings (the elements ordered by compareStrings).
+ */
+struct DereferencedKey
+{
+	public: template <typename TPL_T> TPL_T const &operator()(const TPL_T *element) const
+	{
+		return *element;
+	}
+}
+
+/**
+ * Hints the processor that the memory at address will be written soon.
+ */
+inline void prefetchForWrite(const void *address)
+{
+	#if defined(__GNUC__)
+	__builtin_prefetch(address, 1);
+	#endif
+}
+
+/**
+ * Least significant digit radix sort by 8-bit digits.
+ */
+template <typename TPL_LsdRadixSorter_Iterator, typename TPL_LsdRadixSorter_KeyExtractor> class LsdRadixSorter
+{
+	private: typedef typename std::iterator_traits <TPL_LsdRadixSorter_Iterator> ::value_type value_type;
+	private: typedef typename std::iterator_traits <TPL_LsdRadixSorter_Iterator> ::difference_type difference_type;
+	private: typedef typename std::decay <decltype(std::declval <TPL_LsdRadixSorter_KeyExtractor> ()(std::declval <value_type> ()))> ::type key_type;
+	private: typedef typename RadixKeyTraits <key_type> ::bits_type bits_type;
+
+
+	private: static const int DIGIT_COUNT = sizeof(bits_type);
+	private: static const int RADIX = 256;
+
+	/**
+	 * Elements are scattered with prefetching of the destination of the element this far ahead.
+	 */
+	private: static const difference_type PREFETCH_DISTANCE = 16;
+
+
+	private: TPL_LsdRadixSorter_KeyExtractor keyExtractor;
+
+
+	public: LsdRadixSorter(TPL_LsdRadixSorter_KeyExtractor keyExtractor = TPL_LsdRadixSorter_KeyExtractor()):
+			keyExtractor(keyExtractor)
+	{
+		//nothing
+	}
+
+	/**
+	 * Sorts range [first; last) by keys. The sort is stable.
+	 * Histograms of all digits are counted in one pass, and passes in which
+	 * all elements have the same digit are skipped.
+	 *
+	 * @time O(n * sizeof(key))
+	 * @space O(n)
+	 */
+	public: void sort(TPL_LsdRadixSorter_Iterator first, TPL_LsdRadixSorter_Iterator last) const
+	{
+		difference_type n = last - first;
+
+		if (n < 2)
+		{
+			return;
+		}
+
+		std::vector <difference_type> histograms(DIGIT_COUNT * RADIX);
+
+		for (TPL_LsdRadixSorter_Iterator it = first; it != last; ++it)
+		{
+			bits_type bits = this->getBits(*it);
+
+			for (int d = 0; d < DIGIT_COUNT; d++)
+			{
+				histograms[d * RADIX + LsdRadixSorter::getDigit(bits, d)]++;
+			}
+		}
+
+		std::vector <value_type> buffer(n);
+		bool isInBuffer = false;
+
+		for (int d = 0; d < DIGIT_COUNT; d++)
+		{
+			difference_type *offsets = &histograms[d * RADIX];
+
+			if (!LsdRadixSorter::toOffsets(offsets, n))
+			{
+				continue;
+			}
+
+			if (isInBuffer)
+			{
+				this->scatter(buffer.begin(), buffer.end(), first, offsets, d);
+			}
+			else
+			{
+				this->scatter(first, last, buffer.begin(), offsets, d);
+			}
+
+			isInBuffer = !isInBuffer;
+		}
+
+		if (isInBuffer)
+		{
+			std::move(buffer.begin(), buffer.end(), first);
+		}
+	}
+
+	/**
+	 * Parallel version of sort(). In every pass, the range is split into
+	 * blocks of grainSize elements; every task counts its own histogram, and
+	 * after the histograms are combined into offsets, scatters its block.
+	 * The sort is stable.
+	 */
+	public: void sort(TPL_LsdRadixSorter_Iterator first, TPL_LsdRadixSorter_Iterator last, ThreadPool &pool, difference_type grainSize = 1 << 16) const
+	{
+		difference_type n = last - first;
+
+		if (n <= grainSize)
+		{
+			this->sort(first, last);
+			return;
+		}
+
+		difference_type blockCount = (n + grainSize - 1) / grainSize;
+		std::vector <difference_type> histograms(blockCount * RADIX);
+		std::vector <value_type> buffer(n);
+		bool isInBuffer = false;
+
+		for (int d = 0; d < DIGIT_COUNT; d++)
+		{
+			std::fill(histograms.begin(), histograms.end(), 0);
+
+			if (isInBuffer)
+			{
+				this->sortByDigit(buffer.begin(), first, n, d, histograms, pool, grainSize);
+			}
+			else
+			{
+				this->sortByDigit(first, buffer.begin(), n, d, histograms, pool, grainSize);
+			}
+
+			isInBuffer = !isInBuffer;
+		}
+
+		if (isInBuffer)
+		{
+			std::move(buffer.begin(), buffer.end(), first);
+		}
+	}
+
+	private: template <typename TPL_Source, typename TPL_Destination> void sortByDigit(
+			TPL_Source src,
+			TPL_Destination dst,
+			difference_type n,
+			int d,
+			std::vector <difference_type> &histograms,
+			ThreadPool &pool,
+			difference_type grainSize
+	) const
+	{
+		difference_type blockCount = histograms.size() / RADIX;
+
+		{
+			TaskGroup group(pool);
+
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				group.run([this, src, n, d, &histograms, grainSize, block]()
+				{
+					difference_type *histogram = &histograms[block * RADIX];
+
+					for (difference_type i = block * grainSize; i < std::min(n, (block + 1) * grainSize); i++)
+					{
+						histogram[LsdRadixSorter::getDigit(this->getBits(src[i]), d)]++;
+					}
+				});
+			}
+
+			group.wait();
+		}
+
+		// digit-major, block-minor order keeps the sort stable
+
+		difference_type sum = 0;
+
+		for (int digit = 0; digit < RADIX; digit++)
+		{
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				difference_type count = histograms[block * RADIX + digit];
+				histograms[block * RADIX + digit] = sum;
+				sum += count;
+			}
+		}
+
+		{
+			TaskGroup group(pool);
+
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				group.run([this, src, dst, n, d, &histograms, grainSize, block]()
+				{
+					difference_type first = block * grainSize, last = std::min(n, (block + 1) * grainSize);
+					this->scatter(src + first, src + last, dst, &histograms[block * RADIX], d);
+				});
+			}
+
+			group.wait();
+		}
+	}
+
+	/**
+	 * Moves elements of [first; last) to dst + offsets[digit], incrementing the offsets.
+	 */
+	private: template <typename TPL_Source, typename TPL_Destination> void scatter(
+			TPL_Source first,
+			TPL_Source last,
+			TPL_Destination dst,
+			difference_type *offsets,
+			int d
+	) const
+	{
+		difference_type n = last - first;
+
+		for (difference_type i = 0; i < n; i++)
+		{
+			if (i + PREFETCH_DISTANCE < n)
+			{
+				int ahead = LsdRadixSorter::getDigit(this->getBits(first[i + PREFETCH_DISTANCE]), d);
+				prefetchForWrite(&dst[offsets[ahead]]);
+			}
+
+			int digit = LsdRadixSorter::getDigit(this->getBits(first[i]), d);
+			dst[offsets[digit]++] = std::move(first[i]);
+		}
+	}
+
+	/**
+	 * Converts histogram of n elements to starting offsets.
+	 *
+	 * @return false if all elements have the same digit (the pass can be skipped).
+	 */
+	private: static bool toOffsets(difference_type *histogram, difference_type n)
+	{
+		difference_type sum = 0;
+
+		for (int digit = 0; digit < RADIX; digit++)
+		{
+			if (histogram[digit] == n)
+			{
+				return false;
+			}
+
+			difference_type count = histogram[digit];
+			histogram[digit] = sum;
+			sum += count;
+		}
+
+		return true;
+	}
+
+	private: bits_type getBits(value_type const &element) const
+	{
+		return RadixKeyTraits <key_type> ::toBits(this->keyExtractor(element));
+	}
+
+	private: static int getDigit(bits_type bits, int d)
+	{
+		return (int) ((bits >> (8 * d)) & (RADIX - 1));
+	}
+}
+
+/**
+ * Sorts range [first; last) by keys obtained with keyExtractor, using
+ * LSD radix sort. Keys must be of type for which RadixKeyTraits is specialized.
+ * The sort is stable.
+ *
+ * @time O(n * sizeof(key))
+ * @space O(n)
+ */
+template <typename TPL_RandomAccessIterator, typename TPL_KeyExtractor> void lsdRadixSort(
+		TPL_RandomAccessIterator first,
+		TPL_RandomAccessIterator last,
+		TPL_KeyExtractor keyExtractor
+)
+{
+	LsdRadixSorter <TPL_RandomAccessIterator, TPL_KeyExtractor> (keyExtractor).sort(first, last);
+}
+
+template <typename TPL_RandomAccessIterator> void lsdRadixSort(TPL_RandomAccessIterator first, TPL_RandomAccessIterator last)
+{
+	lsdRadixSort(first, last, IdentityKey());
+}
+
+/**
+ * Parallel LSD radix sort. The sort is stable.
+ *
+ * @param grainSize Number of elements per task.
+ */
+template <typename TPL_RandomAccessIterator, typename TPL_KeyExtractor> void lsdRadixSort(
+		TPL_RandomAccessIterator first,
+		TPL_RandomAccessIterator last,
+		TPL_KeyExtractor keyExtractor,
+		ThreadPool &pool,
+		typename std::iterator_traits <TPL_RandomAccessIterator> ::difference_type grainSize = 1 << 16
+)
+{
+	LsdRadixSorter <TPL_RandomAccessIterator, TPL_KeyExtractor> (keyExtractor).sort(first, last, pool, grainSize);
+}
+
+/**
+ * Most significant digit radix sort of elements with string keys
+ * (American flag sort). Elements are partitioned by the byte at the current
+ * depth in place, by cyclic permutation of the elements into their buckets,
+ * then the buckets are processed at the next depth. Strings are compared as
+ * sequences of unsigned chars, like std::string::compare with the default
+ * char traits does; a string which ends goes before all its extensions.
+ *
+ * The sort is not stable.
+ */
+template <typename TPL_AmericanFlagSorter_Iterator, typename TPL_AmericanFlagSorter_KeyExtractor> class AmericanFlagSorter
+{
+	private: typedef typename std::iterator_traits <TPL_AmericanFlagSorter_Iterator> ::difference_type difference_type;
+
+
+	/**
+	 * Bucket 0 is for strings which are shorter than the depth + 1.
+	 */
+	private: static const int BUCKET_COUNT = 257;
+
+	/**
+	 * Ranges not longer than this are sorted by insertion sort.
+	 */
+	private: static const difference_type INSERTION_SORT_THRESHOLD = 32;
+
+
+	/**
+	 * Range of elements whose keys have the same first <depth> bytes.
+	 */
+	private: struct Task
+	{
+		public: TPL_AmericanFlagSorter_Iterator first, last;
+		public: std::size_t depth;
+	}
+
+
+	private: TPL_AmericanFlagSorter_KeyExtractor keyExtractor;
+
+
+	public: AmericanFlagSorter(TPL_AmericanFlagSorter_KeyExtractor keyExtractor = TPL_AmericanFlagSorter_KeyExtractor()):
+			keyExtractor(keyExtractor)
+	{
+		//nothing
+	}
+
+	/**
+	 * @time O(n * k) where k is the average length of distinguishing prefixes
+	 * @space O(1) in addition to the work list of pending ranges
+	 */
+	public: void sort(TPL_AmericanFlagSorter_Iterator first, TPL_AmericanFlagSorter_Iterator last) const
+	{
+		// explicit work list instead of recursion, since depth can be as large as the length of the keys
+		std::vector <Task> tasks;
+		tasks.push_back(Task{first, last, 0});
+
+		difference_type counts[BUCKET_COUNT];
+		TPL_AmericanFlagSorter_Iterator heads[BUCKET_COUNT], tails[BUCKET_COUNT];
+
+		while (!tasks.empty())
+		{
+			Task task = tasks.back();
+			tasks.pop_back();
+
+			if (task.last - task.first <= INSERTION_SORT_THRESHOLD)
+			{
+				this->insertionSort(task.first, task.last, task.depth);
+				continue;
+			}
+
+			std::fill(counts, counts + BUCKET_COUNT, 0);
+
+			for (TPL_AmericanFlagSorter_Iterator it = task.first; it != task.last; ++it)
+			{
+				counts[this->getBucket(*it, task.depth)]++;
+			}
+
+			TPL_AmericanFlagSorter_Iterator it = task.first;
+
+			for (int b = 0; b < BUCKET_COUNT; b++)
+			{
+				heads[b] = it;
+				it += counts[b];
+				tails[b] = it;
+			}
+
+			// permute in place: take the first misplaced element of every bucket
+			// and swap it into its bucket until the bucket is complete
+
+			for (int b = 0; b < BUCKET_COUNT; b++)
+			{
+				while (heads[b] != tails[b])
+				{
+					int target = this->getBucket(*heads[b], task.depth);
+
+					if (target == b)
+					{
+						++heads[b];
+					}
+					else
+					{
+						std::iter_swap(heads[b], heads[target]++);
+					}
+				}
+			}
+
+			// keys in bucket 0 are equal; the other buckets continue at the next byte
+
+			it = task.first + counts[0];
+
+			for (int b = 1; b < BUCKET_COUNT; b++)
+			{
+				if (counts[b] > 1)
+				{
+					tasks.push_back(Task{it, it + counts[b], task.depth + 1});
+				}
+
+				it += counts[b];
+			}
+		}
+	}
+
+	private: void insertionSort(TPL_AmericanFlagSorter_Iterator first, TPL_AmericanFlagSorter_Iterator last, std::size_t depth) const
+	{
+		for (TPL_AmericanFlagSorter_Iterator it = first; it != last; ++it)
+		{
+			for (TPL_AmericanFlagSorter_Iterator hole = it; hole != first && this->isLess(*hole, *(hole - 1), depth); --hole)
+			{
+				std::iter_swap(hole, hole - 1);
+			}
+		}
+	}
+
+	/**
+	 * Compares keys, knowing that their first <depth> bytes are equal.
+	 */
+	private: template <typename TPL_T> bool isLess(TPL_T const &a, TPL_T const &b, std::size_t depth) const
+	{
+		std::string const &keyA = this->keyExtractor(a);
+		std::string const &keyB = this->keyExtractor(b);
+
+		return keyA.compare(depth, std::string::npos, keyB, depth, std::string::npos) < 0;
+	}
+
+	private: template <typename TPL_T> int getBucket(TPL_T const &element, std::size_t depth) const
+	{
+		std::string const &key = this->keyExtractor(element);
+		return depth < key.size() ? 1 + (unsigned char) key[depth] : 0;
+	}
+}
+
+/**
+ * Sorts range [first; last) by string keys obtained with keyExtractor
+ * (a functor returning std::string const &), using American flag sort.
+ * The sort is not stable.
+ */
+template <typename TPL_RandomAccessIterator, typename TPL_KeyExtractor> void americanFlagSort(
+		TPL_RandomAccessIterator first,
+		TPL_RandomAccessIterator last,
+		TPL_KeyExtractor keyExtractor
+)
+{
+	AmericanFlagSorter <TPL_RandomAccessIterator, TPL_KeyExtractor> (keyExtractor).sort(first, last);
+}
+
+template <typename TPL_RandomAccessIterator> void americanFlagSort(TPL_RandomAccessIterator first, TPL_RandomAccessIterator last)
+{
+	americanFlagSort(first, last, IdentityKey());
+}
+
+
+}
+
+
+#endif
@@ -1,11 +1,17 @@
 
 #include <eugenejonas/cpp_stuff/orderings.h>
 #include <eugenejonas/cpp_stuff/sort.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <functional>
 #include <iterator>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
 #include <concepts>
@@ -68,6 +74,10 @@ template <typename TPL_SortTestUtils_Iterator, typename TPL_SortTestUtils_Strict
 		sorter->mergeSort();
 		TS_ASSERT(isStableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare));
 
+		std::copy(sourceFirst, sourceLast, sortedFirst);
+		sorter->powerSort();
+		TS_ASSERT(isStableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare));
+
 		std::copy(sourceFirst, sourceLast, sortedFirst);
 		sorter->quickSort();
 		TS_ASSERT(isStableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare));
@@ -114,10 +124,26 @@ template <typename TPL_SortTestUtils_Iterator, typename TPL_SortTestUtils_Strict
 		sorter->mergeSort();
 		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
 
+		std::copy(sourceFirst, sourceLast, sortedFirst);
+		sorter->powerSort();
+		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
+
 		std::copy(sourceFirst, sourceLast, sortedFirst);
 		sorter->quickSort();
 		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
 
+		std::copy(sourceFirst, sourceLast, sortedFirst);
+		sorter->introSort();
+		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
+
+		std::copy(sourceFirst, sourceLast, sortedFirst);
+		sorter->networkSort();
+		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
+
+		std::copy(sourceFirst, sourceLast, sortedFirst);
+		sorter->pdqSort();
+		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
+
 		std::copy(sourceFirst, sourceLast, sortedFirst);
 		sorter->selectionSort();
 		TS_ASSERT(isUnstableSorted(sortedFirst, sortedLast, sourceFirst, sourceLast, swoCompare, stoCompare));
@@ -474,5 +500,617 @@ class UnitTest_Sorter_with_strings_and_pointers_to_strings: public CxxTest::Test
 	}
 }
 
+/**
+ * Inputs which are long enough to exercise partitioning, including
+ * inputs which are bad for naive quick sort.
+ */
+class UnitTest_Sorter_with_long_inputs: public CxxTest::TestSuite
+{
+	private: static const int N = 20000;
+
+
+	private: static void checkIntroSort(std::vector <int> const &source)
+	{
+		std::vector <int> expected = source, sorted = source;
+		std::sort(expected.begin(), expected.end());
+		
+		Sorter <std::vector <int> ::iterator, std::less <int> > (sorted.begin(), sorted.end()).introSort();
+		TS_ASSERT_EQUALS(expected, sorted);
+		
+		sorted = source;
+		Sorter <std::vector <int> ::iterator, std::less <int> > (sorted.begin(), sorted.end()).pdqSort();
+		TS_ASSERT_EQUALS(expected, sorted);
+	}
+	
+	public: void test_random()
+	{
+		std::vector <int> v(N);
+		std::srand(1);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = std::rand();
+		}
+		
+		checkIntroSort(v);
+	}
+	
+	public: void test_few_unique()
+	{
+		std::vector <int> v(N);
+		std::srand(2);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = std::rand() % 4;
+		}
+		
+		checkIntroSort(v);
+		checkIntroSort(std::vector <int> (N, 7));
+	}
+	
+	public: void test_sorted_and_reversed()
+	{
+		std::vector <int> v(N);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = i;
+		}
+		
+		checkIntroSort(v);
+		
+		std::reverse(v.begin(), v.end());
+		checkIntroSort(v);
+	}
+	
+	public: void test_organ_pipe()
+	{
+		std::vector <int> v(N);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = std::min(i, N - i);
+		}
+		
+		checkIntroSort(v);
+	}	
+	public: void test_nearly_sorted()
+	{
+		std::vector <int> v(N);
+		std::srand(4);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = i;
+		}
+		
+		for (int k = 0; k < 10; k++)
+		{
+			std::swap(v[std::rand() % N], v[std::rand() % N]);
+		}
+		
+		checkIntroSort(v);
+		
+		std::reverse(v.begin(), v.end());
+		checkIntroSort(v);
+	}
+	
+	public: void test_pdqSort_with_strings()
+	{
+		std::vector <string> source(N);
+		std::srand(5);
+		
+		for (int i = 0; i < N; i++)
+		{
+			source[i] = std::to_string(std::rand() % 1000);
+		}
+		
+		std::vector <string> expected = source;
+		std::sort(expected.begin(), expected.end());
+		
+		Sorter <std::vector <string> ::iterator, std::less <string> > (source.begin(), source.end()).pdqSort();
+		
+		TS_ASSERT_EQUALS(expected, source);
+	}
+	
+	/**
+	 * Sorts pairs by the first component only, so that stability can be checked.
+	 */
+	public: void test_mergeSort_is_stable_and_counts_inversions()
+	{
+		typedef std::pair <int, int> Pair;
+		
+		struct CompareFirst
+		{
+			public: bool operator()(Pair const &a, Pair const &b) const
+			{
+				return a.first < b.first;
+			}
+		}
+		
+		std::vector <Pair> source(3000), sorted;
+		std::srand(3);
+		
+		for (int i = 0; i < (int) source.size(); i++)
+		{
+			source[i] = Pair(std::rand() % 100, i);
+		}
+		
+		long long expectedCount = 0;
+		
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+			for (std::size_t j = i + 1; j < source.size(); j++)
+			{
+				if (source[j].first < source[i].first)
+				{
+					expectedCount++;
+				}
+			}
+		}
+		
+		sorted = source;
+		long long count = Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).mergeSort();
+		
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT(isStableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst()));
+		
+		std::vector <Pair> buffer(source.size());
+		sorted = source;
+		count = Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).mergeSort(buffer.data());
+		
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT(isStableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst()));
+		
+		sorted = source;
+		count = Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).powerSort();
+		
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT(isStableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst()));
+	}
+	
+	/**
+	 * Input made of ascending and descending runs of random lengths, with
+	 * equal elements within and across the runs.
+	 */
+	public: void test_powerSort_with_natural_runs()
+	{
+		typedef std::pair <int, int> Pair;
+		
+		struct CompareFirst
+		{
+			public: bool operator()(Pair const &a, Pair const &b) const
+			{
+				return a.first < b.first;
+			}
+		}
+		
+		std::vector <Pair> source;
+		std::srand(6);
+		
+		while (source.size() < 5000)
+		{
+			int length = 1 + std::rand() % (std::rand() % 2 == 0 ? 10 : 1000);
+			int value = std::rand() % 500;
+			bool isDescending = std::rand() % 3 == 0;
+			
+			for (int k = 0; k < length; k++)
+			{
+				source.push_back(Pair(value, (int) source.size()));
+				value += (isDescending ? -1 : 1) * (std::rand() % 3);
+			}
+		}
+		
+		long long expectedCount = 0;
+		
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+			for (std::size_t j = i + 1; j < source.size(); j++)
+			{
+				if (source[j].first < source[i].first)
+				{
+					expectedCount++;
+				}
+			}
+		}
+		
+		std::vector <Pair> sorted = source;
+		long long count = Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).powerSort();
+		
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT(isStableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst()));
+		
+		// sorted and reversed inputs are single runs
+		
+		std::vector <int> v(N);
+		
+		for (int i = 0; i < N; i++)
+		{
+			v[i] = N - i;
+		}
+		
+		TS_ASSERT_EQUALS((long long) N * (N - 1) / 2, (Sorter <std::vector <int> ::iterator, std::less <int> > (v.begin(), v.end()).powerSort()));
+		TS_ASSERT(std::is_sorted(v.begin(), v.end()));
+		TS_ASSERT_EQUALS(0, (Sorter <std::vector <int> ::iterator, std::less <int> > (v.begin(), v.end()).powerSort()));
+	}
+}
+
+class UnitTest_Sorter_parallel: public CxxTest::TestSuite
+{
+	private: typedef std::pair <int, int> Pair;
+
+
+	private: struct CompareFirst
+	{
+		public: bool operator()(Pair const &a, Pair const &b) const
+		{
+			return a.first < b.first;
+		}
+	}
+
+
+	private: static std::vector <Pair> createInput(int n, int maxKey)
+	{
+		std::vector <Pair> res(n);
+		std::srand(n);
+		
+		for (int i = 0; i < n; i++)
+		{
+			res[i] = Pair(std::rand() % maxKey, i);
+		}
+		
+		return res;
+	}
+	
+	public: void test_parallelMergeSort_is_stable()
+	{
+		ThreadPool pool(4);
+		
+		for (int n = 0; n < 5000; n = n * 3 + 7)
+		{
+			std::vector <Pair> source = createInput(n, 50), sorted = source;
+			Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).parallelMergeSort(pool, 32);
+			
+			TS_ASSERT(isStableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst()));
+		}
+	}
+	
+	public: void test_parallelSampleSort()
+	{
+		ThreadPool pool(4);
+		
+		for (int n = 0; n < 50000; n = n * 3 + 7)
+		{
+			std::vector <Pair> source = createInput(n, n / 3 + 1), sorted = source;
+			Sorter <std::vector <Pair> ::iterator, CompareFirst> (sorted.begin(), sorted.end()).parallelSampleSort(pool, 200);
+			
+			TS_ASSERT(isUnstableSorted(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareFirst(), std::less <Pair> ()));
+		}
+	}
+	
+	public: void test_parallelSampleSort_with_equal_elements()
+	{
+		ThreadPool pool(4);
+		std::vector <int> v(30000, 5);
+		v[100] = 3;
+		v[20000] = 8;
+		
+		Sorter <std::vector <int> ::iterator, std::less <int> > (v.begin(), v.end()).parallelSampleSort(pool, 1000);
+		
+		TS_ASSERT_EQUALS(3, v.front());
+		TS_ASSERT_EQUALS(8, v.back());
+		TS_ASSERT(isSorted(v.begin(), v.end(), std::less <int> ()));
+	}
+}
+
+class UnitTest_Sorter_selection: public CxxTest::TestSuite
+{
+	private: typedef Sorter <std::vector <int> ::iterator, std::less <int> > IntSorter;
+
+
+	private: static std::vector <int> createInput(int n, int valueCount)
+	{
+		std::vector <int> res(n);
+		
+		for (int i = 0; i < n; i++)
+		{
+			res[i] = std::rand() % valueCount;
+		}
+		
+		return res;
+	}
+	
+	public: void test_nthElement()
+	{
+		std::srand(1);
+		
+		for (int n : {1, 2, 17, 100, 1000})
+		{
+			for (int valueCount : {3, 1000000})
+			{
+				std::vector <int> source = createInput(n, valueCount), sorted = source;
+				std::sort(sorted.begin(), sorted.end());
+				
+				for (int k = 0; k < n; k += 1 + n / 20)
+				{
+					std::vector <int> v = source;
+					IntSorter(v.begin(), v.end()).nthElement(k);
+					
+					TS_ASSERT_EQUALS(sorted[k], v[k]);
+					TS_ASSERT(*std::max_element(v.begin(), v.begin() + k + 1) == v[k]);
+					TS_ASSERT(*std::min_element(v.begin() + k, v.end()) == v[k]);
+				}
+			}
+		}
+	}
+	
+	/**
+	 * Counts comparisons in a counter shared by all copies.
+	 */
+	private: struct CountingLess
+	{
+		public: long long *count;
+
+
+		public: bool operator()(int a, int b) const
+		{
+			(*this->count)++;
+			return a < b;
+		}
+	}
+
+	/**
+	 * The number of comparisons is linear also for inputs with structure.
+	 */
+	public: void test_nthElement_is_linear()
+	{
+		const int n = 100000;
+		std::vector <std::vector <int> > inputs(4, std::vector <int> (n));
+		
+		for (int i = 0; i < n; i++)
+		{
+			inputs[0][i] = i;
+			inputs[1][i] = n - i;
+			inputs[2][i] = std::min(i, n - i);
+			inputs[3][i] = i % 2 == 0 ? i : n + i;
+		}
+		
+		for (std::vector <int> const &input : inputs)
+		{
+			for (int k : {0, n / 3, n / 2, n - 1})
+			{
+				std::vector <int> v = input, sorted = input;
+				std::sort(sorted.begin(), sorted.end());
+				long long count = 0;
+				
+				Sorter <std::vector <int> ::iterator, CountingLess> (v.begin(), v.end(), CountingLess{&count}).nthElement(k);
+				
+				TS_ASSERT_EQUALS(sorted[k], v[k]);
+				TS_ASSERT_LESS_THAN(count, 40LL * n);
+			}
+		}
+	}
+	
+	public: void test_partialSort()
+	{
+		std::srand(2);
+		std::vector <int> source = createInput(5000, 700), sorted = source;
+		std::sort(sorted.begin(), sorted.end());
+		
+		for (int k : {0, 1, 10, 4999, 5000})
+		{
+			std::vector <int> v = source;
+			IntSorter(v.begin(), v.end()).partialSort(k);
+			
+			TS_ASSERT(std::equal(v.begin(), v.begin() + k, sorted.begin()));
+			
+			std::sort(v.begin(), v.end());
+			TS_ASSERT_EQUALS(sorted, v);
+		}
+	}
+	
+	/**
+	 * topK() reads an input stream only once.
+	 */
+	public: void test_topK()
+	{
+		std::srand(3);
+		std::vector <int> source = createInput(3000, 100000), sorted = source;
+		std::sort(sorted.begin(), sorted.end());
+		
+		std::ostringstream out;
+		std::copy(source.begin(), source.end(), std::ostream_iterator <int> (out, " "));
+		
+		std::istringstream in(out.str());
+		std::vector <int> top = topK(std::istream_iterator <int> (in), std::istream_iterator <int> (), 25, std::less <int> ());
+		
+		TS_ASSERT_EQUALS(std::vector <int> (sorted.begin(), sorted.begin() + 25), top);
+		TS_ASSERT_EQUALS(source.size(), topK(source.begin(), source.end(), 5000, std::less <int> ()).size());
+		TS_ASSERT(topK(source.begin(), source.end(), 0, std::less <int> ()).empty());
+		
+		top = topK(source.begin(), source.end(), 10, std::greater <int> ());
+		TS_ASSERT_EQUALS(std::vector <int> (sorted.rbegin(), sorted.rbegin() + 10), top);
+	}
+	
+	public: void test_parallelTopK()
+	{
+		ThreadPool pool(4);
+		std::srand(4);
+		std::vector <int> source = createInput(50000, 1000), sorted = source;
+		std::sort(sorted.begin(), sorted.end());
+		
+		for (std::size_t k : {0, 1, 100, 3000})
+		{
+			std::vector <int> top = parallelTopK(source.begin(), source.end(), k, std::less <int> (), pool, 1000);
+			TS_ASSERT_EQUALS(std::vector <int> (sorted.begin(), sorted.begin() + k), top);
+		}
+	}
+}
+
+class UnitTest_isXSorted_by_fingerprint_and_tags: public CxxTest::TestSuite
+{
+	/**
+	 * Compares the last decimal digits only, so that many elements are equivalent.
+	 */
+	private: struct CompareLastDigit
+	{
+		public: bool operator()(int a, int b) const
+		{
+			return a % 10 < b % 10;
+		}
+	}
+
+
+	/**
+	 * Same as CompareLastDigit, but with a non-const call operator.
+	 */
+	private: struct MutableCompareLastDigit
+	{
+		public: bool operator()(int a, int b)
+		{
+			return a % 10 < b % 10;
+		}
+	}
+
+
+	private: typedef TaggedElement <int> Tagged;
+	private: typedef TaggedElementOrdering <CompareLastDigit> CompareTaggedLastDigit;
+	private: typedef TaggedElementOrdering <MutableCompareLastDigit> MutableCompareTaggedLastDigit;
+
+
+	private: static std::vector <int> createInput(std::size_t n)
+	{
+		std::vector <int> res(n);
+		std::srand(7);
+		
+		for (std::size_t i = 0; i < n; i++)
+		{
+			res[i] = std::rand() % 1000;
+		}
+		
+		return res;
+	}
+
+	public: void test_isUnstableSortedByFingerprint()
+	{
+		ThreadPool pool(3);
+		std::vector <int> source = createInput(10000), sorted = source;
+		std::sort(sorted.begin(), sorted.end());
+		
+		TS_ASSERT(isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> ()));
+		TS_ASSERT(isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> (), pool, 1000));
+		TS_ASSERT(isUnstableSortedByFingerprint(sorted.begin(), sorted.begin(), source.begin(), source.begin(), std::less <int> (), pool));
+		
+		// an element replaced by its smaller neighbour keeps the order
+		std::size_t i = std::upper_bound(sorted.begin(), sorted.end(), sorted[5000]) - sorted.begin();
+		sorted[i] = sorted[i - 1];
+		
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> ()));
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> (), pool, 1000));
+		
+		// swapped different elements at a block boundary
+		sorted = source;
+		std::sort(sorted.begin(), sorted.end());
+		i = std::upper_bound(sorted.begin(), sorted.end(), sorted[999]) - sorted.begin();
+		std::swap(sorted[i - 1], sorted[i]);
+		
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> ()));
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end(), source.begin(), source.end(), std::less <int> (), pool, i));
+		
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end() - 1, source.begin(), source.end(), std::less <int> ()));
+		TS_ASSERT_EQUALS(false, isUnstableSortedByFingerprint(sorted.begin(), sorted.end() - 1, source.begin(), source.end(), std::less <int> (), pool));
+	}
+
+	public: void test_MultisetFingerprint_of_parts()
+	{
+		std::vector <int> v = createInput(100);
+		MultisetFingerprint <int> whole(v.begin(), v.end()), part(v.begin() + 60, v.end());
+		
+		part.add(MultisetFingerprint <int> (v.begin(), v.begin() + 60));
+		
+		TS_ASSERT_EQUALS(whole, part);
+		TS_ASSERT_EQUALS(100u, part.getSize());
+		TS_ASSERT(whole.getValue() < MultisetFingerprint <int> ::MODULUS);
+		
+		// same sum of elements, different multiset
+		MultisetFingerprint <int> a, b;
+		a.add(1);
+		a.add(4);
+		b.add(2);
+		b.add(3);
+		
+		TS_ASSERT_DIFFERS(a, b);
+	}
+
+	public: void test_isStableSortedByTags()
+	{
+		ThreadPool pool(3);
+		std::vector <int> source = createInput(10000);
+		std::vector <Tagged> sorted = tagElements(source.begin(), source.end());
+		
+		Sorter <std::vector <Tagged> ::iterator, CompareTaggedLastDigit> (sorted.begin(), sorted.end()).mergeSort();
+		
+		TS_ASSERT(isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT(isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareLastDigit(), pool, 1000));
+		
+		// the unstable sorts are detected
+		sorted = tagElements(source.begin(), source.end());
+		Sorter <std::vector <Tagged> ::iterator, CompareTaggedLastDigit> (sorted.begin(), sorted.end()).pdqSort();
+		
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), CompareLastDigit(), pool, 1000));
+	}
+
+	public: void test_isStableSortedByTags_with_non_const_ordering()
+	{
+		ThreadPool pool(3);
+		std::vector <int> source = createInput(1000);
+		std::vector <Tagged> sorted = tagElements(source.begin(), source.end());
+		
+		std::stable_sort(sorted.begin(), sorted.end(), MutableCompareTaggedLastDigit());
+		
+		TS_ASSERT(isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), MutableCompareLastDigit()));
+		TS_ASSERT(isStableSortedByTags(sorted.begin(), sorted.end(), source.begin(), source.end(), MutableCompareLastDigit(), pool, 100));
+	}
+
+	public: void test_isStableSortedByTags_detects_wrong_elements()
+	{
+		ThreadPool pool(2);
+		std::vector <int> source = createInput(1000);
+		std::vector <Tagged> sorted = tagElements(source.begin(), source.end());
+		
+		std::stable_sort(sorted.begin(), sorted.end(), CompareTaggedLastDigit());
+		
+		// wrong value with a right tag
+		std::vector <Tagged> wrong = sorted;
+		wrong[500].value += 10;
+		
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit(), pool, 100));
+		
+		// duplicated element with its tag
+		wrong = sorted;
+		wrong[501] = wrong[500];
+		
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit(), pool, 100));
+		
+		// tag out of range
+		wrong = sorted;
+		wrong[0].index = source.size();
+		
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit(), pool, 100));
+		
+		// unsorted
+		wrong = sorted;
+		std::swap(wrong.front(), wrong.back());
+		
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit()));
+		TS_ASSERT_EQUALS(false, isStableSortedByTags(wrong.begin(), wrong.end(), source.begin(), source.end(), CompareLastDigit(), pool, 100));
+	}
+}
+
 
 }
@@ -4,12 +4,21 @@
 
 
 #include <eugenejonas/cpp_stuff/orderings.h>
+#include <eugenejonas/cpp_stuff/sorting_network.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <random>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef EUGENEJONAS__CPP_STUFF__CONCEPT_CPP
@@ -158,6 +167,387 @@ template <typename TPL_InputIterator1, typename TPL_InputIterator2, typename TPL
 	return res;
 }
 
+/**
+ * Order-independent fingerprint of a multiset: sum of mixed hashes of the
+ * elements modulo the Mersenne prime 2^61 - 1, and number of elements.
+ * Equal multisets have equal fingerprints; different multisets have equal
+ * fingerprints with probability about 2^-61 (for a good hash, unless the
+ * input is chosen against the hash). Fingerprints of parts of a multiset
+ * can be computed separately and added.
+ *
+ * @param TPL_MultisetFingerprint_Hash Must give equal hashes for elements
+ *		which are equal; e.g. std::hash.
+ */
+template <typename TPL_MultisetFingerprint_T, class TPL_MultisetFingerprint_Hash = std::hash <TPL_MultisetFingerprint_T> > class MultisetFingerprint
+{
+	public: static const std::uint64_t MODULUS = (1ull << 61) - 1;
+
+
+	private: TPL_MultisetFingerprint_Hash hash;
+	private: std::uint64_t sum;
+	private: std::size_t size;
+
+
+	public: MultisetFingerprint(TPL_MultisetFingerprint_Hash hash = TPL_MultisetFingerprint_Hash()):
+			hash(hash),
+			sum(0),
+			size(0)
+	{
+		//nothing
+	}
+
+	/**
+	 * Creates fingerprint of elements [first; last).
+	 */
+	public: template <typename TPL_InputIterator> MultisetFingerprint(
+			TPL_InputIterator first,
+			TPL_InputIterator last,
+			TPL_MultisetFingerprint_Hash hash = TPL_MultisetFingerprint_Hash()
+	):
+			MultisetFingerprint(hash)
+	{
+		for ( ; first != last; ++first)
+		{
+			this->add(*first);
+		}
+	}
+
+	public: void add(TPL_MultisetFingerprint_T const &element)
+	{
+		std::uint64_t h = (std::uint64_t) this->hash(element);
+		
+		// splitmix64 finalizer, so that structured hashes (e.g. identity of integers) don't cancel out
+		h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+		h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+		h ^= h >> 31;
+		
+		this->sum = MultisetFingerprint::reduce(this->sum + MultisetFingerprint::reduce(h));
+		this->size++;
+	}
+
+	/**
+	 * Adds all elements of another multiset.
+	 */
+	public: void add(MultisetFingerprint const &other)
+	{
+		this->sum = MultisetFingerprint::reduce(this->sum + other.sum);
+		this->size += other.size;
+	}
+
+	public: std::uint64_t getValue() const
+	{
+		return this->sum;
+	}
+
+	public: std::size_t getSize() const
+	{
+		return this->size;
+	}
+
+	public: bool operator==(MultisetFingerprint const &other) const
+	{
+		return this->sum == other.sum && this->size == other.size;
+	}
+
+	public: bool operator!=(MultisetFingerprint const &other) const
+	{
+		return !(*this == other);
+	}
+
+	/**
+	 * Returns x mod (2^61 - 1), for x < 2^64.
+	 */
+	private: static std::uint64_t reduce(std::uint64_t x)
+	{
+		x = (x & MultisetFingerprint::MODULUS) + (x >> 61);
+		return x >= MultisetFingerprint::MODULUS ? x - MultisetFingerprint::MODULUS : x;
+	}
+}
+
+/**
+ * Fast probabilistic version of isUnstableSorted(): compares multisets of
+ * the ranges by MultisetFingerprint instead of building std::multisets.
+ * A false positive has probability about 2^-61.
+ *
+ * @time O(n)
+ * @space O(1)
+ */
+template <typename TPL_ForwardIterator1, typename TPL_InputIterator2, typename TPL_StrictWeakOrdering, class TPL_Hash = std::hash <typename iterator_traits <TPL_ForwardIterator1> ::value_type> >
+bool isUnstableSortedByFingerprint(
+		TPL_ForwardIterator1 first,
+		TPL_ForwardIterator1 last,
+		TPL_InputIterator2 sourceFirst,
+		TPL_InputIterator2 sourceLast,
+		TPL_StrictWeakOrdering swoCompare,
+		TPL_Hash hash = TPL_Hash()
+)
+{
+	typedef typename iterator_traits <TPL_ForwardIterator1> ::value_type value_type;
+
+
+	BOOST_CONCEPT_ASSERT((boost::ForwardIterator <TPL_ForwardIterator1>));
+	BOOST_CONCEPT_ASSERT((boost::InputIterator <TPL_InputIterator2>));
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_StrictWeakOrdering, value_type>));
+
+
+	MultisetFingerprint <value_type, TPL_Hash> sorted(first, last, hash), source(sourceFirst, sourceLast, hash);
+	return sorted == source && isSorted(first, last, swoCompare);
+}
+
+/**
+ * Parallel version of isUnstableSortedByFingerprint(). Blocks of grainSize
+ * elements of both ranges are fingerprinted and scanned by tasks of the pool.
+ */
+template <typename TPL_Iterator1, typename TPL_Iterator2, typename TPL_StrictWeakOrdering, class TPL_Hash = std::hash <typename iterator_traits <TPL_Iterator1> ::value_type> >
+bool isUnstableSortedByFingerprint(
+		TPL_Iterator1 first,
+		TPL_Iterator1 last,
+		TPL_Iterator2 sourceFirst,
+		TPL_Iterator2 sourceLast,
+		TPL_StrictWeakOrdering swoCompare,
+		ThreadPool &pool,
+		std::size_t grainSize = 1 << 16,
+		TPL_Hash hash = TPL_Hash()
+)
+{
+	typedef typename iterator_traits <TPL_Iterator1> ::value_type value_type;
+	typedef MultisetFingerprint <value_type, TPL_Hash> Fingerprint;
+
+
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator1>));
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator2>));
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_StrictWeakOrdering, value_type>));
+
+
+	assert(grainSize > 0);
+	
+	std::size_t n = last - first;
+	
+	if (n != (std::size_t) (sourceLast - sourceFirst))
+	{
+		return false;
+	}
+	
+	std::size_t blockCount = (n + grainSize - 1) / grainSize;
+	std::vector <Fingerprint> sorted(blockCount, Fingerprint(hash)), source(blockCount, Fingerprint(hash));
+	std::atomic <bool> isOrdered(true);
+	
+	{
+		TaskGroup group(pool);
+		
+		for (std::size_t i = 0; i < blockCount; i++)
+		{
+			group.run([first, sourceFirst, n, grainSize, swoCompare, hash, &sorted, &source, &isOrdered, i]()
+			{
+				std::size_t begin = i * grainSize, end = std::min(begin + grainSize, n);
+				
+				sorted[i] = Fingerprint(first + begin, first + end, hash);
+				source[i] = Fingerprint(sourceFirst + begin, sourceFirst + end, hash);
+				
+				// the block and the first element of the next one
+				if (!isSorted(first + begin, first + std::min(end + 1, n), swoCompare))
+				{
+					isOrdered = false;
+				}
+			});
+		}
+		
+		group.wait();
+	}
+	
+	for (std::size_t i = 1; i < blockCount; i++)
+	{
+		sorted[0].add(sorted[i]);
+		source[0].add(source[i]);
+	}
+	
+	return isOrdered && (blockCount == 0 || sorted[0] == source[0]);
+}
+
+/**
+ * Element together with its index in the source range, for checking
+ * stability of a sort without sorting again: sort range created by
+ * tagElements() with TaggedElementOrdering and check the result by
+ * isStableSortedByTags().
+ */
+template <typename TPL_TaggedElement_T> struct TaggedElement
+{
+	public: TPL_TaggedElement_T value;
+	public: std::size_t index;
+}
+
+/**
+ * Compares tagged elements by their values only.
+ */
+template <class TPL_TaggedElementOrdering_StrictWeakOrdering> class TaggedElementOrdering
+{
+	/**
+	 * Mutable for the same reason as in PriorityQueue.
+	 */
+	private: mutable TPL_TaggedElementOrdering_StrictWeakOrdering swoCompare;
+
+
+	public: TaggedElementOrdering(TPL_TaggedElementOrdering_StrictWeakOrdering swoCompare = TPL_TaggedElementOrdering_StrictWeakOrdering()):
+			swoCompare(swoCompare)
+	{
+		//nothing
+	}
+
+	public: template <typename TPL_T> bool operator()(TaggedElement <TPL_T> const &a, TaggedElement <TPL_T> const &b) const
+	{
+		return this->swoCompare(a.value, b.value);
+	}
+}
+
+/**
+ * Returns the elements of [first; last) tagged with their indexes.
+ */
+template <typename TPL_InputIterator> std::vector <TaggedElement <typename iterator_traits <TPL_InputIterator> ::value_type> > tagElements(
+		TPL_InputIterator first,
+		TPL_InputIterator last
+)
+{
+	std::vector <TaggedElement <typename iterator_traits <TPL_InputIterator> ::value_type> > res;
+	
+	for (std::size_t i = 0; first != last; ++first, i++)
+	{
+		res.push_back({*first, i});
+	}
+	
+	return res;
+}
+
+/**
+ * Returns true if tagged element b may follow a in a stable-sorted range.
+ */
+template <typename TPL_T, typename TPL_StrictWeakOrdering> bool isTaggedPairInOrder(
+		TaggedElement <TPL_T> const &a,
+		TaggedElement <TPL_T> const &b,
+		TPL_StrictWeakOrdering swoCompare
+)
+{
+	if (swoCompare(b.value, a.value))
+	{
+		return false;
+	}
+	
+	return swoCompare(a.value, b.value) || a.index < b.index;
+}
+
+/**
+ * Checks that tagged range [first; last), obtained by sorting the result
+ * of tagElements(sourceFirst, sourceLast), is stable-sorted: the tags are
+ * a permutation of the indexes, every value equals the source element with
+ * its tag, values are sorted and tags of equivalent neighbours increase.
+ * Unlike isStableSorted(), this is exact and doesn't sort again.
+ *
+ * @time O(n)
+ * @space O(n) bits
+ */
+template <typename TPL_Iterator1, typename TPL_Iterator2, typename TPL_StrictWeakOrdering> bool isStableSortedByTags(
+		TPL_Iterator1 first,
+		TPL_Iterator1 last,
+		TPL_Iterator2 sourceFirst,
+		TPL_Iterator2 sourceLast,
+		TPL_StrictWeakOrdering swoCompare
+)
+{
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator1>));
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator2>));
+
+
+	std::size_t n = last - first;
+	
+	if (n != (std::size_t) (sourceLast - sourceFirst))
+	{
+		return false;
+	}
+	
+	std::vector <bool> isSeen(n, false);
+	
+	for (std::size_t i = 0; i < n; i++)
+	{
+		std::size_t index = first[i].index;
+		
+		if (index >= n || isSeen[index] || !(first[i].value == sourceFirst[index]))
+		{
+			return false;
+		}
+		
+		isSeen[index] = true;
+		
+		if (i > 0 && !isTaggedPairInOrder(first[i - 1], first[i], swoCompare))
+		{
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+/**
+ * Parallel version of isStableSortedByTags(): blocks of grainSize
+ * elements are checked by tasks of the pool.
+ */
+template <typename TPL_Iterator1, typename TPL_Iterator2, typename TPL_StrictWeakOrdering> bool isStableSortedByTags(
+		TPL_Iterator1 first,
+		TPL_Iterator1 last,
+		TPL_Iterator2 sourceFirst,
+		TPL_Iterator2 sourceLast,
+		TPL_StrictWeakOrdering swoCompare,
+		ThreadPool &pool,
+		std::size_t grainSize = 1 << 16
+)
+{
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator1>));
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator2>));
+
+
+	assert(grainSize > 0);
+	
+	std::size_t n = last - first;
+	
+	if (n != (std::size_t) (sourceLast - sourceFirst))
+	{
+		return false;
+	}
+	
+	// a byte per index, as tasks mark indexes concurrently
+	std::vector <std::atomic <unsigned char> > isSeen(n);
+	std::atomic <bool> res(true);
+	
+	{
+		TaskGroup group(pool);
+		
+		for (std::size_t begin = 0; begin < n; begin += grainSize)
+		{
+			group.run([first, sourceFirst, n, grainSize, swoCompare, &isSeen, &res, begin]()
+			{
+				std::size_t end = std::min(begin + grainSize, n);
+				
+				for (std::size_t i = begin; i < end && res; i++)
+				{
+					std::size_t index = first[i].index;
+					
+					if (
+							index >= n
+							|| isSeen[index].exchange(1, std::memory_order_relaxed) != 0
+							|| !(first[i].value == sourceFirst[index])
+							|| (i > 0 && !isTaggedPairInOrder(first[i - 1], first[i], swoCompare))
+					)
+					{
+						res = false;
+					}
+				}
+			});
+		}
+		
+		group.wait();
+	}
+	
+	return res;
+}
+
 /**
  * Merge function for the merge sort algorithm. This function merges
  * two sorted ranges of elements into a single sorted range.
@@ -306,6 +696,71 @@ class Sorter
 
 
 	private: typedef typename iterator_traits <TPL_Sorter_Iterator> ::difference_type difference_type;
+	private: typedef typename iterator_traits <TPL_Sorter_Iterator> ::value_type value_type;
+
+
+	/**
+	 * introSort() finishes partitions not longer than this by insertion sort
+	 * (or by a sorting network, see IS_NETWORK_BASE_CASE).
+	 */
+	private: static const difference_type INSERTION_SORT_THRESHOLD = 16;
+
+	/**
+	 * pdqSort() partitions by blocks of this many elements: comparison results
+	 * are first recorded as offsets without branches, then misplaced elements
+	 * of both sides are swapped (must fit into unsigned char).
+	 */
+	private: static const difference_type PDQ_BLOCK_SIZE = 64;
+
+	/**
+	 * pdqSort() gives up the attempt to finish an already partitioned range
+	 * by insertion sort after this many element moves.
+	 */
+	private: static const difference_type PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+	/**
+	 * networkSort() sorts ranges not longer than this by sorting networks.
+	 */
+	private: static const difference_type NETWORK_SORT_THRESHOLD = 32;
+
+	/**
+	 * introSort() chooses pivots of longer partitions as ninther
+	 * (median of three medians of three) instead of median of three.
+	 */
+	private: static const difference_type NINTHER_THRESHOLD = 128;
+
+	/**
+	 * mergeSort() sorts runs not longer than this by binary insertion sort.
+	 */
+	private: static const difference_type MERGE_SORT_RUN_LENGTH = 24;
+
+	/**
+	 * powerSort() starts galloping (exponential search) when one side wins
+	 * this many times in a row during a merge.
+	 */
+	private: static const difference_type MIN_GALLOP = 7;
+
+	/**
+	 * nthElement() switches to median of medians after this many partitions
+	 * which keep more than 7/8 of the range.
+	 */
+	private: static const difference_type NTH_ELEMENT_BAD_PARTITION_LIMIT = 4;
+
+	/**
+	 * Whether short ranges are sorted by branchless sorting networks instead
+	 * of insertion sort. Compare-exchange of arithmetic values and pointers
+	 * compiles to conditional moves, other types are better off with the
+	 * fewer moves of insertion sort.
+	 */
+	private: static const bool IS_NETWORK_BASE_CASE = std::is_arithmetic <value_type> ::value || std::is_pointer <value_type> ::value;
+
+	/**
+	 * Whether mergeSort() may sort its runs by sorting networks, which are
+	 * not stable: only if equivalent elements are indistinguishable (which is
+	 * not the case for floating point -0 and +0).
+	 */
+	private: static const bool IS_NETWORK_MERGE_SORT_RUN = std::is_integral <value_type> ::value
+			&& std::is_same <TPL_Sorter_StrictWeakOrdering, std::less <value_type> > ::value;
 
 
 	private: TPL_Sorter_Iterator first, last;
@@ -349,42 +804,267 @@ class Sorter
 	{
 		Sorter::quickSort(this->first, this->last, this->swoCompare);
 	}
-	
+
 	/**
-	 * Returns number of inversions, which are defined as follows:
-	 * inversion in sequence A is pair of elements (A[i], A[j]) such
-	 * that i < j and swoCompare(A[j], A[i]) == true.
+	 * Introsort: quick sort with median-of-three (ninther for long ranges)
+	 * pivots, which falls back to heap sort when recursion gets too deep,
+	 * so the worst case is O(n * log(n)). Short partitions are finished
+	 * by insertion sort. Only the shorter side of every partition is sorted
+	 * recursively, so the recursion depth is O(log(n)).
+	 *
+	 * @time O(n * log(n))
+	 * @space O(log(n))
 	 */
-	public: int mergeSort()
+	public: void introSort()
 	{
-		return Sorter::mergeSort(this->first, this->last, this->swoCompare);
+		Sorter::introSort(this->first, this->last, this->swoCompare, Sorter::getDepthLimit(this->last - this->first));
 	}
 
-	private: static void selectionSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	/**
+	 * Pattern-defeating quick sort (unstable). Differences from introSort():
+	 *
+	 * - Partitioning is branchless: comparison results of a block of elements
+	 *   on each side are stored as offsets of misplaced elements, which are
+	 *   then swapped pairwise, so random data causes no branch mispredictions.
+	 * - If partitioning moved no element, both sides are tried to be finished
+	 *   by insertion sort which gives up after a few moves; sorted ranges (and
+	 *   strictly descending ones, which are reversed beforehand) take O(n).
+	 * - If a partition is equal to its left neighbour (the previous pivot),
+	 *   elements equal to the pivot are put aside, so few distinct values take O(n * k).
+	 * - Highly unbalanced partitions swap some elements to random positions to
+	 *   break the pattern; after log2(n) of them heap sort takes over.
+	 *
+	 * @time O(n * log(n))
+	 * @space O(log(n))
+	 */
+	public: void pdqSort()
 	{
-		for (difference_type j = 1; j < last - first; j++)
+		difference_type n = this->last - this->first;
+		
+		if (n > Sorter::INSERTION_SORT_THRESHOLD && Sorter::isStrictlyDescending(this->first, this->last, this->swoCompare))
 		{
-			for (difference_type k = 0; k < j; k++)
-			{
-				if (swoCompare(*(first + j), *(first + k)))
-				{
-					std::iter_swap(first + j, first + k);
-				}
-			}
+			std::reverse(this->first, this->last);
+			return;
 		}
+		
+		std::minstd_rand random(12345);
+		Sorter::pdqSort(this->first, this->last, this->swoCompare, Sorter::getDepthLimit(n) / 2, true, random);
 	}
 
-	private: static void bubbleSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	/**
+	 * Rearranges the range so that the element at position k is the one
+	 * which would be there if the range were sorted, no element before it is
+	 * greater and no element after it is less (like std::nth_element).
+	 *
+	 * Introselect: quick select with the pivots of introSort(), which falls
+	 * back to median of medians after NTH_ELEMENT_BAD_PARTITION_LIMIT highly
+	 * unbalanced partitions. Other partitions shrink the range geometrically,
+	 * so the worst case is linear.
+	 *
+	 * @param k 0 <= k < n.
+	 * @time O(n)
+	 */
+	public: void nthElement(difference_type k)
 	{
-		const difference_type n = last - first;
+		assert(k >= 0 && k < this->last - this->first);
+		Sorter::nthElement(this->first, this->first + k, this->last, this->swoCompare);
+	}
+
+	/**
+	 * Moves the k least elements to the beginning of the range in sorted
+	 * order; the order of the other elements is unspecified. Selects the
+	 * k-th element by nthElement(), then sorts the prefix by pdqSort().
+	 *
+	 * @param k 0 <= k <= n.
+	 * @time O(n + k * log(k))
+	 */
+	public: void partialSort(difference_type k)
+	{
+		assert(k >= 0 && k <= this->last - this->first);
 		
-		for (difference_type i = 0; i < n; ++i)
+		if (k < this->last - this->first)
 		{
-			difference_type min = i;
-			
-			for (difference_type j = i + 1; j < n; ++j)
-			{
-				if (swoCompare(*(first + j), *(first + min)))
+			this->nthElement(k);
+		}
+		
+		Sorter(this->first, this->first + k, this->swoCompare).pdqSort();
+	}
+
+	/**
+	 * Unstable sort for short ranges: ranges of at most 32 elements are
+	 * sorted by a single sorting network (see sortByNetwork(); int32 and float
+	 * use SIMD registers if AVX2 or AVX-512 is enabled), longer ones by introSort().
+	 *
+	 * @time O(log(n) ^ 2) comparator layers for n <= 32, O(n * log(n)) otherwise
+	 */
+	public: void networkSort()
+	{
+		if (this->last - this->first <= Sorter::NETWORK_SORT_THRESHOLD)
+		{
+			sortByNetwork(this->first, this->last - this->first, this->swoCompare);
+		}
+		else
+		{
+			this->introSort();
+		}
+	}
+	
+	/**
+	 * Stable merge sort. Returns number of inversions, which are defined as follows:
+	 * inversion in sequence A is pair of elements (A[i], A[j]) such
+	 * that i < j and swoCompare(A[j], A[i]) == true.
+	 *
+	 * Allocates one scratch buffer of n elements; merge passes alternate
+	 * between the range and the buffer, and short runs are sorted by
+	 * binary insertion sort.
+	 *
+	 * @time O(n * log(n))
+	 * @space O(n)
+	 */
+	public: long long mergeSort()
+	{
+		std::vector <value_type> buffer(this->first, this->last);
+		return Sorter::mergeSort(buffer.data(), this->first, 0, this->last - this->first, this->swoCompare);
+	}
+
+	/**
+	 * Same as mergeSort(), but uses scratch buffer supplied by the caller
+	 * instead of allocating one.
+	 *
+	 * @param buffer Array of at least n elements; its contents are overwritten.
+	 */
+	public: long long mergeSort(value_type *buffer)
+	{
+		std::copy(this->first, this->last, buffer);
+		return Sorter::mergeSort(buffer, this->first, 0, this->last - this->first, this->swoCompare);
+	}
+
+	/**
+	 * Adaptive stable merge sort (powersort). Returns number of inversions,
+	 * like mergeSort().
+	 *
+	 * The range is scanned for natural runs: non-descending ones are kept,
+	 * strictly descending ones are reversed, and runs shorter than
+	 * MERGE_SORT_RUN_LENGTH are extended by binary insertion sort. Adjacent
+	 * runs are merged in the order given by their powers (the depth of the
+	 * boundary between them in the perfectly balanced merge tree over
+	 * [0; n)), which makes the merge cost within n of the optimum for the
+	 * given runs. Merges skip the elements already in place, copy the
+	 * shorter run into the buffer and gallop when one side keeps winning.
+	 *
+	 * @time O(n * (1 + H)), where H <= log(n) is the entropy of the run
+	 *		lengths; O(n) for a few sorted or descending runs
+	 * @space O(n)
+	 */
+	public: long long powerSort()
+	{
+		difference_type n = this->last - this->first;
+		std::vector <value_type> buffer(this->first, this->first + n / 2);
+		std::vector <Run> runs;
+		long long count = 0;
+		
+		for (difference_type start = 0; start < n; )
+		{
+			difference_type length = Sorter::findRun(this->first + start, this->last, this->swoCompare, count);
+			
+			if (length < Sorter::MERGE_SORT_RUN_LENGTH)
+			{
+				// already sorted prefix contributes no inversions and little work
+				length = std::min((difference_type) Sorter::MERGE_SORT_RUN_LENGTH, n - start);
+				count += Sorter::binaryInsertionSort(this->first + start, this->first + start + length, this->swoCompare);
+			}
+			
+			if (!runs.empty())
+			{
+				int power = Sorter::getPower(runs.back().start, runs.back().length, length, n);
+				
+				while (runs.size() > 1 && runs[runs.size() - 2].power > power)
+				{
+					count += this->mergeTopRuns(runs, buffer.data());
+				}
+				
+				runs.back().power = power;
+			}
+			
+			runs.push_back(Run {start, length, 0});
+			start += length;
+		}
+		
+		while (runs.size() > 1)
+		{
+			count += this->mergeTopRuns(runs, buffer.data());
+		}
+		
+		return count;
+	}
+
+	/**
+	 * Parallel stable merge sort. Both halves of every range longer than
+	 * grainSize are sorted by different tasks of the pool, and the halves are
+	 * merged in parallel: the output is cut into pieces of grainSize elements,
+	 * and the part of each half which goes into every piece is found by
+	 * binary search (co-ranking).
+	 *
+	 * @param grainSize Ranges not longer than this are sorted sequentially by mergeSort().
+	 * @time O(n * log(n)) work, O(n) sequential part at most grainSize * log(n)
+	 * @space O(n)
+	 */
+	public: void parallelMergeSort(ThreadPool &pool, difference_type grainSize = 1 << 14)
+	{
+		std::vector <value_type> buffer(this->first, this->last);
+		
+		Sorter::parallelMergeSort(
+				buffer.data(),
+				this->first,
+				0,
+				this->last - this->first,
+				this->swoCompare,
+				pool,
+				std::max(grainSize, (difference_type) Sorter::MERGE_SORT_RUN_LENGTH)
+		);
+	}
+
+	/**
+	 * Parallel sample sort (unstable). Splitters are chosen from a random
+	 * sample, then blocks of the range are classified into buckets and
+	 * scattered into a buffer by parallel tasks, and every bucket is sorted
+	 * by introSort() in its own task.
+	 *
+	 * @param grainSize Number of elements per classification task; ranges
+	 *		not longer than this are sorted sequentially by introSort().
+	 * @time O(n * log(n)) expected work
+	 * @space O(n)
+	 */
+	public: void parallelSampleSort(ThreadPool &pool, difference_type grainSize = 1 << 16)
+	{
+		Sorter::parallelSampleSort(this->first, this->last, this->swoCompare, pool, std::max(grainSize, (difference_type) Sorter::NINTHER_THRESHOLD));
+	}
+
+	private: static void selectionSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		for (difference_type j = 1; j < last - first; j++)
+		{
+			for (difference_type k = 0; k < j; k++)
+			{
+				if (swoCompare(*(first + j), *(first + k)))
+				{
+					std::iter_swap(first + j, first + k);
+				}
+			}
+		}
+	}
+
+	private: static void bubbleSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		const difference_type n = last - first;
+		
+		for (difference_type i = 0; i < n; ++i)
+		{
+			difference_type min = i;
+			
+			for (difference_type j = i + 1; j < n; ++j)
+			{
+				if (swoCompare(*(first + j), *(first + min)))
 				{
 					min = j;
 				}
@@ -469,27 +1149,1419 @@ class Sorter
 		Sorter::quickSort(i + 1, last, swoCompare);
 	}
 
-	private: static int mergeSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	/**
+	 * Returns recursion depth after which introSort() switches to heap sort, 2 * log2(n).
+	 */
+	private: static difference_type getDepthLimit(difference_type n)
 	{
-		if (first == last || first == last - 1)
+		difference_type res = 0;
+		
+		for ( ; n > 1; n /= 2)
 		{
-			return 0;
+			res += 2;
 		}
 		
-		int count = Sorter::mergeSort(first, first + (last - first) / 2, swoCompare);
-		count += Sorter::mergeSort(first + (last - first) / 2, last, swoCompare);
+		return res;
+	}
+
+	private: static void introSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare, difference_type depthLimit)
+	{
+		while (last - first > Sorter::INSERTION_SORT_THRESHOLD)
+		{
+			if (depthLimit == 0)
+			{
+				// too many unbalanced partitions, the input is probably adversarial
+				Sorter::heapSort(first, last, swoCompare);
+				return;
+			}
+			
+			depthLimit--;
+			
+			TPL_Sorter_Iterator cut = Sorter::partition(first, last, swoCompare);
+			
+			// recurse into the shorter side, loop on the longer one
+			
+			if (cut - first < last - cut)
+			{
+				Sorter::introSort(first, cut, swoCompare, depthLimit);
+				first = cut;
+			}
+			else
+			{
+				Sorter::introSort(cut, last, swoCompare, depthLimit);
+				last = cut;
+			}
+		}
 		
-		count += merge(
-			first,
-			first + (last - first) / 2,
-			first + (last - first) / 2,
-			last,
-			first,
-			swoCompare
-		);
+		Sorter::sortShort(first, last, swoCompare);
+	}
+
+	/**
+	 * Sorts a range not longer than INSERTION_SORT_THRESHOLD.
+	 */
+	private: static void sortShort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		if constexpr (Sorter::IS_NETWORK_BASE_CASE)
+		{
+			sortByNetwork(first, last - first, swoCompare);
+		}
+		else
+		{
+			Sorter::insertionSort(first, last, swoCompare);
+		}
+	}
+
+	/**
+	 * @param badAllowed Number of highly unbalanced partitions after which
+	 *		the range is sorted by heap sort.
+	 * @param isLeftmost Whether the range is the leftmost one; otherwise
+	 *		*(first - 1) is the pivot of the enclosing partition, and no element
+	 *		of the range is less than it.
+	 */
+	private: static void pdqSort(
+			TPL_Sorter_Iterator first,
+			TPL_Sorter_Iterator last,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			difference_type badAllowed,
+			bool isLeftmost,
+			std::minstd_rand &random
+	)
+	{
+		while (last - first > Sorter::INSERTION_SORT_THRESHOLD)
+		{
+			difference_type n = last - first;
+			Sorter::choosePivot(first, last, swoCompare);
+			
+			if (!isLeftmost && !swoCompare(*(first - 1), *first))
+			{
+				/*
+				 * The pivot is equal to the previous one, which is not greater
+				 * than any element of the range: put all elements equal to the
+				 * pivot to the left, they are already in place.
+				 */
+				first = Sorter::partitionLeft(first, last, swoCompare) + 1;
+				continue;
+			}
+			
+			bool isAlreadyPartitioned;
+			TPL_Sorter_Iterator pivot = Sorter::partitionBlocks(first, last, swoCompare, isAlreadyPartitioned);
+			difference_type leftSize = pivot - first, rightSize = last - (pivot + 1);
+			
+			if (leftSize < n / 8 || rightSize < n / 8)
+			{
+				if (--badAllowed == 0)
+				{
+					Sorter::heapSort(first, last, swoCompare);
+					return;
+				}
+				
+				Sorter::shuffleEnds(first, pivot, random);
+				Sorter::shuffleEnds(pivot + 1, last, random);
+			}
+			else if (
+					isAlreadyPartitioned
+					&& Sorter::partialInsertionSort(first, pivot, swoCompare)
+					&& Sorter::partialInsertionSort(pivot + 1, last, swoCompare)
+			)
+			{
+				// probably a sorted range
+				return;
+			}
+			
+			// recurse into the shorter side, loop on the longer one
+			
+			if (leftSize < rightSize)
+			{
+				Sorter::pdqSort(first, pivot, swoCompare, badAllowed, isLeftmost, random);
+				first = pivot + 1;
+				isLeftmost = false;
+			}
+			else
+			{
+				Sorter::pdqSort(pivot + 1, last, swoCompare, badAllowed, false, random);
+				last = pivot;
+			}
+		}
 		
-		return count;
+		Sorter::sortShort(first, last, swoCompare);
+	}
+
+	/**
+	 * Partitions the range around pivot *first with block partitioning.
+	 * Elements equal to the pivot may go to both sides.
+	 *
+	 * @pre One of the last three elements is not less than the pivot.
+	 * @param isAlreadyPartitioned Receives true if no element had to be moved.
+	 * @return Final position of the pivot; no element of [first; pivot) is
+	 *		greater and no element of (pivot; last) is less than it.
+	 */
+	private: static TPL_Sorter_Iterator partitionBlocks(
+			TPL_Sorter_Iterator first,
+			TPL_Sorter_Iterator last,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			bool &isAlreadyPartitioned
+	)
+	{
+		value_type pivot = std::move(*first);
+		TPL_Sorter_Iterator i = first, j = last;
+		
+		// skip the prefix and the suffix which are in place
+		
+		while (swoCompare(*++i, pivot))
+		{
+			//nothing
+		}
+		
+		if (i - 1 == first)
+		{
+			// no element less than the pivot on the left to stop the scan
+			while (i < j && !swoCompare(*--j, pivot))
+			{
+				//nothing
+			}
+		}
+		else
+		{
+			while (!swoCompare(*--j, pivot))
+			{
+				//nothing
+			}
+		}
+		
+		isAlreadyPartitioned = i >= j;
+		
+		if (!isAlreadyPartitioned)
+		{
+			std::iter_swap(i, j);
+			++i;
+			
+			/*
+			 * [i; j) is unknown. offsetsL[startL .. startL + countL) are offsets
+			 * from baseL of elements on the left which belong to the right,
+			 * offsetsR the same for the right side (counted backwards from baseR).
+			 */
+			unsigned char offsetsL[Sorter::PDQ_BLOCK_SIZE], offsetsR[Sorter::PDQ_BLOCK_SIZE];
+			TPL_Sorter_Iterator baseL = i, baseR = j;
+			difference_type countL = 0, countR = 0, startL = 0, startR = 0;
+			
+			while (i < j)
+			{
+				// scan a whole block on the side(s) without pending offsets, split the rest near the end
+				
+				const difference_type blockSize = Sorter::PDQ_BLOCK_SIZE;
+				difference_type unknown = j - i;
+				difference_type sizeL = countL == 0 ? std::min(countR == 0 ? unknown / 2 : unknown, blockSize) : 0;
+				difference_type sizeR = countR == 0 ? std::min(unknown - sizeL, blockSize) : 0;
+				
+				for (difference_type k = 0; k < sizeL; k++)
+				{
+					offsetsL[countL] = (unsigned char) k;
+					countL += !swoCompare(*i, pivot);
+					++i;
+				}
+				
+				for (difference_type k = 0; k < sizeR; k++)
+				{
+					offsetsR[countR] = (unsigned char) (k + 1);
+					countR += swoCompare(*--j, pivot);
+				}
+				
+				difference_type count = std::min(countL, countR);
+				Sorter::swapOffsets(baseL, baseR, offsetsL + startL, offsetsR + startR, count);
+				
+				countL -= count;
+				countR -= count;
+				startL += count;
+				startR += count;
+				
+				if (countL == 0)
+				{
+					startL = 0;
+					baseL = i;
+				}
+				
+				if (countR == 0)
+				{
+					startR = 0;
+					baseR = j;
+				}
+			}
+			
+			// move the remaining misplaced elements of one side to the boundary
+			
+			if (countL > 0)
+			{
+				while (countL-- > 0)
+				{
+					std::iter_swap(baseL + offsetsL[startL + countL], --j);
+				}
+				
+				i = j;
+			}
+			
+			if (countR > 0)
+			{
+				while (countR-- > 0)
+				{
+					std::iter_swap(baseR - offsetsR[startR + countR], i);
+					++i;
+				}
+			}
+		}
+		
+		TPL_Sorter_Iterator res = i - 1;
+		*first = std::move(*res);
+		*res = std::move(pivot);
+		
+		return res;
+	}
+
+	/**
+	 * Swaps count pairs of misplaced elements found by partitionBlocks(),
+	 * as a cycle of moves rather than separate swaps.
+	 */
+	private: static void swapOffsets(
+			TPL_Sorter_Iterator baseL,
+			TPL_Sorter_Iterator baseR,
+			const unsigned char *offsetsL,
+			const unsigned char *offsetsR,
+			difference_type count
+	)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		
+		TPL_Sorter_Iterator l = baseL + offsetsL[0], r = baseR - offsetsR[0];
+		value_type element = std::move(*l);
+		*l = std::move(*r);
+		
+		for (difference_type k = 1; k < count; k++)
+		{
+			l = baseL + offsetsL[k];
+			*r = std::move(*l);
+			r = baseR - offsetsR[k];
+			*l = std::move(*r);
+		}
+		
+		*r = std::move(element);
+	}
+
+	/**
+	 * Partitions the range around pivot *first so that elements equal to
+	 * the pivot go to the left.
+	 *
+	 * @pre *(first - 1) exists and is not greater than any element of the range.
+	 * @return Final position of the pivot; no element of [first; pivot] is
+	 *		greater and every element of (pivot; last) is greater than it.
+	 */
+	private: static TPL_Sorter_Iterator partitionLeft(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		value_type pivot = std::move(*first);
+		TPL_Sorter_Iterator i = first, j = last;
+		
+		while (swoCompare(pivot, *--j))
+		{
+			//nothing
+		}
+		
+		if (j + 1 == last)
+		{
+			while (i < j && !swoCompare(pivot, *++i))
+			{
+				//nothing
+			}
+		}
+		else
+		{
+			while (!swoCompare(pivot, *++i))
+			{
+				//nothing
+			}
+		}
+		
+		while (i < j)
+		{
+			std::iter_swap(i, j);
+			
+			while (swoCompare(pivot, *--j))
+			{
+				//nothing
+			}
+			
+			while (!swoCompare(pivot, *++i))
+			{
+				//nothing
+			}
+		}
+		
+		*first = std::move(*j);
+		*j = std::move(pivot);
+		
+		return j;
+	}
+
+	/**
+	 * Insertion sort which gives up after PARTIAL_INSERTION_SORT_LIMIT moves.
+	 *
+	 * @return true if the range has been sorted.
+	 */
+	private: static bool partialInsertionSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		if (first == last)
+		{
+			return true;
+		}
+		
+		difference_type moveCount = 0;
+		
+		for (TPL_Sorter_Iterator it = first + 1; it < last; ++it)
+		{
+			if (swoCompare(*it, *(it - 1)))
+			{
+				value_type element = std::move(*it);
+				TPL_Sorter_Iterator hole = it;
+				
+				do
+				{
+					*hole = std::move(*(hole - 1));
+					--hole;
+				}
+				while (hole != first && swoCompare(element, *(hole - 1)));
+				
+				*hole = std::move(element);
+				moveCount += it - hole;
+				
+				if (moveCount > Sorter::PARTIAL_INSERTION_SORT_LIMIT)
+				{
+					return false;
+				}
+			}
+		}
+		
+		return true;
 	}
+
+	/**
+	 * Swaps a few elements at both ends of a range with elements at random
+	 * positions, to break patterns which made a partition unbalanced.
+	 */
+	private: static void shuffleEnds(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, std::minstd_rand &random)
+	{
+		difference_type n = last - first;
+		
+		if (n < Sorter::INSERTION_SORT_THRESHOLD)
+		{
+			return;
+		}
+		
+		int count = n > Sorter::NINTHER_THRESHOLD ? 3 : 1;
+		
+		for (int k = 0; k < count; k++)
+		{
+			std::iter_swap(first + k, first + (difference_type) (random() % n));
+			std::iter_swap(last - 1 - k, first + (difference_type) (random() % n));
+		}
+	}
+
+	private: static bool isStrictlyDescending(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		for (TPL_Sorter_Iterator it = first + 1; it < last; ++it)
+		{
+			if (!swoCompare(*it, *(it - 1)))
+			{
+				return false;
+			}
+		}
+		
+		return true;
+	}
+
+	/**
+	 * Moves the pivot to *first and partitions the range [first + 1; last)
+	 * around it.
+	 *
+	 * @pre last - first > INSERTION_SORT_THRESHOLD
+	 * @return Iterator cut such that no element of [first; cut) is greater
+	 *		than the pivot and no element of [cut; last) is less than the pivot.
+	 *		first < cut < last.
+	 */
+	private: static TPL_Sorter_Iterator partition(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		Sorter::choosePivot(first, last, swoCompare);
+		
+		/*
+		 * The pivot is at *first, and some element of the range is not less
+		 * than it (the maximum of a sample at the end), so neither scan
+		 * can leave the range without bounds checks.
+		 */
+		
+		TPL_Sorter_Iterator i = first + 1, j = last;
+		
+		while (true)
+		{
+			while (swoCompare(*i, *first))
+			{
+				++i;
+			}
+			
+			--j;
+			
+			while (swoCompare(*first, *j))
+			{
+				--j;
+			}
+			
+			if (!(i < j))
+			{
+				return i;
+			}
+			
+			std::iter_swap(i, j);
+			++i;
+		}
+	}
+
+	private: static void nthElement(
+			TPL_Sorter_Iterator first,
+			TPL_Sorter_Iterator nth,
+			TPL_Sorter_Iterator last,
+			TPL_Sorter_StrictWeakOrdering swoCompare
+	)
+	{
+		difference_type badAllowed = Sorter::NTH_ELEMENT_BAD_PARTITION_LIMIT;
+		
+		while (last - first > Sorter::INSERTION_SORT_THRESHOLD)
+		{
+			difference_type n = last - first;
+			TPL_Sorter_Iterator cut = Sorter::partition(first, last, swoCompare);
+			
+			if (nth < cut)
+			{
+				last = cut;
+			}
+			else
+			{
+				first = cut;
+			}
+			
+			if (last - first > n - n / 8 && --badAllowed == 0)
+			{
+				Sorter::selectByMedianOfMedians(first, nth, last, swoCompare);
+				return;
+			}
+		}
+		
+		Sorter::sortShort(first, last, swoCompare);
+	}
+
+	/**
+	 * Linear-time selection (Blum, Floyd, Pratt, Rivest, Tarjan): the pivot
+	 * is the median of the medians of groups of five elements, so that at
+	 * least 3/10 of the elements are on either side of it.
+	 *
+	 * @time O(n)
+	 */
+	private: static void selectByMedianOfMedians(TPL_Sorter_Iterator first, TPL_Sorter_Iterator nth, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		while (last - first > Sorter::INSERTION_SORT_THRESHOLD)
+		{
+			// move the median of every group to the beginning, then select their median
+			
+			difference_type groupCount = (last - first) / 5;
+			
+			for (difference_type i = 0; i < groupCount; i++)
+			{
+				TPL_Sorter_Iterator group = first + 5 * i;
+				Sorter::insertionSort(group, group + 5, swoCompare);
+				std::iter_swap(first + i, group + 2);
+			}
+			
+			TPL_Sorter_Iterator median = first + groupCount / 2;
+			Sorter::selectByMedianOfMedians(first, median, first + groupCount, swoCompare);
+			std::iter_swap(first, median);
+			
+			std::pair <TPL_Sorter_Iterator, TPL_Sorter_Iterator> equal = Sorter::partition3(first, last, swoCompare);
+			
+			if (nth < equal.first)
+			{
+				last = equal.first;
+			}
+			else if (nth >= equal.second)
+			{
+				first = equal.second;
+			}
+			else
+			{
+				return;
+			}
+		}
+		
+		Sorter::insertionSort(first, last, swoCompare);
+	}
+
+	/**
+	 * Three-way partition around pivot *first.
+	 *
+	 * @return Range of the elements equivalent to the pivot; the elements
+	 *		before it are less, the elements after it are greater.
+	 */
+	private: static std::pair <TPL_Sorter_Iterator, TPL_Sorter_Iterator> partition3(
+			TPL_Sorter_Iterator first,
+			TPL_Sorter_Iterator last,
+			TPL_Sorter_StrictWeakOrdering swoCompare
+	)
+	{
+		value_type pivot = *first;
+		TPL_Sorter_Iterator less = first, it = first, greater = last;
+		
+		while (it < greater)
+		{
+			if (swoCompare(*it, pivot))
+			{
+				std::iter_swap(less++, it++);
+			}
+			else if (swoCompare(pivot, *it))
+			{
+				std::iter_swap(it, --greater);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		
+		return std::make_pair(less, greater);
+	}
+
+	/**
+	 * Moves median of three (ninther for long ranges) to *first. Afterwards
+	 * one of the last three elements is not less than the pivot.
+	 *
+	 * @pre last - first > INSERTION_SORT_THRESHOLD
+	 */
+	private: static void choosePivot(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		difference_type n = last - first;
+		TPL_Sorter_Iterator mid = first + n / 2;
+		
+		if (n > Sorter::NINTHER_THRESHOLD)
+		{
+			Sorter::sort3(first, mid, last - 1, swoCompare);
+			Sorter::sort3(first + 1, mid - 1, last - 2, swoCompare);
+			Sorter::sort3(first + 2, mid + 1, last - 3, swoCompare);
+			Sorter::sort3(mid - 1, mid, mid + 1, swoCompare);
+			std::iter_swap(first, mid);
+		}
+		else
+		{
+			Sorter::sort3(mid, first, last - 1, swoCompare);
+		}
+	}
+
+	/**
+	 * Reorders three elements so that !swoCompare(*b, *a) and !swoCompare(*c, *b).
+	 */
+	private: static void sort3(TPL_Sorter_Iterator a, TPL_Sorter_Iterator b, TPL_Sorter_Iterator c, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		if (swoCompare(*b, *a))
+		{
+			std::iter_swap(a, b);
+		}
+		
+		if (swoCompare(*c, *b))
+		{
+			std::iter_swap(b, c);
+			
+			if (swoCompare(*b, *a))
+			{
+				std::iter_swap(a, b);
+			}
+		}
+	}
+
+	/**
+	 * Stable insertion sort, efficient for short or nearly sorted ranges.
+	 *
+	 * @time O(n ^ 2)
+	 */
+	private: static void insertionSort(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		if (first == last)
+		{
+			return;
+		}
+		
+		for (TPL_Sorter_Iterator it = first + 1; it < last; ++it)
+		{
+			value_type element = std::move(*it);
+			TPL_Sorter_Iterator hole = it;
+			
+			for ( ; hole != first && swoCompare(element, *(hole - 1)); --hole)
+			{
+				*hole = std::move(*(hole - 1));
+			}
+			
+			*hole = std::move(element);
+		}
+	}
+
+	/**
+	 * Sorts range [lo; hi) of src into the same range of dst. On the way
+	 * down the roles of src and dst alternate, so no element is copied
+	 * between them except by merging.
+	 *
+	 * @pre Ranges [lo; hi) of src and dst contain the same sequence.
+	 * @return Number of inversions in the range.
+	 */
+	private: template <typename TPL_Source, typename TPL_Destination> static long long mergeSort(
+			TPL_Source src,
+			TPL_Destination dst,
+			difference_type lo,
+			difference_type hi,
+			TPL_Sorter_StrictWeakOrdering swoCompare
+	)
+	{
+		if (hi - lo <= Sorter::MERGE_SORT_RUN_LENGTH)
+		{
+			if constexpr (Sorter::IS_NETWORK_MERGE_SORT_RUN)
+			{
+				long long count = Sorter::countInversions(dst + lo, dst + hi, swoCompare);
+				sortByNetwork(dst + lo, hi - lo, swoCompare);
+				return count;
+			}
+			else
+			{
+				return Sorter::binaryInsertionSort(dst + lo, dst + hi, swoCompare);
+			}
+		}
+		
+		difference_type mid = lo + (hi - lo) / 2;
+		
+		// sort both halves into src, then merge them back into dst
+		long long count = Sorter::mergeSort(dst, src, lo, mid, swoCompare);
+		count += Sorter::mergeSort(dst, src, mid, hi, swoCompare);
+		
+		difference_type i = lo, j = mid, k = lo;
+		
+		while (i < mid && j < hi)
+		{
+			if (swoCompare(src[j], src[i]))
+			{
+				count += mid - i;
+				dst[k++] = std::move(src[j++]);
+			}
+			else
+			{
+				// on equivalence, left element goes first (stability)
+				dst[k++] = std::move(src[i++]);
+			}
+		}
+		
+		std::move(src + i, src + mid, dst + k);
+		std::move(src + j, src + hi, dst + k + (mid - i));
+		
+		return count;
+	}
+
+	private: template <typename TPL_Source, typename TPL_Destination> static void parallelMergeSort(
+			TPL_Source src,
+			TPL_Destination dst,
+			difference_type lo,
+			difference_type hi,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			ThreadPool &pool,
+			difference_type grainSize
+	)
+	{
+		if (hi - lo <= grainSize)
+		{
+			Sorter::mergeSort(src, dst, lo, hi, swoCompare);
+			return;
+		}
+		
+		difference_type mid = lo + (hi - lo) / 2;
+		
+		{
+			TaskGroup group(pool);
+			
+			group.run([src, dst, lo, mid, swoCompare, &pool, grainSize]()
+			{
+				Sorter::parallelMergeSort(dst, src, lo, mid, swoCompare, pool, grainSize);
+			});
+			
+			Sorter::parallelMergeSort(dst, src, mid, hi, swoCompare, pool, grainSize);
+			group.wait();
+		}
+		
+		Sorter::parallelMerge(src + lo, mid - lo, src + mid, hi - mid, dst + lo, swoCompare, pool, grainSize);
+	}
+
+	/**
+	 * Stable merge of sorted ranges a[0..na) and b[0..nb) into output, by
+	 * pieces of grainSize elements merged by different tasks.
+	 */
+	private: template <typename TPL_Source, typename TPL_Destination> static void parallelMerge(
+			TPL_Source a,
+			difference_type na,
+			TPL_Source b,
+			difference_type nb,
+			TPL_Destination output,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			ThreadPool &pool,
+			difference_type grainSize
+	)
+	{
+		TaskGroup group(pool);
+		
+		for (difference_type k = 0; k < na + nb; k += grainSize)
+		{
+			difference_type kEnd = std::min(k + grainSize, na + nb);
+			
+			group.run([a, na, b, nb, output, swoCompare, k, kEnd]()
+			{
+				difference_type i = Sorter::coRank(k, a, na, b, nb, swoCompare);
+				difference_type iEnd = Sorter::coRank(kEnd, a, na, b, nb, swoCompare);
+				
+				std::merge(
+						std::make_move_iterator(a + i),
+						std::make_move_iterator(a + iEnd),
+						std::make_move_iterator(b + (k - i)),
+						std::make_move_iterator(b + (kEnd - iEnd)),
+						output + k,
+						swoCompare
+				);
+			});
+		}
+		
+		group.wait();
+	}
+
+	/**
+	 * Returns number of elements of a[0..na) among the first k elements of the
+	 * stable merge of a[0..na) and b[0..nb) (equivalent elements of a go first).
+	 *
+	 * @time O(log(min(na, nb)))
+	 */
+	private: template <typename TPL_Source> static difference_type coRank(
+			difference_type k,
+			TPL_Source a,
+			difference_type na,
+			TPL_Source b,
+			difference_type nb,
+			TPL_Sorter_StrictWeakOrdering swoCompare
+	)
+	{
+		difference_type lo = std::max(k - nb, (difference_type) 0), hi = std::min(k, na);
+		
+		while (lo < hi)
+		{
+			difference_type i = lo + (hi - lo) / 2, j = k - i;
+			
+			if (!swoCompare(b[j - 1], a[i]))
+			{
+				// a[i] goes before b[j - 1], so more than i elements of a are taken
+				lo = i + 1;
+			}
+			else
+			{
+				hi = i;
+			}
+		}
+		
+		return lo;
+	}
+
+	private: static void parallelSampleSort(
+			TPL_Sorter_Iterator first,
+			TPL_Sorter_Iterator last,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			ThreadPool &pool,
+			difference_type grainSize
+	)
+	{
+		const difference_type OVERSAMPLING = 16;
+		
+		difference_type n = last - first;
+		
+		if (n <= grainSize)
+		{
+			Sorter::introSort(first, last, swoCompare, Sorter::getDepthLimit(n));
+			return;
+		}
+		
+		// choose splitters; bucket b receives elements x such that
+		// splitters[b - 1] <= x < splitters[b]
+		
+		difference_type bucketCount = std::min(std::max(n / grainSize, 4 * (difference_type) pool.getThreadCount()), (difference_type) 1024);
+		std::vector <value_type> samples;
+		std::minstd_rand random(12345);
+		std::uniform_int_distribution <difference_type> position(0, n - 1);
+		
+		for (difference_type i = 0; i < bucketCount * OVERSAMPLING; i++)
+		{
+			samples.push_back(first[position(random)]);
+		}
+		
+		std::sort(samples.begin(), samples.end(), swoCompare);
+		std::vector <value_type> splitters;
+		
+		for (difference_type b = 1; b < bucketCount; b++)
+		{
+			splitters.push_back(samples[b * OVERSAMPLING]);
+		}
+		
+		// classify the blocks, counting elements of every bucket in every block
+		
+		difference_type blockCount = (n + grainSize - 1) / grainSize;
+		std::vector <std::uint16_t> bucketIds(n);
+		std::vector <difference_type> offsets(blockCount * bucketCount);
+		
+		{
+			TaskGroup group(pool);
+			
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				group.run([&, block]()
+				{
+					difference_type *counts = &offsets[block * bucketCount];
+					
+					for (difference_type i = block * grainSize; i < std::min(n, (block + 1) * grainSize); i++)
+					{
+						difference_type bucket = std::upper_bound(splitters.begin(), splitters.end(), first[i], swoCompare) - splitters.begin();
+						bucketIds[i] = (std::uint16_t) bucket;
+						counts[bucket]++;
+					}
+				});
+			}
+			
+			group.wait();
+		}
+		
+		// counts become starting positions in the buffer: buckets one after
+		// another, within a bucket the blocks in order
+		
+		std::vector <difference_type> bucketStarts(bucketCount + 1);
+		difference_type sum = 0;
+		
+		for (difference_type bucket = 0; bucket < bucketCount; bucket++)
+		{
+			bucketStarts[bucket] = sum;
+			
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				difference_type count = offsets[block * bucketCount + bucket];
+				offsets[block * bucketCount + bucket] = sum;
+				sum += count;
+			}
+		}
+		
+		bucketStarts[bucketCount] = n;
+		std::vector <value_type> buffer(n);
+		
+		{
+			TaskGroup group(pool);
+			
+			for (difference_type block = 0; block < blockCount; block++)
+			{
+				group.run([&, block]()
+				{
+					difference_type *positions = &offsets[block * bucketCount];
+					
+					for (difference_type i = block * grainSize; i < std::min(n, (block + 1) * grainSize); i++)
+					{
+						buffer[positions[bucketIds[i]]++] = std::move(first[i]);
+					}
+				});
+			}
+			
+			group.wait();
+		}
+		
+		// sort the buckets and move them back
+		
+		{
+			TaskGroup group(pool);
+			
+			for (difference_type bucket = 0; bucket < bucketCount; bucket++)
+			{
+				group.run([&, bucket]()
+				{
+					typename std::vector <value_type> ::iterator bucketFirst = buffer.begin() + bucketStarts[bucket];
+					typename std::vector <value_type> ::iterator bucketLast = buffer.begin() + bucketStarts[bucket + 1];
+					
+					Sorter <typename std::vector <value_type> ::iterator, TPL_Sorter_StrictWeakOrdering> (bucketFirst, bucketLast, swoCompare).introSort();
+					std::move(bucketFirst, bucketLast, first + bucketStarts[bucket]);
+				});
+			}
+			
+			group.wait();
+		}
+	}
+
+	/**
+	 * Natural run found by powerSort(): range [start; start + length), and
+	 * power of the boundary with the next run.
+	 */
+	private: struct Run
+	{
+		public: difference_type start, length;
+		public: int power;
+	}
+
+	/**
+	 * Returns length of the natural run at the beginning of [first; last).
+	 * A strictly descending run is reversed (strictness keeps the sort
+	 * stable), and its inversions are added to count.
+	 */
+	private: static difference_type findRun(TPL_Sorter_Iterator first, TPL_Sorter_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare, long long &count)
+	{
+		TPL_Sorter_Iterator it = first + 1;
+		
+		if (it >= last)
+		{
+			return last - first;
+		}
+		
+		if (swoCompare(*it, *first))
+		{
+			while (++it < last && swoCompare(*it, *(it - 1)))
+			{
+				//nothing
+			}
+			
+			std::reverse(first, it);
+			count += (long long) (it - first) * (it - first - 1) / 2;
+		}
+		else
+		{
+			while (++it < last && !swoCompare(*it, *(it - 1)))
+			{
+				//nothing
+			}
+		}
+		
+		return it - first;
+	}
+
+	/**
+	 * Returns power of the boundary between runs [s1; s1 + n1) and
+	 * [s1 + n1; s1 + n1 + n2) in range [0; n): the number of the first bit
+	 * in which the binary fractions of the midpoints of the runs (relative
+	 * to n) differ.
+	 */
+	private: static int getPower(difference_type s1, difference_type n1, difference_type n2, difference_type n)
+	{
+		// doubled midpoints, so that they are integers
+		difference_type a = 2 * s1 + n1, b = a + n1 + n2;
+		int res = 0;
+		
+		while (true)
+		{
+			res++;
+			
+			if (a >= n)
+			{
+				a -= n;
+				b -= n;
+			}
+			else if (b >= n)
+			{
+				return res;
+			}
+			
+			a *= 2;
+			b *= 2;
+		}
+	}
+
+	/**
+	 * Merges the two runs on the top of the stack.
+	 *
+	 * @return Number of inversions between the runs.
+	 */
+	private: long long mergeTopRuns(std::vector <Run> &runs, value_type *buffer)
+	{
+		Run right = runs.back();
+		runs.pop_back();
+		Run &left = runs.back();
+		
+		TPL_Sorter_Iterator lo = this->first + left.start;
+		left.length += right.length;
+		left.power = right.power;
+		
+		return Sorter::mergeRuns(lo, lo + (left.length - right.length), lo + left.length, this->swoCompare, buffer);
+	}
+
+	/**
+	 * Stable in-place merge of sorted ranges [lo; mid) and [mid; hi) with a
+	 * buffer for the shorter of them.
+	 *
+	 * @param buffer Array of at least min(mid - lo, hi - mid) elements.
+	 * @return Number of inversions between the ranges.
+	 */
+	private: static long long mergeRuns(
+			TPL_Sorter_Iterator lo,
+			TPL_Sorter_Iterator mid,
+			TPL_Sorter_Iterator hi,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			value_type *buffer
+	)
+	{
+		// elements of the left run not greater than the first of the right one are in place,
+		// as are elements of the right run not less than the last of the left one
+		
+		value_type const &firstRight = *mid;
+		lo = Sorter::gallop(lo, mid, [&firstRight, &swoCompare](value_type const &x) { return !swoCompare(firstRight, x); }, false);
+		
+		if (lo == mid)
+		{
+			return 0;
+		}
+		
+		value_type const &lastLeft = *(mid - 1);
+		hi = Sorter::gallop(mid, hi, [&lastLeft, &swoCompare](value_type const &x) { return swoCompare(x, lastLeft); }, true);
+		
+		if (mid - lo <= hi - mid)
+		{
+			return Sorter::mergeLow(lo, mid, hi, swoCompare, buffer);
+		}
+		else
+		{
+			return Sorter::mergeHigh(lo, mid, hi, swoCompare, buffer);
+		}
+	}
+
+	/**
+	 * Merges [lo; mid) and [mid; hi) from the front; the left range is
+	 * moved into the buffer.
+	 */
+	private: static long long mergeLow(
+			TPL_Sorter_Iterator lo,
+			TPL_Sorter_Iterator mid,
+			TPL_Sorter_Iterator hi,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			value_type *buffer
+	)
+	{
+		value_type *i = buffer, *iEnd = std::move(lo, mid, buffer);
+		TPL_Sorter_Iterator j = mid, k = lo;
+		difference_type winsL = 0, winsR = 0;
+		long long count = 0;
+		
+		while (i < iEnd && j < hi)
+		{
+			if (swoCompare(*j, *i))
+			{
+				count += iEnd - i;
+				*k++ = std::move(*j++);
+				winsL = 0;
+				
+				if (++winsR >= Sorter::MIN_GALLOP)
+				{
+					// move all right elements less than *i at once
+					value_type const &x = *i;
+					TPL_Sorter_Iterator end = Sorter::gallop(j, hi, [&x, &swoCompare](value_type const &y) { return swoCompare(y, x); }, false);
+					
+					count += (long long) (end - j) * (iEnd - i);
+					k = std::move(j, end, k);
+					j = end;
+					winsR = 0;
+				}
+			}
+			else
+			{
+				*k++ = std::move(*i++);
+				winsR = 0;
+				
+				if (++winsL >= Sorter::MIN_GALLOP && j < hi)
+				{
+					// move all left elements not greater than *j at once
+					value_type const &y = *j;
+					value_type *end = Sorter::gallop(i, iEnd, [&y, &swoCompare](value_type const &x) { return !swoCompare(y, x); }, false);
+					
+					k = std::move(i, end, k);
+					i = end;
+					winsL = 0;
+				}
+			}
+		}
+		
+		// the rest of the right range is already in place
+		std::move(i, iEnd, k);
+		
+		return count;
+	}
+
+	/**
+	 * Merges [lo; mid) and [mid; hi) from the back; the right range is
+	 * moved into the buffer.
+	 */
+	private: static long long mergeHigh(
+			TPL_Sorter_Iterator lo,
+			TPL_Sorter_Iterator mid,
+			TPL_Sorter_Iterator hi,
+			TPL_Sorter_StrictWeakOrdering swoCompare,
+			value_type *buffer
+	)
+	{
+		// i and j point after the last unmerged elements, k after the last free position
+		
+		TPL_Sorter_Iterator i = mid, k = hi;
+		value_type *j = std::move(mid, hi, buffer);
+		difference_type winsL = 0, winsR = 0;
+		long long count = 0;
+		
+		while (i > lo && j > buffer)
+		{
+			if (swoCompare(*(j - 1), *(i - 1)))
+			{
+				count += j - buffer;
+				*--k = std::move(*--i);
+				winsR = 0;
+				
+				if (++winsL >= Sorter::MIN_GALLOP)
+				{
+					// move all left elements greater than the last right one at once
+					value_type const &y = *(j - 1);
+					TPL_Sorter_Iterator begin = Sorter::gallop(lo, i, [&y, &swoCompare](value_type const &x) { return !swoCompare(y, x); }, true);
+					
+					count += (long long) (i - begin) * (j - buffer);
+					k = std::move_backward(begin, i, k);
+					i = begin;
+					winsL = 0;
+				}
+			}
+			else
+			{
+				*--k = std::move(*--j);
+				winsL = 0;
+				
+				if (++winsR >= Sorter::MIN_GALLOP && i > lo)
+				{
+					// move all right elements not less than the last left one at once
+					value_type const &x = *(i - 1);
+					value_type *begin = Sorter::gallop(buffer, j, [&x, &swoCompare](value_type const &y) { return swoCompare(y, x); }, true);
+					
+					k = std::move_backward(begin, j, k);
+					j = begin;
+					winsR = 0;
+				}
+			}
+		}
+		
+		// the rest of the left range is already in place
+		std::move_backward(buffer, j, k);
+		
+		return count;
+	}
+
+	/**
+	 * Exponential search: returns the first element of [first; last) for
+	 * which isBefore is false, where isBefore is true on a prefix of the range.
+	 * Probes positions 1, 2, 4, ... away from the beginning (or from the end,
+	 * if the answer is expected there), then searches the bracket binarily.
+	 *
+	 * @time O(log(d)), where d is the distance of the answer from the start point
+	 */
+	private: template <typename TPL_Iterator, typename TPL_Predicate> static TPL_Iterator gallop(
+			TPL_Iterator first,
+			TPL_Iterator last,
+			TPL_Predicate isBefore,
+			bool isFromEnd
+	)
+	{
+		difference_type n = last - first, step = 1;
+		
+		if (!isFromEnd)
+		{
+			// isBefore holds on [0; lo)
+			difference_type lo = 0;
+			
+			while (step <= n && isBefore(first[step - 1]))
+			{
+				lo = step;
+				step *= 2;
+			}
+			
+			return std::partition_point(first + lo, first + std::min(step - 1, n), isBefore);
+		}
+		else
+		{
+			// isBefore doesn't hold on [hi; n)
+			difference_type hi = n;
+			
+			while (step <= n && !isBefore(first[n - step]))
+			{
+				hi = n - step;
+				step *= 2;
+			}
+			
+			return std::partition_point(first + std::max(n - step + 1, (difference_type) 0), first + hi, isBefore);
+		}
+	}
+
+	/**
+	 * Stable insertion sort which finds the place of every element by
+	 * binary search.
+	 *
+	 * @return Number of inversions in the range.
+	 * @time O(n * log(n)) comparisons, O(n ^ 2) moves
+	 */
+	private: template <typename TPL_Iterator> static long long binaryInsertionSort(TPL_Iterator first, TPL_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		long long count = 0;
+		
+		for (TPL_Iterator it = first; it < last; ++it)
+		{
+			// after all equivalent elements, to keep the sort stable
+			TPL_Iterator pos = std::upper_bound(first, it, *it, swoCompare);
+			count += it - pos;
+			std::rotate(pos, it, it + 1);
+		}
+		
+		return count;
+	}
+
+	/**
+	 * Counts inversions of a short range by comparing all pairs, without
+	 * branches.
+	 *
+	 * @time O(n ^ 2)
+	 */
+	private: template <typename TPL_Iterator> static long long countInversions(TPL_Iterator first, TPL_Iterator last, TPL_Sorter_StrictWeakOrdering swoCompare)
+	{
+		long long count = 0;
+		
+		for (TPL_Iterator i = first; i < last; ++i)
+		{
+			for (TPL_Iterator j = i + 1; j < last; ++j)
+			{
+				count += swoCompare(*j, *i);
+			}
+		}
+		
+		return count;
+	}
+}
+
+/**
+ * Returns the k least elements of [first; last) in ascending order (all
+ * elements, if there are fewer). The input is read once and only a max-heap
+ * (see heapify()) of the k least elements seen so far is kept, so the range
+ * can be a stream.
+ *
+ * @time O(n * log(k))
+ * @space O(k)
+ */
+template <typename TPL_InputIterator, typename TPL_StrictWeakOrdering>
+std::vector <typename iterator_traits <TPL_InputIterator> ::value_type> topK(
+		TPL_InputIterator first,
+		TPL_InputIterator last,
+		std::size_t k,
+		TPL_StrictWeakOrdering swoCompare
+)
+{
+	typedef typename iterator_traits <TPL_InputIterator> ::value_type value_type;
+
+
+	BOOST_CONCEPT_ASSERT((boost::InputIterator <TPL_InputIterator>));
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_StrictWeakOrdering, value_type>));
+
+
+	std::vector <value_type> heap;
+	
+	if (k == 0)
+	{
+		return heap;
+	}
+	
+	heap.reserve(k);
+	
+	for ( ; first != last && heap.size() < k; ++first)
+	{
+		heap.push_back(*first);
+	}
+	
+	for (std::size_t i = heap.size() / 2; i > 0; i--)
+	{
+		heapify(heap.begin(), heap.end(), heap.begin() + (i - 1), swoCompare);
+	}
+	
+	// replace the greatest of the k least elements with any less element
+	
+	for ( ; first != last; ++first)
+	{
+		if (swoCompare(*first, heap[0]))
+		{
+			heap[0] = *first;
+			heapify(heap.begin(), heap.end(), heap.begin(), swoCompare);
+		}
+	}
+	
+	Sorter <typename std::vector <value_type> ::iterator, TPL_StrictWeakOrdering> (heap.begin(), heap.end(), swoCompare).pdqSort();
+	
+	return heap;
+}
+
+/**
+ * Parallel version of topK() for a random access range. The range is cut
+ * into blocks of grainSize elements, topK() of every block is found by a task
+ * of the pool, and the k least elements of the results are selected by
+ * Sorter::partialSort().
+ *
+ * @time O(n * log(k)) work, O(n / p * log(k) + (n / grainSize) * k) time on p threads
+ */
+template <typename TPL_Iterator, typename TPL_StrictWeakOrdering>
+std::vector <typename iterator_traits <TPL_Iterator> ::value_type> parallelTopK(
+		TPL_Iterator first,
+		TPL_Iterator last,
+		std::size_t k,
+		TPL_StrictWeakOrdering swoCompare,
+		ThreadPool &pool,
+		std::size_t grainSize = 1 << 16
+)
+{
+	typedef typename iterator_traits <TPL_Iterator> ::value_type value_type;
+
+
+	BOOST_CONCEPT_ASSERT((boost::RandomAccessIterator <TPL_Iterator>));
+	BOOST_CONCEPT_ASSERT((StrictWeakOrdering <TPL_StrictWeakOrdering, value_type>));
+
+
+	assert(grainSize > 0);
+	
+	std::size_t n = last - first;
+	std::size_t blockSize = std::max(grainSize, k);
+	std::vector <std::vector <value_type> > results((n + blockSize - 1) / blockSize);
+	
+	{
+		TaskGroup group(pool);
+		
+		for (std::size_t i = 0; i < results.size(); i++)
+		{
+			group.run([first, n, k, blockSize, swoCompare, &results, i]()
+			{
+				results[i] = topK(first + i * blockSize, first + std::min((i + 1) * blockSize, n), k, swoCompare);
+			});
+		}
+		
+		group.wait();
+	}
+	
+	std::vector <value_type> res;
+	
+	for (std::vector <value_type> const &result : results)
+	{
+		res.insert(res.end(), result.begin(), result.end());
+	}
+	
+	std::size_t count = std::min(k, res.size());
+	Sorter <typename std::vector <value_type> ::iterator, TPL_StrictWeakOrdering> (res.begin(), res.end(), swoCompare).partialSort(count);
+	res.resize(count);
+	
+	return res;
 }
 
 
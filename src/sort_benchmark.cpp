@@ -0,0 +1,207 @@
+#include <eugenejonas/cpp_stuff/radix_sort.h>
+#include <eugenejonas/cpp_stuff/sort.h>
+#include <eugenejonas/cpp_stuff/sorting_network.h>
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+using eugenejonas::cpp_stuff::IdentityKey;
+using eugenejonas::cpp_stuff::Sorter;
+using eugenejonas::cpp_stuff::ThreadPool;
+using eugenejonas::cpp_stuff::lsdRadixSort;
+using eugenejonas::cpp_stuff::sortByNetwork;
+
+using std::cout;
+using std::string;
+using std::vector;
+
+
+typedef std::chrono::steady_clock Clock;
+typedef Sorter <vector <int> ::iterator, std::less <int> > IntSorter;
+
+
+double getMillisecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration <double, std::milli> (Clock::now() - start).count();
+}
+
+vector <int> createInput(string const &kind, int n)
+{
+	vector <int> res(n);
+	std::srand(12345);
+	
+	for (int i = 0; i < n; i++)
+	{
+		if (kind == "random")
+		{
+			res[i] = std::rand();
+		}
+		else if (kind == "few unique")
+		{
+			res[i] = std::rand() % 16;
+		}
+		else if (kind == "sorted")
+		{
+			res[i] = i;
+		}
+		else if (kind == "sorted runs")
+		{
+			// 32 ascending runs with interleaved values
+			res[i] = i % (n / 32) * 32 + i / (n / 32);
+		}
+		else if (kind == "reversed")
+		{
+			res[i] = n - i;
+		}
+		else
+		{
+			// organ pipe
+			res[i] = std::min(i, n - i);
+		}
+	}
+	
+	return res;
+}
+
+/**
+ * Sorts a copy of the input and prints the time.
+ */
+template <typename TPL_Sort> void run(string const &name, vector <int> const &input, TPL_Sort sort)
+{
+	vector <int> v = input;
+	Clock::time_point start = Clock::now();
+	sort(v);
+	double ms = getMillisecondsSince(start);
+	
+	cout << "\t" << name << ": " << ms << " ms" << (std::is_sorted(v.begin(), v.end()) ? "" : " NOT SORTED") << "\n";
+}
+
+/**
+ * Sorts every block of size elements of a copy of the input and prints the time.
+ */
+template <typename TPL_Sort> void runShort(string const &name, vector <int> const &input, int size, TPL_Sort sort)
+{
+	vector <int> v = input;
+	Clock::time_point start = Clock::now();
+	
+	for (std::size_t i = 0; i < v.size(); i += size)
+	{
+		sort(v.begin() + i, size);
+	}
+	
+	double ms = getMillisecondsSince(start);
+	bool isSorted = true;
+	
+	for (std::size_t i = 0; i < v.size(); i += size)
+	{
+		isSorted = isSorted && std::is_sorted(v.begin() + i, v.begin() + i + size);
+	}
+	
+	cout << "\t" << name << ": " << ms << " ms" << (isSorted ? "" : " NOT SORTED") << "\n";
+}
+
+
+/**
+ * This program compares speed of Sorter algorithms with std::sort
+ * on the same comparator (std::less <int>) and different kinds of input.
+ * Parallel algorithms use all hardware threads. Then it sorts many short
+ * arrays, where sorting networks replace insertion sort.
+ */
+int main()
+{
+	const int n = 5000000;
+	const char *kinds[] = {"random", "few unique", "sorted", "sorted runs", "reversed", "organ pipe"};
+	ThreadPool pool;
+	
+	
+	
+	for (const char *kind : kinds)
+	{
+		vector <int> input = createInput(kind, n);
+		cout << kind << " (" << n << " elements):\n";
+		
+		run("std::sort", input, [](vector <int> &v)
+		{
+			std::sort(v.begin(), v.end(), std::less <int> ());
+		});
+		
+		run("Sorter::introSort", input, [](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).introSort();
+		});
+		
+		run("Sorter::pdqSort", input, [](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).pdqSort();
+		});
+		
+		run("Sorter::heapSort", input, [](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).heapSort();
+		});
+		
+		run("std::stable_sort", input, [](vector <int> &v)
+		{
+			std::stable_sort(v.begin(), v.end(), std::less <int> ());
+		});
+		
+		run("Sorter::mergeSort", input, [](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).mergeSort();
+		});
+		
+		run("Sorter::powerSort", input, [](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).powerSort();
+		});
+		
+		run("Sorter::parallelMergeSort", input, [&pool](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).parallelMergeSort(pool);
+		});
+		
+		run("Sorter::parallelSampleSort", input, [&pool](vector <int> &v)
+		{
+			IntSorter(v.begin(), v.end()).parallelSampleSort(pool);
+		});
+		
+		run("lsdRadixSort", input, [](vector <int> &v)
+		{
+			lsdRadixSort(v.begin(), v.end());
+		});
+		
+		run("lsdRadixSort (parallel)", input, [&pool](vector <int> &v)
+		{
+			lsdRadixSort(v.begin(), v.end(), IdentityKey(), pool);
+		});
+	}
+
+	
+	
+	for (int size : {4, 8, 16, 32})
+	{
+		vector <int> input = createInput("random", n - n % size);
+		cout << "short arrays of " << size << " elements:\n";
+		
+		runShort("std::sort", input, size, [](vector <int> ::iterator first, int size)
+		{
+			std::sort(first, first + size, std::less <int> ());
+		});
+		
+		runShort("sortByNetwork", input, size, [](vector <int> ::iterator first, int size)
+		{
+			sortByNetwork(first, size, std::less <int> ());
+		});
+	}
+	
+	
+	
+	return 0;
+}
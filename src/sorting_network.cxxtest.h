@@ -0,0 +1,218 @@
+#include <eugenejonas/cpp_stuff/sort.h>
+#include <eugenejonas/cpp_stuff/sorting_network.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+using std::string;
+using std::vector;
+
+
+class UnitTest_SortingNetwork: public CxxTest::TestSuite
+{
+	/**
+	 * By the 0-1 principle, a network sorts every input iff it sorts
+	 * every sequence of zeros and ones.
+	 */
+	private: template <std::size_t TPL_N> static void checkAllBinaryInputs()
+	{
+		for (unsigned long bits = 0; bits < (1ul << TPL_N); bits++)
+		{
+			int a[TPL_N + 1];
+
+			for (std::size_t i = 0; i < TPL_N; i++)
+			{
+				a[i] = (bits >> i) & 1;
+			}
+
+			SortingNetwork <TPL_N> ::sort(a, std::less <int> ());
+
+			TS_ASSERT(std::is_sorted(a, a + TPL_N));
+		}
+	}
+
+	private: template <std::size_t... TPL_Ns> static void checkAllBinaryInputs(std::index_sequence <TPL_Ns...>)
+	{
+		(checkAllBinaryInputs <TPL_Ns> (), ...);
+	}
+
+	/**
+	 * Sorts random sequences of every length up to 32 by sortByNetwork()
+	 * and compares the result with std::sort().
+	 */
+	private: template <typename TPL_T, typename TPL_Generator> static void checkRandomInputs(TPL_Generator generate)
+	{
+		std::srand(1);
+
+		for (std::size_t n = 0; n <= 32; n++)
+		{
+			for (int attempt = 0; attempt < 50; attempt++)
+			{
+				vector <TPL_T> v(n);
+
+				for (std::size_t i = 0; i < n; i++)
+				{
+					v[i] = generate();
+				}
+
+				vector <TPL_T> expected = v;
+				std::sort(expected.begin(), expected.end());
+
+				sortByNetwork(v.begin(), n, std::less <TPL_T> ());
+
+				TS_ASSERT_EQUALS(expected, v);
+			}
+		}
+	}
+
+	public: void test_comparator_counts()
+	{
+		// Batcher's odd-even merge sort network sizes
+		TS_ASSERT_EQUALS(0u, SortingNetwork <1> ::COMPARATOR_COUNT);
+		TS_ASSERT_EQUALS(1u, SortingNetwork <2> ::COMPARATOR_COUNT);
+		TS_ASSERT_EQUALS(5u, SortingNetwork <4> ::COMPARATOR_COUNT);
+		TS_ASSERT_EQUALS(19u, SortingNetwork <8> ::COMPARATOR_COUNT);
+		TS_ASSERT_EQUALS(63u, SortingNetwork <16> ::COMPARATOR_COUNT);
+		TS_ASSERT_EQUALS(191u, SortingNetwork <32> ::COMPARATOR_COUNT);
+	}
+
+	public: void test_zero_one_principle()
+	{
+		checkAllBinaryInputs(std::make_index_sequence <17> ());
+	}
+
+	public: void test_int32()
+	{
+		checkRandomInputs <std::int32_t> ([]() { return (std::int32_t) (std::rand() % 64 - 32); });
+		checkRandomInputs <std::int32_t> ([]() { return (std::int32_t) std::rand() * (std::rand() % 2 == 0 ? 1 : -1); });
+	}
+
+	public: void test_float()
+	{
+		checkRandomInputs <float> ([]() { return (float) (std::rand() % 1000) / 7 - 50; });
+	}
+
+	public: void test_other_types()
+	{
+		checkRandomInputs <long long> ([]() { return (long long) std::rand() * std::rand() - (1ll << 40); });
+		checkRandomInputs <string> ([]() { return string(1 + std::rand() % 3, (char) ('a' + std::rand() % 5)); });
+	}
+
+	public: void test_descending_order()
+	{
+		vector <int> v;
+
+		for (int i = 0; i < 27; i++)
+		{
+			v.push_back((i * 11) % 27);
+		}
+
+		sortByNetwork(v.begin(), v.size(), std::greater <int> ());
+
+		TS_ASSERT(std::is_sorted(v.begin(), v.end(), std::greater <int> ()));
+	}
+
+	/**
+	 * Runs every stage of the AVX2 bitonic kernel, blend masks of which
+	 * must be immediates also when the tests are built with -O0 -mavx2.
+	 */
+	public: void test_Avx2BitonicKernel()
+	{
+		#if !defined(__AVX512F__) && defined(__AVX2__)
+		std::srand(4);
+
+		for (std::size_t n = 0; n <= 32; n++)
+		{
+			vector <std::int32_t> a(n);
+			vector <float> b(n);
+
+			for (std::size_t i = 0; i < n; i++)
+			{
+				a[i] = std::rand() % 100 - 50;
+				b[i] = (float) (std::rand() % 100) / 3;
+			}
+
+			vector <std::int32_t> expectedA = a;
+			std::sort(expectedA.begin(), expectedA.end());
+			vector <float> expectedB = b;
+			std::sort(expectedB.begin(), expectedB.end());
+
+			BitonicKernel <Avx2Int32Traits> ::sort(a.data(), n);
+			BitonicKernel <Avx2FloatTraits> ::sort(b.data(), n);
+
+			TS_ASSERT_EQUALS(expectedA, a);
+			TS_ASSERT_EQUALS(expectedB, b);
+		}
+		#endif
+	}
+
+	public: void test_Sorter_networkSort()
+	{
+		std::srand(2);
+
+		for (int n : {0, 1, 5, 17, 32, 33, 1000})
+		{
+			vector <int> v(n);
+
+			for (int i = 0; i < n; i++)
+			{
+				v[i] = std::rand() % 100;
+			}
+
+			vector <int> expected = v;
+			std::sort(expected.begin(), expected.end());
+
+			Sorter <vector <int> ::iterator, std::less <int> > (v.begin(), v.end()).networkSort();
+
+			TS_ASSERT_EQUALS(expected, v);
+		}
+	}
+
+	/**
+	 * Runs of integers are sorted by networks in mergeSort(), and their
+	 * inversions are counted separately.
+	 */
+	public: void test_Sorter_mergeSort_counts_inversions_of_network_runs()
+	{
+		vector <int> v(1000);
+		std::srand(3);
+
+		for (std::size_t i = 0; i < v.size(); i++)
+		{
+			v[i] = std::rand() % 50;
+		}
+
+		long long expectedCount = 0;
+
+		for (std::size_t i = 0; i < v.size(); i++)
+		{
+			for (std::size_t j = i + 1; j < v.size(); j++)
+			{
+				expectedCount += v[j] < v[i];
+			}
+		}
+
+		vector <int> expected = v;
+		std::sort(expected.begin(), expected.end());
+
+		long long count = Sorter <vector <int> ::iterator, std::less <int> > (v.begin(), v.end()).mergeSort();
+
+		TS_ASSERT_EQUALS(expectedCount, count);
+		TS_ASSERT_EQUALS(expected, v);
+	}
+}
+
+
+}
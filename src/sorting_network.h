@@ -0,0 +1,628 @@
+#ifndef EUGENEJONAS__CPP_STUFF__SORTING_NETWORK_H
+#define EUGENEJONAS__CPP_STUFF__SORTING_NETWORK_H
+
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Compare-exchange of elements *a and *b: after it, !swoCompare(*b, *a).
+ * For arithmetic types and pointers it is branchless (conditional moves).
+ */
+template <typename TPL_Iterator, typename TPL_StrictWeakOrdering> void compareExchange(TPL_Iterator a, TPL_Iterator b, TPL_StrictWeakOrdering &swoCompare)
+{
+	typedef typename std::iterator_traits <TPL_Iterator> ::value_type value_type;
+
+	if constexpr (std::is_arithmetic <value_type> ::value || std::is_pointer <value_type> ::value)
+	{
+		value_type x = *a, y = *b;
+		bool isSwapped = swoCompare(y, x);
+		*a = isSwapped ? y : x;
+		*b = isSwapped ? x : y;
+	}
+	else
+	{
+		if (swoCompare(*b, *a))
+		{
+			std::iter_swap(a, b);
+		}
+	}
+}
+
+struct SortingNetworkComparator
+{
+	public: std::uint8_t i, j;
+}
+
+/**
+ * Calls f(i, j) for every comparator of Batcher's odd-even merge sort
+ * network for n elements, in order. The network for the next power of two
+ * is generated; comparators which touch positions >= n are dropped
+ * (as if those positions held +infinity).
+ */
+template <typename TPL_Function> constexpr void forEachSortingNetworkComparator(std::size_t n, TPL_Function f)
+{
+	std::size_t size = 1;
+
+	while (size < n)
+	{
+		size *= 2;
+	}
+
+	for (std::size_t p = 1; p < size; p *= 2)
+	{
+		for (std::size_t k = p; k >= 1; k /= 2)
+		{
+			for (std::size_t j = k % p; j + k < size; j += 2 * k)
+			{
+				for (std::size_t i = 0; i < k && i + j + k < size; i++)
+				{
+					if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n)
+					{
+						f(i + j, i + j + k);
+					}
+				}
+			}
+		}
+	}
+}
+
+constexpr std::size_t getSortingNetworkComparatorCount(std::size_t n)
+{
+	std::size_t count = 0;
+	forEachSortingNetworkComparator(n, [&count](std::size_t, std::size_t) { count++; });
+	return count;
+}
+
+template <std::size_t TPL_N> constexpr std::array <SortingNetworkComparator, getSortingNetworkComparatorCount(TPL_N)> getSortingNetworkComparators()
+{
+	std::array <SortingNetworkComparator, getSortingNetworkComparatorCount(TPL_N)> res = {};
+	std::size_t count = 0;
+
+	forEachSortingNetworkComparator(TPL_N, [&res, &count](std::size_t i, std::size_t j)
+	{
+		res[count].i = (std::uint8_t) i;
+		res[count].j = (std::uint8_t) j;
+		count++;
+	});
+
+	return res;
+}
+
+/**
+ * Sorting network for N elements (Batcher's odd-even merge sort), generated
+ * at compile time and fully unrolled. Sorting networks are not stable.
+ *
+ * @param TPL_SortingNetwork_N 32 >= N >= 0.
+ */
+template <std::size_t TPL_SortingNetwork_N> class SortingNetwork
+{
+	static_assert(TPL_SortingNetwork_N <= 32, "sorting networks are generated for up to 32 elements");
+
+
+	public: static constexpr std::size_t COMPARATOR_COUNT = getSortingNetworkComparatorCount(TPL_SortingNetwork_N);
+
+	public: static constexpr std::array <SortingNetworkComparator, COMPARATOR_COUNT> COMPARATORS = getSortingNetworkComparators <TPL_SortingNetwork_N> ();
+
+
+	/**
+	 * Sorts range [first; first + N).
+	 */
+	public: template <typename TPL_Iterator, typename TPL_StrictWeakOrdering> static void sort(TPL_Iterator first, TPL_StrictWeakOrdering swoCompare)
+	{
+		SortingNetwork::apply(first, swoCompare, std::make_index_sequence <COMPARATOR_COUNT> ());
+	}
+
+	private: template <typename TPL_Iterator, typename TPL_StrictWeakOrdering, std::size_t... TPL_Indexes> static void apply(
+			TPL_Iterator first,
+			TPL_StrictWeakOrdering &swoCompare,
+			std::index_sequence <TPL_Indexes...>
+	)
+	{
+		// the fold is empty for networks of less than 2 elements
+		(void) first;
+		(void) swoCompare;
+
+		(compareExchange(first + COMPARATORS[TPL_Indexes].i, first + COMPARATORS[TPL_Indexes].j, swoCompare), ...);
+	}
+}
+
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+
+/**
+ * Bitonic sort of up to 32 int32 or float values in vector registers.
+ * Every register holds LANES values; compare-exchange of lanes at
+ * distance j within a register is done by permutation, min, max and blend.
+ * Values are loaded and stored by masked operations, missing lanes are
+ * padded with the maximum.
+ *
+ * NaNs are not supported.
+ *
+ * @param TPL_BitonicKernel_Traits Vector operations: one of the
+ *		Avx512Int32Traits, Avx512FloatTraits, Avx2Int32Traits, Avx2FloatTraits.
+ */
+template <typename TPL_BitonicKernel_Traits> class BitonicKernel
+{
+	private: typedef typename TPL_BitonicKernel_Traits::value_type value_type;
+	private: typedef typename TPL_BitonicKernel_Traits::vector_type vector_type;
+
+
+	private: static const int LANES = TPL_BitonicKernel_Traits::LANES;
+
+
+	/**
+	 * @param n 32 >= n >= 0.
+	 */
+	public: static void sort(value_type *data, std::size_t n)
+	{
+		assert(n <= 32);
+
+		int registerCount = ((int) n + LANES - 1) / LANES;
+
+		if (registerCount == 3)
+		{
+			registerCount = 4;
+		}
+
+		vector_type r[4];
+
+		for (int k = 0; k < registerCount; k++)
+		{
+			r[k] = BitonicKernel::sortRegister(TPL_BitonicKernel_Traits::load(data + k * LANES, BitonicKernel::getLaneCount(n, k)));
+		}
+
+		if (registerCount >= 2)
+		{
+			BitonicKernel::mergeRegisters(r[0], r[1]);
+		}
+
+		if (registerCount == 4)
+		{
+			BitonicKernel::mergeRegisters(r[2], r[3]);
+
+			// half-cleaner at distance 2 * LANES on sequence (r0 r1 reverse(r3) reverse(r2))
+			vector_type b0 = TPL_BitonicKernel_Traits::reverse(r[3]);
+			vector_type b1 = TPL_BitonicKernel_Traits::reverse(r[2]);
+			vector_type lo0 = TPL_BitonicKernel_Traits::min(r[0], b0), hi0 = TPL_BitonicKernel_Traits::max(r[0], b0);
+			vector_type lo1 = TPL_BitonicKernel_Traits::min(r[1], b1), hi1 = TPL_BitonicKernel_Traits::max(r[1], b1);
+
+			r[0] = TPL_BitonicKernel_Traits::min(lo0, lo1);
+			r[1] = TPL_BitonicKernel_Traits::max(lo0, lo1);
+			r[2] = TPL_BitonicKernel_Traits::min(hi0, hi1);
+			r[3] = TPL_BitonicKernel_Traits::max(hi0, hi1);
+
+			for (int k = 0; k < 4; k++)
+			{
+				r[k] = BitonicKernel::cleanRegister(r[k]);
+			}
+		}
+
+		for (int k = 0; k < registerCount; k++)
+		{
+			TPL_BitonicKernel_Traits::store(data + k * LANES, r[k], BitonicKernel::getLaneCount(n, k));
+		}
+	}
+
+	/**
+	 * Returns number of values of data[0..n) which belong to register k.
+	 */
+	private: static int getLaneCount(std::size_t n, int k)
+	{
+		return std::clamp((int) n - k * LANES, 0, (int) LANES);
+	}
+
+	/**
+	 * Merges two sorted registers into sorted sequence (a b).
+	 */
+	private: static void mergeRegisters(vector_type &a, vector_type &b)
+	{
+		vector_type reversed = TPL_BitonicKernel_Traits::reverse(b);
+		vector_type lo = TPL_BitonicKernel_Traits::min(a, reversed);
+		vector_type hi = TPL_BitonicKernel_Traits::max(a, reversed);
+
+		a = BitonicKernel::cleanRegister(lo);
+		b = BitonicKernel::cleanRegister(hi);
+	}
+
+	/**
+	 * Sorts values of a register in ascending order.
+	 */
+	private: static vector_type sortRegister(vector_type v)
+	{
+		v = TPL_BitonicKernel_Traits::template exchange <2, 1> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <4, 2> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <4, 1> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <8, 4> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <8, 2> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <8, 1> (v);
+
+		if constexpr (LANES == 16)
+		{
+			v = TPL_BitonicKernel_Traits::template exchange <16, 8> (v);
+			v = BitonicKernel::cleanRegisterHalves(v);
+		}
+
+		return v;
+	}
+
+	/**
+	 * Sorts bitonic sequence of values of a register in ascending order.
+	 */
+	private: static vector_type cleanRegister(vector_type v)
+	{
+		if constexpr (LANES == 16)
+		{
+			v = TPL_BitonicKernel_Traits::template exchange <LANES, 8> (v);
+		}
+
+		return BitonicKernel::cleanRegisterHalves(v);
+	}
+
+	private: static vector_type cleanRegisterHalves(vector_type v)
+	{
+		v = TPL_BitonicKernel_Traits::template exchange <LANES, 4> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <LANES, 2> (v);
+		v = TPL_BitonicKernel_Traits::template exchange <LANES, 1> (v);
+		return v;
+	}
+}
+
+/**
+ * Returns blend mask of a bitonic sort stage: bit i is set if lane i
+ * receives the maximum of itself and lane i ^ j. Blocks of size k are
+ * sorted in alternating directions.
+ */
+constexpr unsigned getBitonicMaxMask(int k, int j, int lanes)
+{
+	unsigned mask = 0;
+
+	for (int i = 0; i < lanes; i++)
+	{
+		if (((i & j) != 0) != ((i & k) != 0))
+		{
+			mask |= 1u << i;
+		}
+	}
+
+	return mask;
+}
+
+#endif
+
+
+#if defined(__AVX512F__)
+
+struct Avx512Int32Traits
+{
+	public: typedef std::int32_t value_type;
+	public: typedef __m512i vector_type;
+
+
+	public: static const int LANES = 16;
+
+
+	public: static value_type getPadding()
+	{
+		return std::numeric_limits <value_type> ::max();
+	}
+
+	/**
+	 * Loads count values, the remaining lanes receive the padding.
+	 */
+	public: static vector_type load(const value_type *p, int count)
+	{
+		return _mm512_mask_loadu_epi32(_mm512_set1_epi32(Avx512Int32Traits::getPadding()), (__mmask16) ((1u << count) - 1), p);
+	}
+
+	public: static void store(value_type *p, vector_type v, int count)
+	{
+		_mm512_mask_storeu_epi32(p, (__mmask16) ((1u << count) - 1), v);
+	}
+
+	public: static vector_type min(vector_type a, vector_type b)
+	{
+		return _mm512_min_epi32(a, b);
+	}
+
+	public: static vector_type max(vector_type a, vector_type b)
+	{
+		return _mm512_max_epi32(a, b);
+	}
+
+	public: static vector_type reverse(vector_type v)
+	{
+		return _mm512_permutexvar_epi32(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), v);
+	}
+
+	public: template <int TPL_K, int TPL_J> static vector_type exchange(vector_type v)
+	{
+		const __m512i partners = _mm512_xor_si512(
+				_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+				_mm512_set1_epi32(TPL_J)
+		);
+		vector_type p = _mm512_permutexvar_epi32(partners, v);
+		return _mm512_mask_blend_epi32((__mmask16) getBitonicMaxMask(TPL_K, TPL_J, LANES), _mm512_min_epi32(v, p), _mm512_max_epi32(v, p));
+	}
+}
+
+struct Avx512FloatTraits
+{
+	public: typedef float value_type;
+	public: typedef __m512 vector_type;
+
+
+	public: static const int LANES = 16;
+
+
+	public: static value_type getPadding()
+	{
+		return std::numeric_limits <value_type> ::infinity();
+	}
+
+	public: static vector_type load(const value_type *p, int count)
+	{
+		return _mm512_mask_loadu_ps(_mm512_set1_ps(Avx512FloatTraits::getPadding()), (__mmask16) ((1u << count) - 1), p);
+	}
+
+	public: static void store(value_type *p, vector_type v, int count)
+	{
+		_mm512_mask_storeu_ps(p, (__mmask16) ((1u << count) - 1), v);
+	}
+
+	public: static vector_type min(vector_type a, vector_type b)
+	{
+		return _mm512_min_ps(a, b);
+	}
+
+	public: static vector_type max(vector_type a, vector_type b)
+	{
+		return _mm512_max_ps(a, b);
+	}
+
+	public: static vector_type reverse(vector_type v)
+	{
+		return _mm512_permutexvar_ps(_mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0), v);
+	}
+
+	public: template <int TPL_K, int TPL_J> static vector_type exchange(vector_type v)
+	{
+		const __m512i partners = _mm512_xor_si512(
+				_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+				_mm512_set1_epi32(TPL_J)
+		);
+		vector_type p = _mm512_permutexvar_ps(partners, v);
+		return _mm512_mask_blend_ps((__mmask16) getBitonicMaxMask(TPL_K, TPL_J, LANES), _mm512_min_ps(v, p), _mm512_max_ps(v, p));
+	}
+}
+
+typedef Avx512Int32Traits BitonicInt32Traits;
+typedef Avx512FloatTraits BitonicFloatTraits;
+
+#elif defined(__AVX2__)
+
+struct Avx2Int32Traits
+{
+	public: typedef std::int32_t value_type;
+	public: typedef __m256i vector_type;
+
+
+	public: static const int LANES = 8;
+
+
+	public: static value_type getPadding()
+	{
+		return std::numeric_limits <value_type> ::max();
+	}
+
+	/**
+	 * Returns mask of the first count lanes.
+	 */
+	public: static __m256i getMask(int count)
+	{
+		return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	}
+
+	/**
+	 * Loads count values, the remaining lanes receive the padding.
+	 */
+	public: static vector_type load(const value_type *p, int count)
+	{
+		__m256i mask = Avx2Int32Traits::getMask(count);
+		return _mm256_blendv_epi8(_mm256_set1_epi32(Avx2Int32Traits::getPadding()), _mm256_maskload_epi32(p, mask), mask);
+	}
+
+	public: static void store(value_type *p, vector_type v, int count)
+	{
+		_mm256_maskstore_epi32(p, Avx2Int32Traits::getMask(count), v);
+	}
+
+	public: static vector_type min(vector_type a, vector_type b)
+	{
+		return _mm256_min_epi32(a, b);
+	}
+
+	public: static vector_type max(vector_type a, vector_type b)
+	{
+		return _mm256_max_epi32(a, b);
+	}
+
+	public: static vector_type reverse(vector_type v)
+	{
+		return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	}
+
+	public: template <int TPL_K, int TPL_J> static vector_type exchange(vector_type v)
+	{
+		const __m256i partners = _mm256_setr_epi32(0 ^ TPL_J, 1 ^ TPL_J, 2 ^ TPL_J, 3 ^ TPL_J, 4 ^ TPL_J, 5 ^ TPL_J, 6 ^ TPL_J, 7 ^ TPL_J);
+		vector_type p = _mm256_permutevar8x32_epi32(v, partners);
+		// blend needs an immediate, which a call expression is not at -O0
+		constexpr int MASK = getBitonicMaxMask(TPL_K, TPL_J, LANES);
+
+		return _mm256_blend_epi32(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), MASK);
+	}
+}
+
+struct Avx2FloatTraits
+{
+	public: typedef float value_type;
+	public: typedef __m256 vector_type;
+
+
+	public: static const int LANES = 8;
+
+
+	public: static value_type getPadding()
+	{
+		return std::numeric_limits <value_type> ::infinity();
+	}
+
+	public: static vector_type load(const value_type *p, int count)
+	{
+		__m256i mask = Avx2Int32Traits::getMask(count);
+		return _mm256_blendv_ps(_mm256_set1_ps(Avx2FloatTraits::getPadding()), _mm256_maskload_ps(p, mask), _mm256_castsi256_ps(mask));
+	}
+
+	public: static void store(value_type *p, vector_type v, int count)
+	{
+		_mm256_maskstore_ps(p, Avx2Int32Traits::getMask(count), v);
+	}
+
+	public: static vector_type min(vector_type a, vector_type b)
+	{
+		return _mm256_min_ps(a, b);
+	}
+
+	public: static vector_type max(vector_type a, vector_type b)
+	{
+		return _mm256_max_ps(a, b);
+	}
+
+	public: static vector_type reverse(vector_type v)
+	{
+		return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+	}
+
+	public: template <int TPL_K, int TPL_J> static vector_type exchange(vector_type v)
+	{
+		const __m256i partners = _mm256_setr_epi32(0 ^ TPL_J, 1 ^ TPL_J, 2 ^ TPL_J, 3 ^ TPL_J, 4 ^ TPL_J, 5 ^ TPL_J, 6 ^ TPL_J, 7 ^ TPL_J);
+		vector_type p = _mm256_permutevar8x32_ps(v, partners);
+		// blend needs an immediate, which a call expression is not at -O0
+		constexpr int MASK = getBitonicMaxMask(TPL_K, TPL_J, LANES);
+
+		return _mm256_blend_ps(_mm256_min_ps(v, p), _mm256_max_ps(v, p), MASK);
+	}
+}
+
+typedef Avx2Int32Traits BitonicInt32Traits;
+typedef Avx2FloatTraits BitonicFloatTraits;
+
+#endif
+
+
+/**
+ * Sorts range [first; first + n) of at most 32 elements with a sorting network.
+ * If AVX2 or AVX-512 is enabled at compile time, contiguous ranges of int32
+ * or float ordered by std::less which fill more than half of a vector register
+ * are sorted by bitonic sort in vector registers; otherwise the scalar network
+ * for n elements is used.
+ *
+ * Sorting networks are not stable.
+ *
+ * @param n 32 >= n >= 0.
+ */
+template <typename TPL_Iterator, typename TPL_StrictWeakOrdering> void sortByNetwork(TPL_Iterator first, std::size_t n, TPL_StrictWeakOrdering swoCompare)
+{
+	typedef void (*SortFunction)(TPL_Iterator first, TPL_StrictWeakOrdering swoCompare);
+
+
+	assert(n <= 32);
+
+	#if defined(__AVX512F__) || defined(__AVX2__)
+	typedef typename std::iterator_traits <TPL_Iterator> ::value_type value_type;
+
+	// a vector register less than half full is slower than the scalar network
+	if constexpr (std::contiguous_iterator <TPL_Iterator> && std::is_same <TPL_StrictWeakOrdering, std::less <value_type> > ::value)
+	{
+		if constexpr (std::is_same <value_type, std::int32_t> ::value)
+		{
+			if (n > BitonicInt32Traits::LANES / 2)
+			{
+				BitonicKernel <BitonicInt32Traits> ::sort(std::to_address(first), n);
+				return;
+			}
+		}
+		else if constexpr (std::is_same <value_type, float> ::value)
+		{
+			if (n > BitonicFloatTraits::LANES / 2)
+			{
+				BitonicKernel <BitonicFloatTraits> ::sort(std::to_address(first), n);
+				return;
+			}
+		}
+	}
+	#endif
+
+	static const SortFunction functions[] =
+	{
+		&SortingNetwork <0> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <1> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <2> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <3> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <4> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <5> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <6> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <7> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <8> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <9> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <10> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <11> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <12> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <13> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <14> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <15> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <16> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <17> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <18> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <19> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <20> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <21> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <22> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <23> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <24> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <25> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <26> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <27> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <28> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <29> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <30> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <31> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>,
+		&SortingNetwork <32> ::template sort <TPL_Iterator, TPL_StrictWeakOrdering>
+	};
+
+	functions[n](first, swoCompare);
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,81 @@
+#include <eugenejonas/cpp_stuff/thread_pool.h>
+
+#include <atomic>
+
+#include <cxxtest/TestSuite.h>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Recursively sums range [first; last) of integers using nested task groups.
+ */
+long long sumRecursively(ThreadPool &pool, long long first, long long last)
+{
+	if (last - first <= 1000)
+	{
+		long long res = 0;
+		
+		for (long long i = first; i < last; i++)
+		{
+			res += i;
+		}
+		
+		return res;
+	}
+	
+	long long middle = first + (last - first) / 2, left, right;
+	TaskGroup group(pool);
+	
+	group.run([&pool, &left, first, middle]()
+	{
+		left = sumRecursively(pool, first, middle);
+	});
+	
+	right = sumRecursively(pool, middle, last);
+	group.wait();
+	
+	return left + right;
+}
+
+class UnitTest_ThreadPool: public CxxTest::TestSuite
+{
+	public: void test_independent_tasks()
+	{
+		ThreadPool pool(4);
+		std::atomic <int> count(0);
+		
+		{
+			TaskGroup group(pool);
+			
+			for (int i = 0; i < 1000; i++)
+			{
+				group.run([&count]()
+				{
+					count++;
+				});
+			}
+		}
+		
+		TS_ASSERT_EQUALS(1000, count.load());
+	}
+	
+	public: void test_nested_groups()
+	{
+		ThreadPool pool(3);
+		TS_ASSERT_EQUALS(49999995000000LL, sumRecursively(pool, 0, 10000000));
+	}
+	
+	public: void test_single_thread()
+	{
+		ThreadPool pool(1);
+		TS_ASSERT_EQUALS(1u, pool.getThreadCount());
+		TS_ASSERT_EQUALS(499500LL, sumRecursively(pool, 0, 1000));
+		TS_ASSERT_EQUALS(49995000LL, sumRecursively(pool, 0, 10000));
+	}
+}
+
+
+}
@@ -0,0 +1,314 @@
+#ifndef EUGENEJONAS__CPP_STUFF__THREAD_POOL_H
+#define EUGENEJONAS__CPP_STUFF__THREAD_POOL_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace eugenejonas::cpp_stuff
+{
+
+
+/**
+ * Fixed-size pool of worker threads with work stealing.
+ *
+ * Every worker has its own task queue. Tasks submitted from a worker thread
+ * go to that worker's queue and are taken from its back (LIFO), which suits
+ * fork-join (divide and conquer) workloads. Tasks submitted from other threads
+ * are distributed between the queues round-robin. An idle worker steals
+ * from the front (FIFO) of the other queues.
+ *
+ * Tasks must not throw exceptions.
+ */
+class ThreadPool
+{
+	private: struct WorkQueue
+	{
+		public: std::mutex mutex;
+		public: std::deque <std::function <void()> > tasks;
+	}
+
+	/**
+	 * Identifies the pool and the queue of the worker running in the current thread.
+	 */
+	private: struct WorkerId
+	{
+		public: ThreadPool const *pool;
+		public: std::size_t index;
+	}
+
+
+	private: std::vector <std::unique_ptr <WorkQueue> > queues;
+	private: std::vector <std::thread> threads;
+
+	/**
+	 * Number of tasks which are in the queues (submitted, but not yet started).
+	 */
+	private: std::atomic <std::size_t> queuedCount;
+
+	private: std::atomic <std::size_t> nextQueue;
+	private: std::mutex sleepMutex;
+	private: std::condition_variable sleepCondition;
+	private: bool isStopping;
+
+
+	/**
+	 * Starts the worker threads.
+	 *
+	 * @param threadCount Number of worker threads. If 0, number of
+	 *		hardware threads is used.
+	 */
+	public: ThreadPool(unsigned threadCount = 0):
+			queuedCount(0),
+			nextQueue(0),
+			isStopping(false)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			this->queues.push_back(std::unique_ptr <WorkQueue> (new WorkQueue()));
+		}
+
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			this->threads.push_back(std::thread(&ThreadPool::work, this, (std::size_t) i));
+		}
+	}
+
+	/**
+	 * Waits until all submitted tasks are completed and stops the worker threads.
+	 */
+	public: ~ThreadPool()
+	{
+		{
+			std::lock_guard <std::mutex> lock(this->sleepMutex);
+			this->isStopping = true;
+		}
+
+		this->sleepCondition.notify_all();
+
+		for (std::size_t i = 0; i < this->threads.size(); i++)
+		{
+			this->threads[i].join();
+		}
+	}
+
+	public: ThreadPool(ThreadPool const &other) = delete;
+	public: ThreadPool &operator=(ThreadPool const &other) = delete;
+
+	public: unsigned getThreadCount() const
+	{
+		return (unsigned) this->threads.size();
+	}
+
+	/**
+	 * Schedules a task for execution.
+	 */
+	public: void submit(std::function <void()> task)
+	{
+		WorkerId const &workerId = ThreadPool::getCurrentWorkerId();
+		std::size_t index = (workerId.pool == this)
+				? workerId.index
+				: this->nextQueue.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+
+		{
+			std::lock_guard <std::mutex> lock(this->queues[index]->mutex);
+			this->queues[index]->tasks.push_back(std::move(task));
+		}
+
+		{
+			// incremented under the lock, so that a worker going to sleep can't miss it
+			std::lock_guard <std::mutex> lock(this->sleepMutex);
+			this->queuedCount++;
+		}
+
+		this->sleepCondition.notify_one();
+	}
+
+	/**
+	 * Takes one queued task and executes it in the calling thread. This allows
+	 * threads which wait for other tasks (see TaskGroup::wait()) to help
+	 * instead of blocking.
+	 *
+	 * @return false if there were no queued tasks.
+	 */
+	public: bool runPendingTask()
+	{
+		WorkerId const &workerId = ThreadPool::getCurrentWorkerId();
+		std::function <void()> task;
+
+		if (!this->takeTask(workerId.pool == this ? workerId.index : 0, workerId.pool == this, task))
+		{
+			return false;
+		}
+
+		task();
+		return true;
+	}
+
+	private: void work(std::size_t index)
+	{
+		WorkerId &workerId = ThreadPool::getCurrentWorkerId();
+		workerId.pool = this;
+		workerId.index = index;
+
+		while (true)
+		{
+			std::function <void()> task;
+
+			if (this->takeTask(index, true, task))
+			{
+				task();
+				continue;
+			}
+
+			std::unique_lock <std::mutex> lock(this->sleepMutex);
+
+			if (this->queuedCount.load() > 0)
+			{
+				continue;
+			}
+
+			if (this->isStopping)
+			{
+				break;
+			}
+
+			this->sleepCondition.wait(lock);
+		}
+	}
+
+	/**
+	 * Takes a task from the back of the own queue or, if it is empty,
+	 * steals a task from the front of another queue.
+	 *
+	 * @param index Index of the own queue.
+	 * @param hasOwnQueue false if the calling thread is not a worker of this pool.
+	 */
+	private: bool takeTask(std::size_t index, bool hasOwnQueue, std::function <void()> &task)
+	{
+		if (this->queuedCount.load() == 0)
+		{
+			return false;
+		}
+
+		if (hasOwnQueue)
+		{
+			WorkQueue &queue = *this->queues[index];
+			std::lock_guard <std::mutex> lock(queue.mutex);
+
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				this->queuedCount--;
+				return true;
+			}
+		}
+
+		for (std::size_t i = 1; i <= this->queues.size(); i++)
+		{
+			WorkQueue &queue = *this->queues[(index + i) % this->queues.size()];
+			std::lock_guard <std::mutex> lock(queue.mutex);
+
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				this->queuedCount--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	private: static WorkerId &getCurrentWorkerId()
+	{
+		static thread_local WorkerId workerId = {nullptr, 0};
+		return workerId;
+	}
+}
+
+/**
+ * Group of tasks executed by a ThreadPool which can be waited for.
+ * Groups can be nested: a task can create its own group and wait for it
+ * (the waiting thread executes queued tasks in the meantime).
+ *
+ * Example:
+
+	TaskGroup group(pool);
+	group.run(left);
+	group.run(right);
+	group.wait();
+
+ */
+class TaskGroup
+{
+	private: ThreadPool &pool;
+	private: std::atomic <std::size_t> unfinishedCount;
+
+
+	public: TaskGroup(ThreadPool &pool):
+			pool(pool),
+			unfinishedCount(0)
+	{
+		//nothing
+	}
+
+	/**
+	 * Waits for the tasks which are not finished yet.
+	 */
+	public: ~TaskGroup()
+	{
+		this->wait();
+	}
+
+	public: TaskGroup(TaskGroup const &other) = delete;
+	public: TaskGroup &operator=(TaskGroup const &other) = delete;
+
+	public: void run(std::function <void()> task)
+	{
+		this->unfinishedCount++;
+
+		this->pool.submit([this, task]()
+		{
+			task();
+			this->unfinishedCount--;
+		});
+	}
+
+	/**
+	 * Returns after all tasks of the group are finished.
+	 */
+	public: void wait()
+	{
+		while (this->unfinishedCount.load() > 0)
+		{
+			if (!this->pool.runPendingTask())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+}
+
+
+}
+
+
+#endif